@@ -0,0 +1,211 @@
+#pragma once
+#include "riskMetrics.h"
+#include "sharedMarketData.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace service {
+
+    /**
+     * @struct Ticker_Columns
+     * @brief One ticker's columns, as views into storage the Market_Data owns or into a mapped segment.
+     */
+    struct Ticker_Columns {
+        sharedData::Series prices;
+        sharedData::Series volatility;
+        sharedData::Series percentage_changes;
+    };
+
+    /**
+     * @struct Market_Data
+     * @brief The price panel and everything derived from it, computed once when the daemon starts and then only read.
+     *
+     * Backtests read the columns through `columns`. A panel built in process owns its series in the maps, and the
+     * views point into them; a panel built from a shared segment leaves the maps empty and points into the mapping.
+     * The views would dangle in a copy, so the struct cannot be copied.
+     */
+    struct Market_Data {
+        Market_Data() = default;
+        Market_Data(const Market_Data &) = delete;
+        Market_Data &operator=(const Market_Data &) = delete;
+
+        std::map<std::string, std::vector<double>> prices;
+        std::map<std::string, std::vector<double>> true_volatility;    // As true_volatility
+        std::map<std::string, std::vector<double>> percentage_changes; // As calculate_percentage_changes
+        std::map<std::string, Ticker_Columns> columns;                 // Every ticker of the panel
+        std::vector<int64_t> hour_starts; // UTC start of each manager hour; empty if the panel has no timestamps
+        size_t hours = 0;                 // Hours the managers can run over (longest volatility series)
+    };
+
+    /**
+     * @brief Computes the volatility and percentage changes of a price panel.
+     *
+     * @param prices Hourly prices per ticker.
+     * @param bar_starts Optional UTC start of each price bar (see calendar::Session_Calendar::barStart). Manager hour
+     * h is stamped with the bar whose price completes its volatility value, so date windows line up with the prices.
+     * @return The shared market data.
+     */
+    std::shared_ptr<const Market_Data> buildMarketData(const std::map<std::string, std::vector<double>> &prices,
+                                                       const std::vector<int64_t> &bar_starts = {});
+
+    /**
+     * @brief Wraps the columns of a segment written by sharedData::publish, so a worker process skips the fetch and
+     * the volatility computation.
+     *
+     * No column is copied: the result's views point into the mapping, so the memory of a worker does not grow with
+     * the panel. The segment holds no timestamps, so the result has no hour_starts and requests cannot select a date
+     * window.
+     *
+     * @param view An attached segment. It must stay attached while the result is in use.
+     * @return The market data, with the same columns the publisher computed.
+     */
+    std::shared_ptr<const Market_Data> buildMarketData(const sharedData::MarketView &view);
+
+    /**
+     * @brief Outcome of a backtest request.
+     */
+    enum class Status : uint32_t {
+        Ok = 0,
+        BadRequest = 1,      // Malformed message, or capital that is not a positive finite amount
+        UnknownStrategy = 2, // Strategy is not "optimistic", "neutral" or "conservative"
+        UnknownTicker = 3,   // A requested ticker is not in the panel
+        EmptyWindow = 4,     // The date window holds no hours, or needs timestamps the panel does not have
+    };
+
+    /**
+     * @brief Short name of a status, for messages.
+     */
+    const char *statusName(Status status);
+
+    /**
+     * @struct Backtest_Request
+     * @brief One backtest: a strategy and starting capital over a date window and a set of tickers.
+     */
+    struct Backtest_Request {
+        std::string strategy = "neutral";
+        double capital = 20000.0;         // Split equally across the tickers, as create_portfolio does
+        int64_t begin_time = 0;           // First hour at or after this UTC time; 0 starts at the first hour
+        int64_t end_time = 0;             // Hours before this UTC time; 0 runs to the last hour
+        std::vector<std::string> tickers; // Empty uses every ticker of the panel
+    };
+
+    /**
+     * @struct Backtest_Response
+     * @brief Result of a backtest request.
+     */
+    struct Backtest_Response {
+        Status status = Status::Ok;
+        size_t begin_hour = 0;                         // Manager hours that were run, [begin_hour, end_hour)
+        size_t end_hour = 0;
+        double initial_value = 0.0;                    // Portfolio value before the first hour
+        double final_value = 0.0;                      // Portfolio value after the last hour
+        metrics::Metrics_Summary metrics;              // Risk and performance of the run
+        uint64_t compute_ns = 0;                       // Time the daemon spent running the managers
+        std::map<std::string, double> final_portfolio; // Holdings after the last hour
+    };
+
+    /**
+     * @brief Runs one backtest against the shared data with stock_manager and portfolio_manager.
+     *
+     * Only reads the market data, so any number of calls can run at the same time. With every ticker and the whole
+     * window the result is the same as pipeline::StageGraph::run.
+     */
+    Backtest_Response runBacktest(const Market_Data &data, const Backtest_Request &request);
+
+    /**
+     * @struct Daemon_Config
+     * @brief Settings for the backtest daemon.
+     */
+    struct Daemon_Config {
+        std::string socket_path = "/tmp/volatility_daemon.sock"; // Unix domain socket to listen on
+        size_t workers = 0;                                      // Connections served at once; 0 = hardware threads
+        int io_timeout_ms = 2000;                                // Longest stall inside a message; 0 = no limit
+        int idle_timeout_ms = 30000;                             // Longest wait for the next request; 0 = no limit
+    };
+
+    /**
+     * @class Backtest_Daemon
+     * @brief Serves backtest requests over a local Unix domain socket from data kept in memory.
+     *
+     * Every worker thread accepts connections on the same listening socket and answers the requests of its connection
+     * one after the other, so up to `workers` clients are served at once against the same immutable Market_Data.
+     * A connection may send any number of requests. One that sends nothing for Daemon_Config::idle_timeout_ms is
+     * closed, so silent clients cannot keep every worker busy.
+     *
+     * Wire format, native byte order (client and daemon run on the same machine):
+     *  - request: a fixed 40-byte header (magic, strategy code, capital, begin and end time, ticker count), then each
+     *    ticker as a uint16 length and its bytes.
+     *  - response: a fixed 112-byte header (status, hours, values, metrics, compute time, holding count), then each
+     *    holding as a uint16 length, the ticker bytes and a double.
+     */
+    class Backtest_Daemon {
+      public:
+        explicit Backtest_Daemon(std::shared_ptr<const Market_Data> data);
+        ~Backtest_Daemon();
+
+        Backtest_Daemon(const Backtest_Daemon &) = delete;
+        Backtest_Daemon &operator=(const Backtest_Daemon &) = delete;
+
+        /**
+         * @brief Binds the socket and starts the workers. Returns once the daemon accepts connections.
+         */
+        bool start(const Daemon_Config &config = Daemon_Config());
+
+        /**
+         * @brief Stops accepting, waits for the requests in flight and removes the socket file. A client stalled in
+         * the middle of a message holds its worker for at most Daemon_Config::io_timeout_ms.
+         */
+        void stop();
+
+        /**
+         * @brief Requests answered so far.
+         */
+        size_t served() const { return served_.load(std::memory_order_relaxed); }
+
+      private:
+        void workerLoop();
+        void serveConnection(int client);
+
+        std::shared_ptr<const Market_Data> data_;
+        std::string socket_path_;
+        int listener_ = -1;
+        int io_timeout_ms_ = 0;
+        int idle_timeout_ms_ = 0;
+        std::atomic<bool> stop_{ false };
+        std::atomic<size_t> served_{ 0 };
+        std::vector<std::thread> workers_;
+    };
+
+    /**
+     * @class Backtest_Client
+     * @brief Local client for a Backtest_Daemon. One connection, reused for every request.
+     */
+    class Backtest_Client {
+      public:
+        ~Backtest_Client();
+
+        /**
+         * @brief Connects to the daemon, retrying for a couple of seconds while it starts.
+         */
+        bool connect(const std::string &socket_path);
+
+        /**
+         * @brief Sends a request and waits for its response.
+         *
+         * @return False if the connection failed; a request the daemon rejected still returns true with its status.
+         */
+        bool run(const Backtest_Request &request, Backtest_Response &response);
+
+        void close();
+
+      private:
+        int fd_ = -1;
+    };
+
+} // namespace service
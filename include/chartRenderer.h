@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace chart {
+
+    /**
+     * @brief Downsamples a series with Largest-Triangle-Three-Buckets.
+     *
+     * Keeps the first and last points and, for every bucket in between, the point that forms the largest triangle
+     * with the previously kept point and the average of the next bucket. This preserves peaks and troughs far better
+     * than striding. Runs in O(n).
+     *
+     * @param x X values, sorted ascending.
+     * @param y Y values, same length as x.
+     * @param threshold Number of points to keep. Values below 3 or at least x.size() keep every point.
+     * @return Indices of the kept points, ascending.
+     */
+    std::vector<size_t> lttb(const std::vector<double> &x, const std::vector<double> &y, size_t threshold);
+
+    /**
+     * @struct Chart_Series
+     * @brief One line on a chart.
+     */
+    struct Chart_Series {
+        std::string name;      // Legend label
+        std::vector<double> x; // X values, ascending
+        std::vector<double> y; // Y values
+    };
+
+    /**
+     * @struct Chart_Options
+     * @brief Size and labels of a chart.
+     */
+    struct Chart_Options {
+        size_t width = 1200;
+        size_t height = 700;
+        std::string title;
+        std::string x_label;
+        std::string y_label;
+    };
+
+    /**
+     * @brief Writes the series as an SVG line chart with axes, labels and a legend.
+     *
+     * Every series is downsampled with LTTB to the plot's pixel width before drawing, so the file size and render
+     * time do not depend on the history length.
+     *
+     * @return True if the file was written.
+     */
+    bool renderSvg(const std::string &filename, const std::vector<Chart_Series> &series, const Chart_Options &options);
+
+    /**
+     * @brief Writes the series as a PNG line chart.
+     *
+     * Same layout, labels and downsampling as renderSvg, rasterized in memory and deflate-compressed without
+     * external libraries. Text uses a built-in 5x7 bitmap font, with lowercase drawn as capitals.
+     *
+     * @return True if the file was written.
+     */
+    bool renderPng(const std::string &filename, const std::vector<Chart_Series> &series, const Chart_Options &options);
+
+} // namespace chart
@@ -0,0 +1,143 @@
+#pragma once
+#include "spscQueue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace journal {
+
+    /**
+     * @brief Kinds of journal events.
+     */
+    enum class Event_Type : uint8_t {
+        PriceChange = 1,       // value: percentage change of the ticker this hour
+        Buy = 2,               // Ticker is on the stock_manager buying list
+        Sell = 3,              // Ticker is on the stock_manager selling list
+        ReallocationFunds = 4, // value: funds freed this hour (no ticker)
+        Allocation = 5,        // value: money allocated to the ticker this hour
+        Holding = 6,           // value: ticker holding at the end of the hour
+    };
+
+    constexpr uint16_t kNoTicker = 0xFFFF;
+
+    /**
+     * @struct Event
+     * @brief One fixed-size journal record, stored as is in the file.
+     */
+    struct Event {
+        uint32_t hour = 0;
+        uint16_t ticker = kNoTicker; // Index into the journal's ticker table
+        Event_Type type = Event_Type::PriceChange;
+        uint8_t reserved = 0;
+        double value = 0.0;
+    };
+    static_assert(sizeof(Event) == 16, "journal events are stored as 16-byte records");
+
+    /**
+     * @class Journal_Writer
+     * @brief Append-only binary event journal written by a background thread.
+     *
+     * The file is a header (magic "VOLJRNL1" and the ticker table) followed by raw 16-byte Event records. log() only
+     * copies the record into a lock-free single-producer ring buffer, so the hot path costs a few nanoseconds and never
+     * touches a stream. The background thread drains the buffer into a large file buffer. If the ring fills up, log()
+     * waits for room rather than dropping an event.
+     *
+     * Only one thread may call log().
+     */
+    class Journal_Writer {
+      public:
+        explicit Journal_Writer(size_t capacity = 1 << 16);
+        ~Journal_Writer();
+
+        Journal_Writer(const Journal_Writer &) = delete;
+        Journal_Writer &operator=(const Journal_Writer &) = delete;
+
+        /**
+         * @brief Creates (or truncates) the journal and starts the writer thread.
+         *
+         * @param filename The journal file.
+         * @param tickers Ticker table; events refer to tickers by their index in it.
+         * @return True if the file could be created.
+         */
+        bool open(const std::string &filename, const std::vector<std::string> &tickers);
+
+        /**
+         * @brief Queues one event. Producer thread only.
+         */
+        void log(uint32_t hour, Event_Type type, uint16_t ticker = kNoTicker, double value = 0.0) {
+            Event event;
+            event.hour = hour;
+            event.ticker = ticker;
+            event.type = type;
+            event.value = value;
+            queue_.push(event);
+        }
+
+        /**
+         * @brief Writes every queued event, stops the writer thread and closes the file.
+         *
+         * @return True if every event reached the file.
+         */
+        bool close();
+
+        /**
+         * @brief Events written to the file so far.
+         */
+        uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+      private:
+        void writerLoop();
+
+        Spsc_Queue<Event> queue_;
+        std::ofstream file_;
+        std::vector<char> file_buffer_;
+        std::thread writer_;
+        std::atomic<bool> stop_{ false };
+        std::atomic<uint64_t> written_{ 0 };
+        std::string filename_;
+        bool failed_ = false;
+    };
+
+    /**
+     * @class Journal_Reader
+     * @brief Reads a journal written by Journal_Writer, one event at a time.
+     */
+    class Journal_Reader {
+      public:
+        /**
+         * @brief Opens a journal and reads its ticker table.
+         *
+         * @return True if the file exists and has the expected format.
+         */
+        bool open(const std::string &filename);
+
+        const std::vector<std::string> &tickers() const { return tickers_; }
+
+        /**
+         * @brief Name of a ticker index, or an empty string for kNoTicker or an unknown index.
+         */
+        const std::string &tickerName(uint16_t ticker) const;
+
+        /**
+         * @brief Reads the next event.
+         *
+         * @return False at the end of the journal.
+         */
+        bool next(Event &event);
+
+      private:
+        std::ifstream file_;
+        std::vector<std::string> tickers_;
+        std::string none_;
+    };
+
+    /**
+     * @brief Short name of an event type, as used in the CSV output of the decoder.
+     */
+    const char *typeName(Event_Type type);
+
+} // namespace journal
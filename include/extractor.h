@@ -7,7 +7,7 @@
 #include <vector>
 // #include <curl/curl.h>
 // #include <nlohmann/json.hpp>
-#include <ctime>
+#include <cstdint>
 #include <iomanip> // For std::setprecision and std::fixed
 
 // using json = nlohmann::json;
@@ -29,10 +29,11 @@ namespace extractor {
     /**
      * @brief Converts a date string to a Unix timestamp.
      *
-     * The function converts a date in the format "YYYY-MM-DD" into a Unix timestamp.
+     * The date is read as ISO-8601 (see calendar::parseIso8601); a plain "YYYY-MM-DD" is midnight UTC, whatever the
+     * machine's locale and time zone.
      *
      * @param date The date string to convert.
-     * @return The Unix timestamp representation of the date.
+     * @return The Unix timestamp representation of the date, or -1 if it does not parse.
      */
     long convertToTimestamp(const std::string &date);
 
@@ -47,8 +48,44 @@ namespace extractor {
      * @param end_date The end date for data retrieval in "YYYY-MM-DD" format.
      * @param ticker_to_prices A reference to a map to store the fetched prices.
      */
-    void get_stock_data(const std::string &ticker, const std::string &startDate, const std::string &endDate,
-                        std::map<std::string, std::vector<double>> &tickerToPrices);
+    void getStockData(const std::string &ticker, const std::string &startDate, const std::string &endDate,
+                      std::map<std::string, std::vector<double>> &tickerToPrices);
+
+    /**
+     * @brief Downloads the raw Yahoo Finance chart response for a ticker.
+     *
+     * @param ticker The stock ticker symbol (e.g., "AAPL").
+     * @param start_date The start date for data retrieval in "YYYY-MM-DD" format.
+     * @param end_date The end date for data retrieval in "YYYY-MM-DD" format.
+     * @param response_data A reference to a string that receives the response body.
+     * @return True if the request succeeded.
+     */
+    bool fetchStockJson(const std::string &ticker, const std::string &startDate, const std::string &endDate,
+                        std::string &response_data);
+
+    /**
+     * @brief Extracts the hourly close prices from a Yahoo Finance chart response.
+     *
+     * @param ticker The stock ticker symbol, used in error messages.
+     * @param response_data The raw response body.
+     * @param prices A reference to a vector the non-null close prices are appended to.
+     * @return True if the response contained price data.
+     */
+    bool parseStockJson(const std::string &ticker, const std::string &response_data, std::vector<double> &prices);
+
+    /**
+     * @brief Extracts the hourly close prices and their timestamps from a Yahoo Finance chart response.
+     *
+     * The timestamps can be placed on real session hours with calendar::Session_Calendar::align.
+     *
+     * @param ticker The stock ticker symbol, used in error messages.
+     * @param response_data The raw response body.
+     * @param prices A reference to a vector the non-null close prices are appended to.
+     * @param timestamps A reference to a vector the epoch seconds of those prices are appended to.
+     * @return True if the response contained price data.
+     */
+    bool parseStockJson(const std::string &ticker, const std::string &response_data, std::vector<double> &prices,
+                        std::vector<int64_t> &timestamps);
 
     /**
      * @brief Saves stock data to a CSV file.
@@ -61,6 +98,17 @@ namespace extractor {
      */
     void saveToCsv(const std::string &filename, const std::map<std::string, std::vector<double>> &tickerToPrices);
 
+    /**
+     * @brief Loads stock data from a CSV file written by saveToCsv.
+     *
+     * Rows are "ticker,price" and are appended to each ticker's series in file order.
+     *
+     * @param filename The name of the CSV file to read.
+     * @param ticker_to_prices A reference to a map to store the loaded prices.
+     * @return True if the file could be opened and parsed.
+     */
+    bool loadFromCsv(const std::string &filename, std::map<std::string, std::vector<double>> &tickerToPrices);
+
     // Function to print a std::map (used for debugging purposes)
     void printMap(const std::map<std::string, double> &myMap, const std::string &title);
 
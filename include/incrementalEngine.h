@@ -0,0 +1,100 @@
+#pragma once
+#include "volatilityParse.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace incremental {
+
+    /**
+     * @struct Ticker_State
+     * @brief Everything the engine remembers about one ticker between updates.
+     */
+    struct Ticker_State {
+        volParsing::Volatility_State volatility; // EWMA state, including the last price
+        double volatility_sum = 0.0;             // Running sum of volatility values, for the allocation weights
+        size_t volatility_count = 0;             // Number of volatility values summed
+    };
+
+    /**
+     * @brief Engine_State::last_timestamp before any timestamped batch.
+     */
+    constexpr int64_t kNoTimestamp = std::numeric_limits<int64_t>::min();
+
+    /**
+     * @struct Engine_State
+     * @brief Compact state of a run: enough to continue it without the price history.
+     */
+    struct Engine_State {
+        std::string strategy;                        // "optimistic", "neutral" or "conservative"
+        size_t hours_processed = 0;                  // Hours consumed so far
+        int64_t last_timestamp = kNoTimestamp;       // Epoch seconds of the last timestamped bar processed
+        std::map<std::string, Ticker_State> tickers; // Per-ticker volatility state
+        std::map<std::string, double> portfolio;     // Current holdings
+    };
+
+    /**
+     * @brief Starts a new run.
+     *
+     * @param strategy The investment strategy.
+     * @param my_portfolio Starting holdings.
+     */
+    Engine_State start(const std::string &strategy, const std::map<std::string, double> &my_portfolio);
+
+    /**
+     * @brief Processes one hour: the price of every ticker that traded in it.
+     *
+     * In order, for each ticker: apply the price change to its holding (as portfolio_manager does), feed the price
+     * into its EWMA volatility and, once a volatility value exists, run the stock_manager decision. The funds freed by
+     * sells are then reallocated across the hour's buys with the portfolio_manager weights, using each stock's running
+     * average volatility.
+     *
+     * @param state The run to advance.
+     * @param hour_prices Map of ticker to its price for this hour.
+     */
+    void advanceHour(Engine_State &state, const std::map<std::string, double> &hour_prices);
+
+    /**
+     * @brief Processes a batch of new bars in O(new bars).
+     *
+     * Bar i of every series belongs to the same hour. Batches must be split on hour boundaries, so that resuming from
+     * a checkpoint gives exactly the same result as processing the whole history in one go.
+     *
+     * @param state The run to advance.
+     * @param new_bars Map of ticker to the prices appended since the last update.
+     */
+    void advance(Engine_State &state, const std::map<std::string, std::vector<double>> &new_bars);
+
+    /**
+     * @brief Processes a batch of new bars, given the epoch seconds of each of its hours.
+     *
+     * The batch is rejected, leaving the state untouched, unless bar_times has one entry per hour and is strictly
+     * increasing from after state.last_timestamp. This catches a batch fed twice or out of order after a resume.
+     *
+     * @param state The run to advance.
+     * @param new_bars Map of ticker to the prices appended since the last update.
+     * @param bar_times Epoch seconds of each hour of the batch.
+     * @return True if the batch was processed; state.last_timestamp is then its last time.
+     */
+    bool advance(Engine_State &state, const std::map<std::string, std::vector<double>> &new_bars,
+                 const std::vector<int64_t> &bar_times);
+
+    /**
+     * @brief Writes the state to a binary checkpoint file. Doubles are stored bit for bit.
+     *
+     * @return True if the file was written.
+     */
+    bool saveCheckpoint(const std::string &filename, const Engine_State &state);
+
+    /**
+     * @brief Reads a checkpoint written by saveCheckpoint.
+     *
+     * @return True if the file exists and has the expected format. Version 1 files, written before the timestamp was
+     * stored, load with last_timestamp set to kNoTimestamp.
+     */
+    bool loadCheckpoint(const std::string &filename, Engine_State &state);
+
+} // namespace incremental
@@ -0,0 +1,62 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ingest {
+
+    /**
+     * @brief Downloads the raw response for one ticker. Returns false if the ticker should be skipped.
+     */
+    using Fetch_Function = std::function<bool(const std::string &ticker, std::string &payload)>;
+
+    /**
+     * @brief Turns a raw response into a price series. Returns false if the ticker should be skipped.
+     */
+    using Parse_Function =
+        std::function<bool(const std::string &ticker, const std::string &payload, std::vector<double> &prices)>;
+
+    /**
+     * @struct Ingest_Result
+     * @brief Everything the pipeline produced, in the same shapes main() used to build stage by stage.
+     */
+    struct Ingest_Result {
+        std::map<std::string, std::vector<double>> ticker_to_prices;
+        std::map<std::string, double> initial_volatility;                   // As tickerToVolHourly
+        std::map<std::string, std::vector<double>> true_volatility;         // As true_volatility
+        std::map<std::string, std::vector<double>> percentage_changes;      // As calculate_percentage_changes
+        double fetch_seconds = 0.0;   // Busy time of the fetch stage
+        double parse_seconds = 0.0;   // Busy time of the parse stage
+        double compute_seconds = 0.0; // Busy time of the volatility stage
+        double wall_seconds = 0.0;    // End-to-end time
+    };
+
+    /**
+     * @brief Fetches, parses and computes volatility for every ticker as a three-stage pipeline.
+     *
+     * Each stage runs on its own thread and hands work to the next through a bounded lock-free single-producer /
+     * single-consumer queue, so a ticker's volatility is computed as soon as its bars are parsed while the next
+     * ticker is still downloading. Wall time approaches the slowest stage instead of the sum of all stages.
+     *
+     * @param tickers Tickers to load, in fetch order.
+     * @param fetch Download function for one ticker.
+     * @param parse Parse function for one ticker.
+     * @param queue_capacity Maximum number of items in flight between two stages.
+     * @return Prices, volatility, percentage changes and per-stage timings.
+     * @throws An exception thrown by fetch, parse or the volatility stage, rethrown once both stage threads are joined.
+     */
+    Ingest_Result run(const std::vector<std::string> &tickers, const Fetch_Function &fetch,
+                      const Parse_Function &parse, size_t queue_capacity = 8);
+
+    /**
+     * @brief Runs the pipeline against Yahoo Finance with extractor::fetchStockJson and extractor::parseStockJson.
+     *
+     * @param tickers Tickers to load.
+     * @param start_date The start date for data retrieval in "YYYY-MM-DD" format.
+     * @param end_date The end date for data retrieval in "YYYY-MM-DD" format.
+     */
+    Ingest_Result run(const std::vector<std::string> &tickers, const std::string &startDate,
+                      const std::string &endDate);
+
+} // namespace ingest
@@ -0,0 +1,107 @@
+#pragma once
+#include "incrementalEngine.h"
+#include "threadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace accounts {
+
+    /**
+     * @class Multi_Account_Engine
+     * @brief Runs many client portfolios bar by bar against one shared market state.
+     *
+     * Each bar is handled in two steps. The market step updates every ticker's EWMA volatility and price change once.
+     * It then derives, once per strategy, the decisions (buy, or sell a fixed fraction) and the allocation shares of
+     * the bought stocks. The account step applies these to every account. Holdings are stored as one dense
+     * accounts × tickers matrix per strategy. For each account the step multiplies in the price changes, takes the
+     * sell fractions, sums the freed funds and spreads them by the shared allocation shares. That is O(tickers) per
+     * account per bar, with no map lookups and no volatility work.
+     *
+     * Each account follows exactly the rules of incremental::advanceHour, so its holdings are bit-identical to running
+     * the incremental engine alone with the same strategy. This relies on decide_stock only buying, or selling a
+     * fraction of the invested money that does not depend on the amount.
+     */
+    class Multi_Account_Engine {
+      public:
+        /**
+         * @param tickers The ticker universe. Every account holds a (possibly zero) position in each ticker.
+         */
+        explicit Multi_Account_Engine(std::vector<std::string> tickers);
+
+        /**
+         * @brief Adds an account.
+         *
+         * @param strategy "optimistic", "neutral" or "conservative".
+         * @param holdings Starting holdings; tickers outside the universe are ignored.
+         * @return The account id, used by the accessors.
+         */
+        size_t addAccount(const std::string &strategy, const std::map<std::string, double> &holdings);
+
+        /**
+         * @brief Processes one bar for every account.
+         *
+         * @param prices One price per ticker of the universe, in tickers() order; NaN for a ticker with no bar.
+         * @param pool Optional thread pool; accounts are then split into shards across its threads. Results do not
+         * depend on it.
+         */
+        void advanceHour(const std::vector<double> &prices, Thread_Pool *pool = nullptr);
+
+        /**
+         * @brief Processes a batch of new bars, as incremental::advance does. Bar i of every series is the same hour.
+         */
+        void advance(const std::map<std::string, std::vector<double>> &new_bars, Thread_Pool *pool = nullptr);
+
+        const std::vector<std::string> &tickers() const { return tickers_; }
+        size_t accounts() const { return slots_.size(); }
+        size_t hoursProcessed() const { return hours_processed_; }
+        const std::string &strategy(size_t account) const { return groups_[slots_[account].group].strategy; }
+
+        /**
+         * @brief Holding of one account in one ticker (index into tickers()).
+         */
+        double holding(size_t account, size_t ticker) const;
+
+        /**
+         * @brief Holdings of one account as a ticker map, like incremental::Engine_State::portfolio.
+         */
+        std::map<std::string, double> portfolio(size_t account) const;
+
+        /**
+         * @brief Total holdings of one account.
+         */
+        double accountValue(size_t account) const;
+
+      private:
+        // Accounts that share a strategy, and therefore share every decision and allocation share
+        struct Strategy_Group {
+            std::string strategy;
+            size_t rows = 0;
+            std::vector<double> holdings;      // rows × tickers, row-major
+            std::vector<uint8_t> decision;     // Per ticker for the current bar: 0 none, 1 buy, 2 sell
+            std::vector<double> sell_fraction; // Per ticker for the current bar
+            std::vector<size_t> buys;          // Bought tickers of the current bar, in ticker order
+            std::vector<double> shares;        // Allocation share of each bought ticker
+        };
+
+        struct Slot {
+            size_t group;
+            size_t row;
+        };
+
+        void applyBar(Strategy_Group &group, size_t begin_row, size_t end_row) const;
+
+        std::vector<std::string> tickers_;
+        std::vector<incremental::Ticker_State> market_; // Shared EWMA state per ticker
+        std::vector<uint8_t> has_bar_;                  // Per ticker for the current bar
+        std::vector<uint8_t> has_change_;
+        std::vector<uint8_t> has_volatility_;
+        std::vector<double> change_factor_;
+        std::vector<Strategy_Group> groups_;
+        std::vector<Slot> slots_;
+        size_t hours_processed_ = 0;
+    };
+
+} // namespace accounts
@@ -0,0 +1,136 @@
+#pragma once
+#include "incrementalEngine.h"
+#include "riskMetrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace outOfCore {
+
+    /**
+     * @class Bar_Store_Writer
+     * @brief Writes a file-backed bar store one hour at a time.
+     *
+     * The file is a small header (magic "VOLBARS1", ticker count, hour count), the ticker names, then an hour-major
+     * matrix of doubles: one row of ticker_count prices per hour, NaN where a ticker has no bar. A time chunk is
+     * therefore one contiguous read, and writing never needs more than one row in memory.
+     */
+    class Bar_Store_Writer {
+      public:
+        ~Bar_Store_Writer();
+
+        /**
+         * @brief Creates (or truncates) the store. Tickers are stored in the given order.
+         *
+         * @return True if the file could be created.
+         */
+        bool open(const std::string &filename, const std::vector<std::string> &tickers);
+
+        /**
+         * @brief Appends one hour. prices[i] belongs to tickers[i]; pass NaN for a missing bar.
+         *
+         * @return True if the row was written.
+         */
+        bool appendHour(const std::vector<double> &prices);
+
+        /**
+         * @brief Writes the final hour count into the header and closes the file.
+         *
+         * @return True if the store is complete.
+         */
+        bool close();
+
+      private:
+        std::ofstream file_;
+        std::string filename_;
+        size_t tickers_ = 0;
+        uint64_t hours_ = 0;
+    };
+
+    /**
+     * @class Bar_Store_Reader
+     * @brief Reads a bar store in bounded chunks of hours.
+     */
+    class Bar_Store_Reader {
+      public:
+        /**
+         * @brief Opens a store written by Bar_Store_Writer and reads its header.
+         *
+         * @return True if the file exists and has the expected format.
+         */
+        bool open(const std::string &filename);
+
+        const std::vector<std::string> &tickers() const { return tickers_; }
+        size_t hours() const { return hours_; }
+
+        /**
+         * @brief Reads the next chunk of at most max_hours hours into buffer (hour-major, tickers().size() per row).
+         *
+         * @return The number of hours read; 0 at the end of the store or on a read error.
+         */
+        size_t readChunk(size_t max_hours, std::vector<double> &buffer);
+
+        /**
+         * @brief True once a read came up short: the file holds fewer hours than its header promises.
+         */
+        bool truncated() const { return truncated_; }
+
+      private:
+        std::ifstream file_;
+        std::string filename_;
+        std::vector<std::string> tickers_;
+        size_t hours_ = 0;
+        size_t next_hour_ = 0;
+        bool truncated_ = false;
+    };
+
+    /**
+     * @brief Writes a whole in-memory price map as a bar store. Shorter series are padded with NaN.
+     *
+     * @return True if the store was written.
+     */
+    bool writeStore(const std::string &filename, const std::map<std::string, std::vector<double>> &ticker_to_prices);
+
+    /**
+     * @struct Chunked_Result
+     * @brief Outcome of a chunked run.
+     */
+    struct Chunked_Result {
+        incremental::Engine_State state;  // Final engine state; can be checkpointed or advanced further
+        metrics::Metrics_Summary metrics; // Risk and performance over the processed hours
+        size_t chunks = 0;                // Chunks read
+        size_t buffer_bytes = 0;          // Size of the chunk buffer, which bounds the price data held in memory
+        bool truncated = false;           // The store ended early; state and metrics cover only the hours read
+    };
+
+    /**
+     * @brief Metrics settings of a chunked run. The VaR and CVaR keep every return, so they are off to keep memory
+     * bounded by the chunk; pass a config with tail_metrics set to get them.
+     */
+    inline metrics::Metrics_Config chunkedMetricsConfig() {
+        metrics::Metrics_Config config;
+        config.tail_metrics = false;
+        return config;
+    }
+
+    /**
+     * @brief Runs the incremental engine over a bar store chunk by chunk.
+     *
+     * Only one chunk of prices is in memory at a time. Everything that must survive a chunk boundary (EWMA variance,
+     * last price, running average volatility and holdings) lives in the engine state, so the result is exactly that of
+     * incremental::advance over the whole history, whatever the chunk size.
+     *
+     * @param filename The bar store.
+     * @param state The run to continue, e.g. from incremental::start or a checkpoint.
+     * @param chunk_hours Hours per chunk.
+     * @param metrics_config Settings of the metrics updated after every hour.
+     * @return The final state and metrics. chunks is 0 if the store could not be opened; truncated is set if the
+     * file ended before the last hour.
+     */
+    Chunked_Result processStore(const std::string &filename, incremental::Engine_State state, size_t chunk_hours,
+                                const metrics::Metrics_Config &metrics_config = chunkedMetricsConfig());
+
+} // namespace outOfCore
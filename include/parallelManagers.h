@@ -0,0 +1,60 @@
+#pragma once
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include "threadPool.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace parallel {
+
+    /**
+     * @brief stock_manager with the tickers sharded across a thread pool.
+     *
+     * A ticker's decisions only depend on its own volatility and invested money, so each shard runs every hour for
+     * its own range of tickers and writes its decisions into a shared hour-major table. A second pass, sharded by
+     * hour, reduces each hour's row in ticker order into the buying and selling lists and reallocation funds. The
+     * additions happen in the same order as in stock_manager, so the result is bit-identical to the serial path for
+     * any number of threads.
+     *
+     * @param pool Thread pool to run on.
+     * @param stocks A map of stock tickers to their volatility vectors over time.
+     * @param my_portfolio A reference to the current portfolio, mapping stock tickers to invested amounts.
+     * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+     * @param threshold_scales A map of stock tickers to per-hour threshold multipliers, as for stock_manager.
+     * @return The same result as stock_manager.
+     */
+    Stock_Manager_Result stockManager(Thread_Pool &pool, const std::map<std::string, std::vector<double>> &stocks,
+                                      std::map<std::string, double> &my_portfolio, const std::string &strategy,
+                                      const std::map<std::string, std::vector<double>> &threshold_scales = {});
+
+    /**
+     * @brief portfolio_manager with the tickers sharded across a thread pool.
+     *
+     * Each hour's allocations only depend on the buying list, the reallocation funds and the average volatility, and
+     * not on the holdings. So they are computed first, in parallel by hour; only the funds carried over for lack of a
+     * full ticket (Selection_Config::min_ticket) are settled in a short serial pass over the hours. After that every
+     * ticker follows its own timeline: apply the market change, then add its allocations. Shards of tickers run those
+     * timelines with no cross-ticker synchronization. The per-hour snapshots, portfolio totals and metrics are then rebuilt in ticker
+     * order. The result is bit-identical to portfolio_manager for any number of threads.
+     *
+     * @param pool Thread pool to run on.
+     * @param buying_stocks A vector of stocks to buy at each hour.
+     * @param reallocation_funds A vector of funds available for reallocation at each hour.
+     * @param my_portfolio A reference to the current portfolio, mapping stock tickers to their values.
+     * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+     * @param stocks A map of stock tickers to their volatility data over time.
+     * @param ticker_to_percentage_changes A map of stock tickers to their percentage changes over time.
+     * @param metrics_config Settings of the risk and performance metrics.
+     * @param selection Candidate limit and minimum ticket size, as for portfolio_manager.
+     * @return The same result as portfolio_manager.
+     */
+    Portfolio_Manager_Result
+    portfolioManager(Thread_Pool &pool, const std::vector<std::vector<std::string>> &buying_stocks,
+                     const std::vector<double> &reallocation_funds, std::map<std::string, double> &my_portfolio,
+                     const std::string &strategy, const std::map<std::string, std::vector<double>> &stocks,
+                     const std::map<std::string, std::vector<double>> &ticker_to_percentage_changes,
+                     const metrics::Metrics_Config &metrics_config = metrics::Metrics_Config(),
+                     const Selection_Config &selection = Selection_Config());
+
+} // namespace parallel
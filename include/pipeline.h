@@ -0,0 +1,202 @@
+#pragma once
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pipeline {
+
+    /**
+     * @brief Hashes a block of bytes with 64-bit FNV-1a.
+     *
+     * @param data Pointer to the bytes to hash.
+     * @param size Number of bytes.
+     * @param seed Hash to continue from, so several inputs can be chained into one key.
+     * @return The updated hash.
+     */
+    uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 1469598103934665603ULL);
+
+    /**
+     * @brief Hashes a string (length and contents) into a running key.
+     */
+    uint64_t hashString(const std::string &value, uint64_t seed);
+
+    /**
+     * @brief Hashes a ticker-to-series map (tickers, lengths and every value) into a running key.
+     */
+    uint64_t hashSeries(const std::map<std::string, std::vector<double>> &series, uint64_t seed);
+
+    /**
+     * @brief Hashes a portfolio (tickers and invested amounts) into a running key.
+     */
+    uint64_t hashPortfolio(const std::map<std::string, double> &portfolio, uint64_t seed);
+
+    /**
+     * @brief Copies hours [begin, end) of one series, for a manager run over that window.
+     *
+     * @param values The series.
+     * @param size Its length.
+     * @param hold_last What a series that ends before `begin` contributes: its last value if true, which is the
+     * fallback stock_manager uses for volatility past the end; nothing if false, since a full run applies no percentage
+     * change past the end of its series.
+     * @return The window; empty for an empty series.
+     */
+    std::vector<double> sliceSeries(const double *values, size_t size, size_t begin, size_t end, bool hold_last);
+
+    /**
+     * @struct Stage_Stats
+     * @brief Cache bookkeeping for one stage of the graph.
+     */
+    struct Stage_Stats {
+        std::string name;      // Stage name
+        uint64_t key = 0;      // Content hash of the inputs the cached output was built from
+        size_t hits = 0;       // Times the cached output was reused
+        size_t misses = 0;     // Times the stage had to be recomputed
+        size_t evictions = 0;  // Cached outputs dropped to stay within the cache capacity
+    };
+
+    /**
+     * @struct Run_Result
+     * @brief Output of the manager stages for one strategy over one window of hours.
+     */
+    struct Run_Result {
+        Stock_Manager_Result stock_result;
+        Portfolio_Manager_Result portfolio_result;
+        std::map<std::string, double> final_portfolio; // Holdings after the last hour of the window
+        double initial_value = 0.0;                    // Portfolio value before the first hour
+        double final_value = 0.0;                      // Portfolio value after the last hour
+    };
+
+    /**
+     * @class StageGraph
+     * @brief The volatility pipeline expressed as a DAG of memoized stages.
+     *
+     * Stages and their inputs:
+     *  - prices: the raw price panel (source).
+     *  - initial_volatility: tickerToVolHourly(prices).
+     *  - true_volatility: true_volatility(prices, initial_volatility).
+     *  - percentage_changes: calculate_percentage_changes(prices).
+     *  - managers: stock_manager + portfolio_manager(true_volatility, percentage_changes, strategy, portfolio, window).
+     *
+     * Every stage output is stored together with the content hash of its inputs (its upstream keys plus its own
+     * parameters). A stage is only recomputed when that key changes, so changing a strategy threshold or the
+     * starting capital reruns the managers without refetching or recomputing any volatility.
+     *
+     * Manager results are kept for at most max_runs distinct keys; beyond that the least recently used one is dropped.
+     */
+    class StageGraph {
+      public:
+        static constexpr size_t kDefaultMaxRuns = 256;
+
+        /**
+         * @param max_runs Manager results kept in the cache (at least one).
+         */
+        explicit StageGraph(size_t max_runs = kDefaultMaxRuns);
+
+        /**
+         * @brief Replaces the price panel. Downstream stages are invalidated only if the contents changed.
+         */
+        void setPrices(const std::map<std::string, std::vector<double>> &prices);
+
+        const std::map<std::string, std::vector<double>> &prices() const { return prices_; }
+
+        const std::map<std::string, double> &initialVolatility();
+        const std::map<std::string, std::vector<double>> &trueVolatility();
+        const std::map<std::string, std::vector<double>> &percentageChanges();
+
+        /**
+         * @brief Number of hours the manager stages can be run over (length of the longest volatility series).
+         */
+        size_t hours();
+
+        /**
+         * @brief Runs both managers over hours [begin, end) with the given strategy and starting portfolio.
+         *
+         * Results are memoized on (volatility key, percentage change key, strategy, portfolio, begin, end). The
+         * returned reference stays valid until the next call to run, which may evict it.
+         */
+        const Run_Result &run(const std::string &strategy, const std::map<std::string, double> &portfolio,
+                              size_t begin, size_t end);
+
+        /**
+         * @brief Runs both managers over the full history.
+         */
+        const Run_Result &run(const std::string &strategy, const std::map<std::string, double> &portfolio);
+
+        /**
+         * @brief Cache statistics for every stage, in topological order.
+         */
+        std::vector<Stage_Stats> stats() const;
+
+        /**
+         * @brief Drops every cached manager result (volatility stages are kept).
+         */
+        void clearRuns();
+
+      private:
+        std::map<std::string, std::vector<double>> prices_;
+        uint64_t prices_key_ = 0;
+
+        std::map<std::string, double> initial_vol_;
+        std::map<std::string, std::vector<double>> true_vol_;
+        std::map<std::string, std::vector<double>> pct_changes_;
+        struct Cached_Run {
+            Run_Result result;
+            uint64_t last_used = 0; // Value of run_clock_ when the result was last returned
+        };
+        std::map<uint64_t, Cached_Run> runs_;
+        size_t max_runs_;
+        uint64_t run_clock_ = 0;
+
+        Stage_Stats initial_vol_stats_{ "initial_volatility" };
+        Stage_Stats true_vol_stats_{ "true_volatility" };
+        Stage_Stats pct_changes_stats_{ "percentage_changes" };
+        Stage_Stats runs_stats_{ "managers" };
+
+        bool initial_vol_valid_ = false;
+        bool true_vol_valid_ = false;
+        bool pct_changes_valid_ = false;
+    };
+
+    /**
+     * @struct Walk_Forward_Config
+     * @brief Rolling train/test window layout for walk-forward evaluation.
+     */
+    struct Walk_Forward_Config {
+        size_t train_hours = 0;                  // Hours used to pick the strategy
+        size_t test_hours = 0;                   // Hours the picked strategy is evaluated on
+        size_t step_hours = 0;                   // Shift between consecutive windows (defaults to test_hours)
+        std::vector<std::string> strategies = { "optimistic", "neutral", "conservative" };
+        double initial_investment = 20000.0;     // Capital spread equally across tickers at the start of each window
+    };
+
+    /**
+     * @struct Walk_Forward_Window
+     * @brief Result of one train/test window.
+     */
+    struct Walk_Forward_Window {
+        size_t train_begin = 0;
+        size_t test_begin = 0;
+        size_t test_end = 0;
+        std::string strategy;    // Strategy with the best return on the train window
+        double train_return = 0; // Fractional return of that strategy on the train window
+        double test_return = 0;  // Fractional return of that strategy on the test window
+    };
+
+    /**
+     * @brief Walk-forward evaluation over rolling train/test windows.
+     *
+     * For every window each candidate strategy is run on the train hours, the best one is kept and then evaluated on
+     * the following test hours. Volatility and percentage changes are computed once for the whole history and sliced
+     * per window, so overlapping windows never recompute them; manager runs are memoized by the graph as well.
+     *
+     * @param graph A stage graph with prices already set.
+     * @param config Window layout and candidate strategies.
+     * @return One entry per window, in chronological order.
+     */
+    std::vector<Walk_Forward_Window> walkForward(StageGraph &graph, const Walk_Forward_Config &config);
+
+} // namespace pipeline
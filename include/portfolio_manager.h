@@ -1,4 +1,6 @@
 #pragma once
+#include "riskMetrics.h"
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <string>
@@ -15,8 +17,90 @@
 struct Portfolio_Manager_Result {
     std::vector<std::map<std::string, double>> allocations;       // Allocated funds for each stock at each hour
     std::vector<std::map<std::string, double>> portfolio_values;  // Portfolio values at each hour
+    metrics::Metrics_Summary metrics;                              // Risk and performance figures of the run
+    double unallocated_funds = 0.0;                                // Funds still waiting for a large enough ticket
 };
 
+/**
+ * @struct Selection_Config
+ * @brief Limits on how reallocation funds are spread over an hour's buying stocks.
+ *
+ * The defaults keep every candidate, which is the original behavior.
+ */
+struct Selection_Config {
+    size_t top_k = 0;        // Keep only the K candidates with the largest weight; 0 keeps all of them
+    double min_ticket = 0.0; // Drop candidates whose allocation would be smaller than this amount
+};
+
+/**
+ * @brief Computes the allocation weight of a stock from its average volatility.
+ * 
+ * @param avg_volatility The stock's average volatility.
+ * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+ * @return The (unnormalized) weight of the stock when splitting reallocation funds.
+ */
+inline double allocation_weight(double avg_volatility, const std::string& strategy) {
+    double weight = 0.0;
+
+    if (strategy == "optimistic") {
+        weight = 1.0 / (avg_volatility + 0.001); // Inverse relation to volatility
+    } else if (strategy == "neutral") {
+        weight = 1.0;
+    } else if (strategy == "conservative") {
+        weight = 1.0 / (avg_volatility + 0.0005); // Stronger inverse relation
+    }
+
+    return weight;
+}
+
+/**
+ * @brief Heap order of allocation candidates, as (position in the buying list, weight) pairs: the largest weight on
+ * top, the earlier candidate first on ties.
+ */
+inline bool lighter_candidate(const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) {
+    return a.second < b.second || (a.second == b.second && a.first > b.first);
+}
+
+/**
+ * @brief Keeps the heaviest candidates that still get a full ticket when the funds are split over them.
+ *
+ * With weights descending, the smallest share of the first m candidates only shrinks as m grows, so the candidates
+ * are popped heaviest first until the next one would get less than min_ticket. m kept candidates cost O(m log n)
+ * instead of sorting all n of them.
+ *
+ * @param candidates A heap under lighter_candidate. On return, only the kept candidates, in no particular order.
+ * @param funds Funds split over the kept candidates.
+ * @param min_ticket Smallest allocation a candidate may get.
+ */
+inline void keep_full_tickets(std::vector<std::pair<size_t, double>>& candidates, double funds, double min_ticket) {
+    auto heap_end = candidates.end();
+    double prefix_weight = 0.0;
+    while (heap_end != candidates.begin()) {
+        double weight = candidates.front().second;
+        if (weight / (prefix_weight + weight) * funds < min_ticket) {
+            break;
+        }
+        prefix_weight += weight;
+        std::pop_heap(candidates.begin(), heap_end, lighter_candidate);
+        --heap_end;
+    }
+    candidates.erase(candidates.begin(), heap_end);
+}
+
+/**
+ * @brief Sums the holdings of a portfolio.
+ * 
+ * @param my_portfolio The portfolio, mapping stock tickers to their values.
+ * @return The total value of the portfolio.
+ */
+inline double portfolio_value(const std::map<std::string, double>& my_portfolio) {
+    double total_value = 0.0;
+    for (const auto& [stock, value] : my_portfolio) {
+        total_value += value;
+    }
+    return total_value;
+}
+
 /**
  * @brief Manages portfolio allocation and updates based on strategy and market data.
  * 
@@ -29,17 +113,32 @@ struct Portfolio_Manager_Result {
  * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
  * @param stocks A map of stock tickers to their volatility data over time.
  * @param ticker_to_percentage_changes A map of stock tickers to their percentage changes over time.
+ * Both maps may store their columns as float or double (see precision::storage_t); sums and holdings stay in double.
+ * With a Selection_Config, each hour first keeps the top_k candidates by allocation weight (ties go to the earlier
+ * candidate) with a partial selection in O(n). Candidates whose share would be under min_ticket are then dropped,
+ * smallest weight first: the candidates are heaped and popped heaviest first until one would get less than a full
+ * ticket, so an hour that keeps m of them costs O(n + m log n) and never sorts all n. The funds are split over the
+ * rest. With a min_ticket, an hour that places nothing (no buying stocks, or not even one full ticket) carries its
+ * funds to the next hour; what is still unspent at the end is returned as unallocated_funds.
+ *
+ * @param metrics_config Settings of the risk and performance metrics, fed the opening value and then the value at the
+ * end of every hour. Values are net asset values: holdings plus sale proceeds not yet reallocated.
+ * @param selection Candidate limit and minimum ticket size.
  * @return A Portfolio_Manager_Result object containing allocation and portfolio updates at each hour.
  */
+template <typename T>
 Portfolio_Manager_Result portfolio_manager(
     const std::vector<std::vector<std::string>>& buying_stocks,
     const std::vector<double>& reallocation_funds,
     std::map<std::string, double>& my_portfolio,
     const std::string& strategy,
-    const std::map<std::string, std::vector<double>>& stocks,
-    const std::map<std::string, std::vector<double>>& ticker_to_percentage_changes) {
+    const std::map<std::string, std::vector<T>>& stocks,
+    const std::map<std::string, std::vector<T>>& ticker_to_percentage_changes,
+    const metrics::Metrics_Config& metrics_config = metrics::Metrics_Config(),
+    const Selection_Config& selection = Selection_Config()) {
     
     Portfolio_Manager_Result result;
+    metrics::Metrics_Engine metrics_engine(metrics_config);
 
     if (buying_stocks.empty() || reallocation_funds.empty()) {
         return result; // Empty result if no stocks to buy or funds
@@ -47,6 +146,22 @@ Portfolio_Manager_Result portfolio_manager(
 
     size_t hours = buying_stocks.size();
 
+    // stock_manager has already taken every hour's sale proceeds out of the holdings. Until an hour's proceeds are
+    // reallocated they are cash of the account, so the metrics follow the net asset value (holdings plus that cash)
+    // and putting the proceeds back is not counted as a return.
+    double pending_funds = 0.0;
+    for (size_t hour = 0; hour < hours; ++hour) {
+        pending_funds += std::max(reallocation_funds[hour], 0.0);
+    }
+    metrics_engine.update(portfolio_value(my_portfolio) + pending_funds); // Opening value
+
+    // Average volatility per stock, filled on first use
+    std::map<std::string, double> average_volatility;
+
+    // Candidates of the current hour, reused across hours
+    std::vector<std::pair<size_t, double>> candidates;
+    double carried_funds = 0.0;
+
     for (size_t hour = 0; hour < hours; ++hour) {
         // **Update portfolio for market changes at the start of each hour**
         for (auto& [stock, value] : my_portfolio) {
@@ -65,8 +180,19 @@ Portfolio_Manager_Result portfolio_manager(
         // Allocation for the current hour
         std::map<std::string, double> hour_allocation;
 
+        // Money sold by stock_manager this hour, for turnover
+        double traded = std::max(reallocation_funds[hour], 0.0);
+        pending_funds -= traded;
+
+        // Funds to place this hour, including any carried over for lack of a large enough ticket
+        double funds = std::max(reallocation_funds[hour], 0.0) + carried_funds;
+
         // Skip this hour if no buying stocks or reallocation funds
-        if (buying_stocks[hour].empty() || reallocation_funds[hour] <= 0) {
+        if (buying_stocks[hour].empty() || funds <= 0) {
+            if (selection.min_ticket > 0) {
+                carried_funds = funds; // Nothing to buy yet: keep the funds for a later hour
+            }
+            metrics_engine.update(portfolio_value(my_portfolio) + pending_funds + carried_funds, traded);
             // Store current portfolio values
             result.portfolio_values.push_back(my_portfolio);
             // Even if no allocation happened, store an empty allocation
@@ -74,46 +200,76 @@ Portfolio_Manager_Result portfolio_manager(
             continue;
         }
 
-        // Determine weights for allocation based on strategy and average volatility
-        std::map<std::string, double> allocation_weights;
-        double total_weight = 0.0;
-
-        for (const auto& stock : buying_stocks[hour]) {
-            const auto& volatility_values = stocks.at(stock);
-            double avg_volatility = 0.0;
-
-            // Calculate average volatility for the stock
-            for (double vol : volatility_values) {
-                avg_volatility += vol;
+        // Determine weights for allocation based on strategy and average volatility, as (candidate, weight) pairs in
+        // buying order
+        candidates.clear();
+        for (size_t i = 0; i < buying_stocks[hour].size(); ++i) {
+            const std::string& stock = buying_stocks[hour][i];
+            // Average volatility over the whole series does not change between hours, so compute it once per stock
+            auto cached = average_volatility.find(stock);
+            if (cached == average_volatility.end()) {
+                const auto& volatility_values = stocks.at(stock);
+                double sum = 0.0;
+                for (double vol : volatility_values) {
+                    sum += vol;
+                }
+                cached = average_volatility.emplace(stock, sum / volatility_values.size()).first;
             }
-            avg_volatility /= volatility_values.size();
+            double avg_volatility = cached->second;
 
-            double weight = 0.0;
+            candidates.emplace_back(i, allocation_weight(avg_volatility, strategy));
+        }
 
-            if (strategy == "optimistic") {
-                weight = 1.0 / (avg_volatility + 0.001); // Inverse relation to volatility
-            } else if (strategy == "neutral") {
-                weight = 1.0;
-            } else if (strategy == "conservative") {
-                weight = 1.0 / (avg_volatility + 0.0005); // Stronger inverse relation
-            }
+        // Largest weight first, earlier candidate first on ties
+        auto heavier = [](const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        };
+        bool reordered = false;
+        if (selection.top_k > 0 && candidates.size() > selection.top_k) {
+            std::nth_element(candidates.begin(), candidates.begin() + (selection.top_k - 1), candidates.end(),
+                             heavier);
+            candidates.resize(selection.top_k);
+            reordered = true;
+        }
+        if (selection.min_ticket > 0) {
+            std::make_heap(candidates.begin(), candidates.end(), lighter_candidate);
+            keep_full_tickets(candidates, funds, selection.min_ticket);
+            reordered = true;
+        }
+        if (reordered) {
+            std::sort(candidates.begin(), candidates.end());
+        }
 
-            allocation_weights[stock] = weight;
+        if (candidates.empty()) {
+            // Not even one full ticket: keep the funds for the next hour
+            carried_funds = funds;
+            metrics_engine.update(portfolio_value(my_portfolio) + pending_funds + carried_funds, traded);
+            result.portfolio_values.push_back(my_portfolio);
+            result.allocations.push_back(hour_allocation);
+            continue;
+        }
+        carried_funds = 0.0;
+
+        double total_weight = 0.0;
+        for (const auto& [index, weight] : candidates) {
             total_weight += weight;
         }
 
         // Allocate funds proportionally based on weights
-        for (const auto& stock : buying_stocks[hour]) {
-            double weight = allocation_weights[stock];
-            double allocation = (weight / total_weight) * reallocation_funds[hour];
+        for (const auto& [index, weight] : candidates) {
+            const std::string& stock = buying_stocks[hour][index];
+            double allocation = (weight / total_weight) * funds;
 
             // Update the portfolio with the allocated funds
             my_portfolio[stock] += allocation;
 
             // Store the allocation result
             hour_allocation[stock] = allocation;
+            traded += allocation;
         }
 
+        metrics_engine.update(portfolio_value(my_portfolio) + pending_funds, traded);
+
         // Add the allocation for this hour to the result
         result.allocations.push_back(hour_allocation);
 
@@ -121,6 +277,8 @@ Portfolio_Manager_Result portfolio_manager(
         result.portfolio_values.push_back(my_portfolio);
     }
 
+    result.unallocated_funds = carried_funds;
+    result.metrics = metrics_engine.summary();
     return result;
 }
 
@@ -0,0 +1,113 @@
+#pragma once
+#include "volatilityParse.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace precision {
+
+    /**
+     * @brief Element type of the volatility and percentage change columns the app hands to the managers.
+     *
+     * Configure with -DVOLATILITY_FLOAT_STORAGE=ON to store them as float. stock_manager and portfolio_manager widen
+     * every value to double before comparing, summing or compounding it.
+     */
+#ifdef VOLATILITY_FLOAT_STORAGE
+    using storage_t = float;
+#else
+    using storage_t = double;
+#endif
+
+    template <typename T>
+    using Column_Map = std::map<std::string, std::vector<T>>;
+
+    /**
+     * @brief Converts double columns into the requested storage type.
+     *
+     * The double columns are released ticker by ticker, so peak memory is one ticker above the float copy. When T is
+     * double the map is moved through unchanged.
+     */
+    template <typename T>
+    Column_Map<T> toStorage(Column_Map<double> &&columns) {
+        if constexpr (std::is_same_v<T, double>) {
+            return std::move(columns);
+        } else {
+            Column_Map<T> stored;
+            for (auto &[ticker, values] : columns) {
+                stored[ticker].assign(values.begin(), values.end());
+                std::vector<double>().swap(values);
+            }
+            columns.clear();
+            return stored;
+        }
+    }
+
+    /**
+     * @brief Percentage changes between consecutive prices, computed in double and stored as T.
+     *
+     * Same definition as calculate_percentage_changes, including 0.0 when the previous price is zero.
+     */
+    template <typename T>
+    std::vector<T> percentageChanges(const std::vector<T> &prices) {
+        std::vector<T> changes;
+        changes.reserve(prices.empty() ? 0 : prices.size() - 1);
+        for (size_t i = 1; i < prices.size(); ++i) {
+            double prev_price = prices[i - 1];
+            double curr_price = prices[i];
+            changes.push_back(prev_price != 0 ? static_cast<T>((curr_price - prev_price) / prev_price * 100.0) : T(0));
+        }
+        return changes;
+    }
+
+    /**
+     * @brief True (EWMA) volatility of one price column, with the running variance kept in double.
+     *
+     * Same seeding and recursion as tickerToVolHourly + true_volatility; only the stored outputs are rounded to T.
+     */
+    template <typename T>
+    std::vector<T> trueVolatility(const std::vector<T> &prices, double lambda = 0.94) {
+        std::vector<T> volatility;
+        volatility.reserve(prices.size() > 6 ? prices.size() - 6 : 0);
+        volParsing::Volatility_State state;
+        for (T price : prices) {
+            if (volParsing::push_price(state, static_cast<double>(price), lambda)) {
+                volatility.push_back(static_cast<T>(state.volatility));
+            }
+        }
+        return volatility;
+    }
+
+    /**
+     * @struct Accuracy_Report
+     * @brief How far the float storage path drifts from the double path.
+     */
+    struct Accuracy_Report {
+        double max_abs_error_volatility = 0.0;
+        double max_rel_error_volatility = 0.0;
+        double max_abs_error_percentage = 0.0;   // In percentage points
+        double max_rel_error_price = 0.0;        // Rounding error of the stored prices themselves
+        size_t decisions = 0;                    // Ticker-hours compared
+        size_t decision_mismatches = 0;          // Ticker-hours where stock_manager would decide differently
+        size_t bytes_double = 0;                 // Price + volatility + percentage columns stored as double
+        size_t bytes_float = 0;                  // Same columns stored as float
+    };
+
+    /**
+     * @brief Runs the volatility and percentage change kernels on float and double storage and compares them.
+     *
+     * @param ticker_to_prices Map of ticker to prices.
+     * @param strategy Strategy whose stock_manager thresholds are used to count decision mismatches.
+     * @return Error bounds, decision mismatches and memory footprint of both paths.
+     */
+    Accuracy_Report compareToDouble(const std::map<std::string, std::vector<double>> &ticker_to_prices,
+                                    const std::string &strategy);
+
+    /**
+     * @brief Prints an Accuracy_Report in the same style as the rest of the console output.
+     */
+    void printReport(const Accuracy_Report &report);
+
+} // namespace precision
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace rangeIndex {
+
+    /**
+     * @class Range_Index
+     * @brief Window statistics over one series in O(1) per query.
+     *
+     * Keeps prefix sums of the values for sum / mean, stored relative to the first value appended, and a sparse table
+     * for min / max. Sum, mean, min and max are O(1) per query.
+     *
+     * Variance does not subtract prefix sums of squares, which cancel badly on a long drifting series. Every aligned
+     * block of 2^k values keeps its mean and sum of squared deviations (M2). A query splits the window into O(log n)
+     * such blocks and merges their statistics with Chan's pairwise Welford update, so it costs O(log n).
+     *
+     * The sparse table keeps log n levels of up to n values each, so building takes O(n log n) time and memory, not
+     * linear; the variance blocks add O(n). Appending one value costs O(log n), so the index can follow a live series
+     * bar by bar. All ranges are half-open [begin, end) and are clamped to size(); an empty range returns NaN.
+     *
+     * The Python bindings expose it for window queries. portfolio_manager only needs whole-series averages and caches
+     * one per stock instead.
+     */
+    class Range_Index {
+      public:
+        Range_Index() = default;
+        explicit Range_Index(const std::vector<double> &values);
+
+        /**
+         * @brief Appends one value to the end of the series.
+         */
+        void append(double value);
+
+        size_t size() const { return prefix_sum_.size() - 1; }
+
+        double sum(size_t begin, size_t end) const;
+        double mean(size_t begin, size_t end) const;
+
+        /**
+         * @brief Sample variance (N - 1 denominator, as volFormula::volatility uses). NaN for fewer than 2 values.
+         */
+        double variance(size_t begin, size_t end) const;
+
+        double min(size_t begin, size_t end) const;
+        double max(size_t begin, size_t end) const;
+
+      private:
+        static size_t log2Floor(size_t n);
+        bool clamp(size_t &begin, size_t &end) const;
+
+        // Mean and sum of squared deviations of one block of values
+        struct Moments {
+            double mean;
+            double m2;
+        };
+
+        double shift_ = 0.0;
+        std::vector<double> prefix_sum_{ 0.0 }; // prefix_sum_[i] = sum of (value - shift_) over [0, i)
+        std::vector<std::vector<Moments>> moments_; // moments_[k][j] = moments of [j * 2^k, (j + 1) * 2^k)
+        std::vector<std::vector<double>> min_table_; // min_table_[k][i] = min over [i, i + 2^k)
+        std::vector<std::vector<double>> max_table_;
+    };
+
+    /**
+     * @class Ticker_Range_Index
+     * @brief One Range_Index per ticker, built from the usual ticker-to-series map.
+     */
+    class Ticker_Range_Index {
+      public:
+        Ticker_Range_Index() = default;
+        explicit Ticker_Range_Index(const std::map<std::string, std::vector<double>> &series);
+
+        void append(const std::string &ticker, double value) { indexes_[ticker].append(value); }
+
+        bool contains(const std::string &ticker) const { return indexes_.count(ticker) > 0; }
+
+        /**
+         * @brief Index of one ticker. Throws std::out_of_range if the ticker is unknown.
+         */
+        const Range_Index &at(const std::string &ticker) const { return indexes_.at(ticker); }
+
+      private:
+        std::map<std::string, Range_Index> indexes_;
+    };
+
+} // namespace rangeIndex
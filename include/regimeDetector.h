@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace regime {
+
+    /**
+     * @struct Regime_Config
+     * @brief Tuning of the online regime filter and of how regimes map to threshold multipliers.
+     */
+    struct Regime_Config {
+        size_t warmup = 48;                  // Observations used to seed the two regimes
+        double stay_probability = 0.97;      // Chance of staying in the same regime from one bar to the next
+        double adaptation = 0.005;           // Learning rate of the regime means and variances
+        double reference_volatility = 0.003; // Volatility level the fixed stock_manager thresholds were tuned for
+        double turbulent_tightening = 0.85;  // Extra multiplier while a ticker is in its turbulent regime
+        double min_scale = 0.25;             // Clamp on the resulting threshold multiplier
+        double max_scale = 4.0;
+    };
+
+    /**
+     * @struct Regime_State
+     * @brief Filter state of one ticker. Regime 0 is calm, regime 1 is turbulent.
+     */
+    struct Regime_State {
+        double mean[2] = { 0.0, 0.0 };     // Mean of log volatility in each regime
+        double variance[2] = { 1.0, 1.0 }; // Variance of log volatility in each regime
+        double p_turbulent = 0.0;          // Filtered probability of the turbulent regime
+        size_t count = 0;                  // Observations seen
+    };
+
+    /**
+     * @class Regime_Detector
+     * @brief Online two-state Gaussian HMM filter on the log EWMA volatility of each ticker.
+     *
+     * Each update runs one forward-filter step (predict with the transition matrix, weight by the Gaussian
+     * likelihood of each regime, normalize) and nudges the regime means and variances toward the observation in
+     * proportion to their posterior. That is O(1) work with a single exp() per ticker per bar and no allocation.
+     *
+     * The output is a threshold multiplier for decide_stock: the ticker's calm volatility level relative to the level
+     * the fixed thresholds were tuned for, tightened while the ticker is turbulent. A naturally volatile ticker is
+     * therefore no longer sold every hour, and any ticker is sold earlier once it leaves its own calm regime.
+     */
+    class Regime_Detector {
+      public:
+        explicit Regime_Detector(size_t tickers = 0, const Regime_Config &config = Regime_Config());
+
+        /**
+         * @brief Feeds the latest volatility of one ticker. O(1).
+         */
+        void update(size_t ticker, double volatility);
+
+        double turbulentProbability(size_t ticker) const { return states_[ticker].p_turbulent; }
+        bool turbulent(size_t ticker) const { return states_[ticker].p_turbulent > 0.5; }
+
+        /**
+         * @brief Multiplier for the stock_manager thresholds of one ticker at its current regime. 1.0 during warmup.
+         */
+        double thresholdScale(size_t ticker) const;
+
+        const Regime_State &state(size_t ticker) const { return states_[ticker]; }
+        size_t size() const { return states_.size(); }
+
+      private:
+        Regime_Config config_;
+        std::vector<Regime_State> states_;
+        std::vector<double> warmup_sum_;    // Sum and sum of squares of log volatility during warmup
+        std::vector<double> warmup_square_;
+    };
+
+    /**
+     * @brief Runs the detector over whole volatility series and returns the per-hour threshold multipliers.
+     *
+     * The result plugs directly into the threshold_scales argument of stock_manager. The multiplier for hour h only
+     * uses volatility up to and including hour h.
+     *
+     * @param true_volatility A map of stock tickers to their volatility vectors over time.
+     * @param config Filter tuning.
+     * @return A map of stock tickers to their threshold multipliers over time.
+     */
+    std::map<std::string, std::vector<double>>
+    thresholdScales(const std::map<std::string, std::vector<double>> &true_volatility,
+                    const Regime_Config &config = Regime_Config());
+
+} // namespace regime
@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace replay {
+
+    /**
+     * @class Latency_Histogram
+     * @brief Log-linear latency histogram in nanoseconds.
+     *
+     * Values are grouped by power of two and then split into 32 linear sub-buckets, which keeps the relative error
+     * of any reported percentile under ~3% with a fixed 2048-slot table and O(1) recording.
+     */
+    class Latency_Histogram {
+      public:
+        void record(uint64_t nanoseconds);
+
+        /**
+         * @brief Approximate value at the given percentile (0-100).
+         */
+        uint64_t percentile(double p) const;
+
+        uint64_t count() const { return count_; }
+        uint64_t min() const { return count_ == 0 ? 0 : min_; }
+        uint64_t max() const { return max_; }
+        double mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_; }
+
+        void merge(const Latency_Histogram &other);
+
+      private:
+        static constexpr size_t kSubBuckets = 32;
+        static constexpr size_t kBuckets = 64 * kSubBuckets;
+
+        static size_t bucketOf(uint64_t value);
+        static uint64_t bucketUpperBound(size_t bucket);
+
+        std::array<uint64_t, kBuckets> counts_{};
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t min_ = UINT64_MAX;
+        uint64_t max_ = 0;
+    };
+
+    /**
+     * @struct Bar_Message
+     * @brief One bar on the wire. Sent in hour order, every ticker of an hour before the next hour.
+     */
+    struct Bar_Message {
+        uint32_t ticker;   // Index into the ticker list sent in the handshake
+        uint32_t hour;     // Position of the bar in the ticker's price series
+        double price;      // Close price of the bar
+        int64_t send_ns;   // Server steady_clock timestamp taken just before the bar was written
+        uint32_t flags;    // Combination of kLastInHour and kEndOfStream
+        uint32_t reserved;
+    };
+
+    constexpr uint32_t kLastInHour = 1;
+    constexpr uint32_t kEndOfStream = 2;
+
+    /**
+     * @struct Replay_Config
+     * @brief Settings for the replay server.
+     */
+    struct Replay_Config {
+        std::string socket_path = "/tmp/volatility_replay.sock"; // Unix domain socket to listen on
+        double speed = 0.0;         // 0 = as fast as possible, 1 = real time, N = N times real time
+        double bar_seconds = 3600;  // Wall-clock length of one bar at real time
+    };
+
+    /**
+     * @brief Streams stored bars to one client over a local Unix domain socket.
+     *
+     * Blocks until a client connects, sends the ticker list followed by every bar in hour order, then closes.
+     *
+     * @param config Socket path and playback speed.
+     * @param ticker_to_prices Map of ticker to hourly prices to replay.
+     * @return True if the whole stream was delivered.
+     */
+    bool serveReplay(const Replay_Config &config, const std::map<std::string, std::vector<double>> &ticker_to_prices);
+
+    /**
+     * @struct Replay_Report
+     * @brief What the client measured while consuming a replay.
+     */
+    struct Replay_Report {
+        size_t bars = 0;                              // Bars received
+        size_t hours = 0;                             // Hours completed
+        Latency_Histogram latency;                    // Bar received to decision done, per bar
+        Latency_Histogram delivery;                   // Server send to bar received, per bar
+        std::map<std::string, double> final_portfolio; // Holdings after the last hour
+    };
+
+    /**
+     * @brief Connects to a replay server and drives the decision path for every bar.
+     *
+     * Each bar updates the ticker's holdings by its price change, advances its EWMA volatility and runs the
+     * stock_manager decision for it. The last bar of an hour also reallocates the freed funds with the
+     * portfolio_manager weights.
+     *
+     * Each bar is timed twice. latency runs from the moment the bar is read off the socket to the end of its
+     * decision, so it measures only the decision path. delivery runs from the server send to that read. With
+     * speed 0 the server writes bars faster than they are consumed, so delivery is mostly time spent queued in the
+     * socket buffer; at a paced speed it is the socket hop.
+     *
+     * @param socket_path Unix domain socket the server listens on.
+     * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+     * @param my_portfolio Starting holdings.
+     * @param report Filled with the bar count, latency histogram and final holdings.
+     * @return True if the stream ended cleanly.
+     */
+    bool runReplayClient(const std::string &socket_path, const std::string &strategy,
+                         const std::map<std::string, double> &my_portfolio, Replay_Report &report);
+
+} // namespace replay
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace metrics {
+
+    /**
+     * @struct Metrics_Config
+     * @brief Annualization and tail settings of the metrics engine.
+     */
+    struct Metrics_Config {
+        double periods_per_year = 1638.0; // Hourly bars: 252 trading days of 6.5 hours
+        double risk_free_rate = 0.0;      // Annual risk-free rate used by Sharpe and Sortino
+        double var_confidence = 0.95;     // Confidence level of the historical VaR and CVaR
+        bool tail_metrics = true;         // Keep every return for the VaR and CVaR; false keeps memory O(1)
+    };
+
+    /**
+     * @struct Metrics_Summary
+     * @brief Risk and performance figures of a run so far. Returns are simple per-bar returns of the portfolio value;
+     * drawdowns, VaR and CVaR are positive fractions of the portfolio value.
+     */
+    struct Metrics_Summary {
+        size_t bars = 0;                  // Bars seen, including the first one (which has no return)
+        double last_value = 0.0;          // Latest portfolio value
+        double peak_value = 0.0;          // Highest portfolio value so far
+        double current_drawdown = 0.0;    // Drop from the peak to the latest value
+        double max_drawdown = 0.0;        // Largest drop from a peak so far
+        double total_return = 0.0;        // Latest value over the first value, minus one
+        double mean_return = 0.0;         // Mean per-bar return
+        double realized_volatility = 0.0; // Annualized standard deviation of the per-bar returns
+        double sharpe = 0.0;              // Annualized Sharpe ratio
+        double sortino = 0.0;             // Annualized Sortino ratio
+        double traded = 0.0;              // Total money bought and sold
+        double turnover = 0.0;            // Traded money over two times the average portfolio value
+        double value_at_risk = 0.0;       // Historical one-bar VaR at the configured confidence
+        double expected_shortfall = 0.0;  // Historical one-bar CVaR: mean loss beyond the VaR
+    };
+
+    /**
+     * @class Metrics_Engine
+     * @brief Online risk and performance metrics over a stream of portfolio values.
+     *
+     * Drawdown, the return moments (Welford), the downside deviation and turnover are O(1) per bar. The historical
+     * VaR and CVaR keep the worst ceil((1 - confidence) * n) returns in a max-heap with a running sum and the rest in a
+     * min-heap, so each bar costs O(log n) and the tail never has to be sorted. Those heaps hold every return, so with
+     * Metrics_Config::tail_metrics off they are skipped and VaR and CVaR read 0.
+     */
+    class Metrics_Engine {
+      public:
+        explicit Metrics_Engine(const Metrics_Config &config = Metrics_Config());
+
+        /**
+         * @brief Records one bar.
+         *
+         * @param portfolio_value Total portfolio value at the end of the bar.
+         * @param traded Money bought plus money sold during the bar.
+         */
+        void update(double portfolio_value, double traded = 0.0);
+
+        /**
+         * @brief Current figures. O(1).
+         */
+        Metrics_Summary summary() const;
+
+        size_t bars() const { return bars_; }
+
+      private:
+        Metrics_Config config_;
+        size_t bars_ = 0;
+        double first_value_ = 0.0;
+        double last_value_ = 0.0;
+        double peak_value_ = 0.0;
+        double max_drawdown_ = 0.0;
+        double value_sum_ = 0.0;
+
+        // Return moments
+        size_t returns_ = 0;
+        double mean_ = 0.0;
+        double m2_ = 0.0;
+        double downside_square_ = 0.0;
+        double traded_ = 0.0;
+
+        // Historical tail: worst returns (max-heap, top is the VaR return) and the rest (min-heap)
+        std::priority_queue<double> tail_;
+        std::priority_queue<double, std::vector<double>, std::greater<double>> body_;
+        double tail_sum_ = 0.0;
+    };
+
+} // namespace metrics
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sharedData {
+
+    constexpr char kMagic[8] = { 'V', 'O', 'L', 'S', 'H', 'M', '0', '1' };
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kTickerNameSize = 16;
+    constexpr char kDefaultSegment[] = "/volatility_panel";
+
+    /**
+     * @struct Segment_Header
+     * @brief Fixed header at offset 0 of a shared market data segment.
+     *
+     * The magic is written last by the publisher, so a reader that sees a valid magic and version also sees a
+     * fully written segment.
+     */
+    struct Segment_Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;  // sizeof(Segment_Header), for forward compatibility
+        uint64_t ticker_count;
+        uint64_t total_size;   // Size of the whole segment in bytes
+        uint64_t generation;   // Bumped by the publisher every time the segment is rebuilt
+    };
+
+    /**
+     * @struct Ticker_Entry
+     * @brief Directory entry for one ticker. Offsets are in bytes from the start of the segment.
+     */
+    struct Ticker_Entry {
+        char name[kTickerNameSize];
+        uint64_t price_offset;
+        uint64_t price_count;
+        uint64_t volatility_offset;
+        uint64_t volatility_count;
+        uint64_t percentage_offset;
+        uint64_t percentage_count;
+    };
+
+    /**
+     * @struct Series
+     * @brief Read-only view of one column inside the segment. No data is copied.
+     */
+    struct Series {
+        const double *data = nullptr;
+        size_t size = 0;
+
+        const double *begin() const { return data; }
+        const double *end() const { return data + size; }
+        double operator[](size_t i) const { return data[i]; }
+        bool empty() const { return size == 0; }
+    };
+
+    /**
+     * @brief Publishes prices and derived columns into a named POSIX shared memory segment.
+     *
+     * Any existing segment with the same name is replaced. Every column is 64-byte aligned.
+     *
+     * @param name Segment name, e.g. "/volatility_panel".
+     * @param prices Map of ticker to prices.
+     * @param volatility Map of ticker to EWMA volatility (may be empty).
+     * @param percentage_changes Map of ticker to hourly percentage changes (may be empty).
+     * @param generation Version counter stored in the header so workers can detect a republish.
+     * @return True on success, false if the segment could not be created (the reason is printed to std::cerr).
+     */
+    bool publish(const std::string &name, const std::map<std::string, std::vector<double>> &prices,
+                 const std::map<std::string, std::vector<double>> &volatility,
+                 const std::map<std::string, std::vector<double>> &percentage_changes, uint64_t generation = 1);
+
+    /**
+     * @brief Removes a published segment. Workers that already mapped it keep their mapping.
+     */
+    bool unpublish(const std::string &name);
+
+    /**
+     * @class MarketView
+     * @brief Read-only mapping of a published segment.
+     */
+    class MarketView {
+      public:
+        MarketView() = default;
+        ~MarketView();
+        MarketView(const MarketView &) = delete;
+        MarketView &operator=(const MarketView &) = delete;
+        MarketView(MarketView &&other) noexcept;
+        MarketView &operator=(MarketView &&other) noexcept;
+
+        /**
+         * @brief Maps the named segment read-only and validates its header.
+         *
+         * @return True on success, false if the segment is missing, truncated or has another version.
+         */
+        bool attach(const std::string &name);
+        void detach();
+
+        bool attached() const { return base_ != nullptr; }
+
+        /**
+         * @brief Generation stored by the publisher, or 0 if nothing is attached.
+         */
+        uint64_t generation() const;
+        size_t tickerCount() const;
+
+        /**
+         * @brief Name of the ticker at an index; empty if the index is out of range.
+         */
+        std::string ticker(size_t index) const;
+
+        /**
+         * @brief Index of a ticker in the directory, or tickerCount() if it is not present.
+         */
+        size_t find(const std::string &ticker) const;
+
+        /**
+         * @brief Columns of the ticker at an index; empty if the index is out of range.
+         */
+        Series prices(size_t index) const;
+        Series volatility(size_t index) const;
+        Series percentageChanges(size_t index) const;
+
+        /**
+         * @brief Copies one column of every ticker into a map, for code that still takes std::map inputs.
+         */
+        std::map<std::string, std::vector<double>> pricesMap() const;
+        std::map<std::string, std::vector<double>> volatilityMap() const;
+        std::map<std::string, std::vector<double>> percentageChangesMap() const;
+
+      private:
+        const Ticker_Entry &entry(size_t index) const;
+        Series column(uint64_t offset, uint64_t count) const;
+
+        const unsigned char *base_ = nullptr;
+        size_t size_ = 0;
+    };
+
+} // namespace sharedData
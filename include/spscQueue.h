@@ -0,0 +1,149 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Spsc_Queue
+ * @brief Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The head is written only by the consumer and the tail only by the producer, each on its own cache line, so the
+ * two sides never contend on a lock. Each side also keeps a cached copy of the other's index and only reloads it
+ * when the queue looks full (producer) or empty (consumer).
+ *
+ * push and pop yield a few times and then sleep on a condition variable, so a stage waiting on a slow neighbour (a
+ * download, say) gives its core back. The other side only takes the mutex when someone is actually asleep.
+ *
+ * @tparam T Element type. Must be default constructible and movable.
+ */
+template <typename T>
+class Spsc_Queue {
+  public:
+    /**
+     * @param capacity Minimum number of elements the queue can hold; rounded up to a power of two.
+     */
+    explicit Spsc_Queue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity + 1) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    Spsc_Queue(const Spsc_Queue &) = delete;
+    Spsc_Queue &operator=(const Spsc_Queue &) = delete;
+
+    /**
+     * @brief Producer side. Returns false without blocking if the queue is full.
+     */
+    bool try_push(T &&value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & mask_;
+        if (next == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (next == cached_head_) {
+                return false;
+            }
+        }
+        slots_[tail] = std::move(value);
+        tail_.store(next, std::memory_order_release);
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Producer side. Blocks until there is room.
+     */
+    void push(T value) {
+        for (size_t spin = 0; !try_push(std::move(value)); ++spin) {
+            if (spin < kSpins) {
+                std::this_thread::yield();
+            } else {
+                sleepUntil([this]() {
+                    size_t next = (tail_.load(std::memory_order_relaxed) + 1) & mask_;
+                    return next != head_.load(std::memory_order_seq_cst);
+                });
+            }
+        }
+    }
+
+    /**
+     * @brief Consumer side. Returns std::nullopt without blocking if the queue is empty.
+     */
+    std::optional<T> try_pop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> value(std::move(slots_[head]));
+        head_.store((head + 1) & mask_, std::memory_order_release);
+        wake();
+        return value;
+    }
+
+    /**
+     * @brief Consumer side. Blocks until an element is available.
+     */
+    T pop() {
+        for (size_t spin = 0;; ++spin) {
+            std::optional<T> value = try_pop();
+            if (value) {
+                return std::move(*value);
+            }
+            if (spin < kSpins) {
+                std::this_thread::yield();
+            } else {
+                sleepUntil([this]() {
+                    return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_seq_cst);
+                });
+            }
+        }
+    }
+
+    size_t capacity() const { return mask_; }
+
+  private:
+    // Yielding attempts before a blocking call goes to sleep
+    static constexpr size_t kSpins = 16;
+
+    // Called after every index update. The fence pairs with the one in sleepUntil: either the sleeper sees the new
+    // index, or this side sees the sleeper.
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.notify_all();
+        }
+    }
+
+    template <typename Predicate>
+    void sleepUntil(Predicate ready) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ready_.wait(lock, ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<size_t> head_{ 0 }; // Next slot to read (consumer)
+    size_t cached_tail_ = 0;                    // Consumer's copy of tail_
+
+    alignas(64) std::atomic<size_t> tail_{ 0 }; // Next slot to write (producer)
+    size_t cached_head_ = 0;                    // Producer's copy of head_
+
+    alignas(64) std::atomic<int> sleepers_{ 0 }; // Threads blocked in sleepUntil
+    std::mutex mutex_;
+    std::condition_variable ready_;
+};
@@ -5,6 +5,31 @@
 #include <vector>
 #include <utility> // For std::pair
 
+/**
+ * @brief Calculates the percentage changes of one price series.
+ *
+ * @param prices The prices over time.
+ * @return The percentage change between each pair of consecutive prices; 0 where the previous price is zero.
+ */
+inline std::vector<double> series_percentage_changes(const std::vector<double>& prices) {
+    std::vector<double> percentage_changes;
+    percentage_changes.reserve(prices.size() > 1 ? prices.size() - 1 : 0);
+
+    for (size_t i = 1; i < prices.size(); ++i) {
+        double prev_price = prices[i - 1];
+        double curr_price = prices[i];
+
+        if (prev_price != 0) { // Avoid division by zero
+            double percentage_change = ((curr_price - prev_price) / prev_price) * 100.0;
+            percentage_changes.push_back(percentage_change);
+        } else {
+            percentage_changes.push_back(0.0); // No change if previous price is zero
+        }
+    }
+
+    return percentage_changes;
+}
+
 /**
  * @brief Calculates the percentage changes in stock prices.
  * 
@@ -13,7 +38,7 @@
  * @param ticker_to_prices A map of stock tickers to their price vectors over time.
  * @return A map of stock tickers to their percentage change vectors.
  */
-std::map<std::string, std::vector<double>> calculate_percentage_changes(
+inline std::map<std::string, std::vector<double>> calculate_percentage_changes(
     const std::map<std::string, std::vector<double>>& ticker_to_prices) {
     
     // Map to store percentage changes for each ticker
@@ -21,24 +46,7 @@ std::map<std::string, std::vector<double>> calculate_percentage_changes(
 
     // Iterate through each ticker and its price vector
     for (const auto& [ticker, prices] : ticker_to_prices) {
-        std::vector<double> percentage_changes;
-
-        // Calculate percentage changes for this ticker
-        for (size_t i = 1; i < prices.size(); ++i) {
-            double prev_price = prices[i - 1];
-            double curr_price = prices[i];
-
-            if (prev_price != 0) { // Avoid division by zero
-                double percentage_change = ((curr_price - prev_price) / prev_price) * 100.0;
-                percentage_changes.push_back(percentage_change);
-            } else {
-                percentage_changes.push_back(0.0); // No change if previous price is zero
-            }
-        }
-        
-
-        // Add this ticker's percentage changes to the map
-        ticker_to_percentage_changes[ticker] = percentage_changes;
+        ticker_to_percentage_changes[ticker] = series_percentage_changes(prices);
     }
 
     return ticker_to_percentage_changes;
@@ -56,21 +64,92 @@ struct Stock_Manager_Result {
     std::vector<double> reallocation_funds;                // Funds freed up at each hour
 };
 
+/**
+ * @struct Stock_Decision
+ * @brief Decision taken for a single stock at a single hour.
+ */
+struct Stock_Decision {
+    bool buy = false;         // Stock goes onto the buying list
+    bool sell = false;        // Stock goes onto the selling list
+    double adjustment = 0.0;  // Change applied to the invested money (negative when selling)
+};
+
+/**
+ * @brief Decides whether to buy or sell one stock given its current volatility.
+ * 
+ * @param avg_volatility The stock's volatility for the current hour.
+ * @param invested_money The amount currently invested in the stock.
+ * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+ * @param threshold_scale Multiplier applied to every volatility threshold (1.0 keeps the fixed thresholds).
+ * @return The decision and the adjustment to apply to the invested money.
+ */
+inline Stock_Decision decide_stock(double avg_volatility, double invested_money, const std::string& strategy,
+                                   double threshold_scale = 1.0) {
+    Stock_Decision decision;
+
+    // Adjustments based on the strategy and average volatility
+    if (strategy == "optimistic") {
+        // "Optimistic" strategy focuses on more buying opportunities, even at higher volatility.
+        if (avg_volatility <= 0.0025 * threshold_scale) {
+            decision.buy = true; // Strong buy
+        } else if (avg_volatility <= 0.004 * threshold_scale) {
+            decision.buy = true; // Moderate buy
+        } else {
+            // Very high volatility; sell a portion of the stock to free up funds
+            decision.adjustment = -invested_money * 0.05; // Light sell
+            decision.sell = true;
+        }
+    } else if (strategy == "neutral") {
+        // "Neutral" strategy balances between buying and selling.
+        if (avg_volatility > 0.004 * threshold_scale) {
+            decision.adjustment = -invested_money * 0.03; // Light sell for higher volatility
+            decision.sell = true;
+        } else if (avg_volatility > 0.003 * threshold_scale) {
+            // Moderate volatility; no action or slight buy
+            decision.buy = true;
+        } else {
+            // Low volatility; slight buy
+            decision.buy = true;
+        }
+    } else if (strategy == "conservative") {
+        // "Conservative" strategy is cautious about high volatility.
+        if (avg_volatility > 0.004 * threshold_scale) {
+            decision.adjustment = -invested_money * 0.1; // Strong sell for very high volatility
+            decision.sell = true;
+        } else if (avg_volatility > 0.0035 * threshold_scale) {
+            decision.adjustment = -invested_money * 0.05; // Moderate sell
+            decision.sell = true;
+        } else {
+            // Low volatility; slight buy
+            decision.buy = true;
+        }
+    }
+
+    return decision;
+}
+
 /**
  * @brief Manages stock buying and selling decisions based on strategy and volatility data.
  * 
  * This function determines which stocks to buy or sell and calculates the funds 
  * available for reallocation based on a chosen investment strategy and stock volatility.
  * 
+ * Volatility columns may be stored as float or double (see precision::storage_t); each value is widened to double
+ * before it is compared with the thresholds.
+ *
  * @param stocks A map of stock tickers to their volatility vectors over time.
  * @param my_portfolio A reference to the current portfolio, mapping stock tickers to invested amounts.
  * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+ * @param threshold_scales A map of stock tickers to per-hour threshold multipliers (e.g. from a regime detector).
+ * Stocks or hours missing from the map use the fixed thresholds.
  * @return A Stock_Manager_Result object containing the buying, selling decisions, and reallocation funds.
  */
+template <typename T>
 Stock_Manager_Result stock_manager(
-    const std::map<std::string, std::vector<double>>& stocks,
+    const std::map<std::string, std::vector<T>>& stocks,
     std::map<std::string, double>& my_portfolio,
-    const std::string& strategy) {
+    const std::string& strategy,
+    const std::map<std::string, std::vector<double>>& threshold_scales) {
     
     Stock_Manager_Result result;
 
@@ -88,56 +167,28 @@ Stock_Manager_Result stock_manager(
 
         for (const auto& [stock, volatility_values] : stocks) {
             double& invested_money = my_portfolio[stock];
-            double adjustment = 0.0;
 
             // Get the volatility for the current hour, defaulting to the last value if out of bounds
-            double avg_volatility = hour < volatility_values.size() ? volatility_values[hour] : volatility_values.back();
-
-                // Adjustments based on the strategy and average volatility
-                if (strategy == "optimistic") {
-                    // "Optimistic" strategy focuses on more buying opportunities, even at higher volatility.
-                    if (avg_volatility <= 0.0025) {
-                        buying_stocks_hour.push_back(stock); // Strong buy
-                    } else if (avg_volatility <= 0.004) {
-                        buying_stocks_hour.push_back(stock); // Moderate buy
-                    } else {
-                        // Very high volatility; sell a portion of the stock to free up funds
-                        adjustment = -invested_money * 0.05; // Light sell
-                        reallocation_funds_hour -= adjustment; // Add funds
-                        selling_stocks_hour.push_back(stock);
-                    }
-                } else if (strategy == "neutral") {
-                    // "Neutral" strategy balances between buying and selling.
-                    if (avg_volatility > 0.004) {
-                        adjustment = -invested_money * 0.03; // Light sell for higher volatility
-                        reallocation_funds_hour -= adjustment; // Free up funds
-                        selling_stocks_hour.push_back(stock);
-                    } else if (avg_volatility > 0.003) {
-                        // Moderate volatility; no action or slight buy
-                        buying_stocks_hour.push_back(stock);
-                    } else {
-                        // Low volatility; slight buy
-                        buying_stocks_hour.push_back(stock);
-                    }
-                } else if (strategy == "conservative") {
-                    // "Conservative" strategy is cautious about high volatility.
-                    if (avg_volatility > 0.004) {
-                        adjustment = -invested_money * 0.1; // Strong sell for very high volatility
-                        reallocation_funds_hour -= adjustment; // Free up significant funds
-                        selling_stocks_hour.push_back(stock);
-                    } else if (avg_volatility > 0.0035) {
-                        adjustment = -invested_money * 0.05; // Moderate sell
-                        reallocation_funds_hour -= adjustment;
-                        selling_stocks_hour.push_back(stock);
-                    } else {
-                        // Low volatility; slight buy
-                        buying_stocks_hour.push_back(stock);
-                    }
-                }
-                
+            double avg_volatility =
+                hour < volatility_values.size() ? volatility_values[hour] : volatility_values.back();
+
+            // Threshold multiplier for this stock and hour, 1.0 if none was given
+            double threshold_scale = 1.0;
+            auto scales = threshold_scales.find(stock);
+            if (scales != threshold_scales.end() && hour < scales->second.size()) {
+                threshold_scale = scales->second[hour];
+            }
+
+            Stock_Decision decision = decide_stock(avg_volatility, invested_money, strategy, threshold_scale);
+            if (decision.buy) {
+                buying_stocks_hour.push_back(stock);
+            } else if (decision.sell) {
+                reallocation_funds_hour -= decision.adjustment; // Add funds
+                selling_stocks_hour.push_back(stock);
+            }
 
             // Update the portfolio based on adjustment
-            invested_money += adjustment;
+            invested_money += decision.adjustment;
         }
 
         // Save results for this hour
@@ -147,4 +198,20 @@ Stock_Manager_Result stock_manager(
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Manages stock buying and selling decisions with the fixed volatility thresholds.
+ * 
+ * @param stocks A map of stock tickers to their volatility vectors over time.
+ * @param my_portfolio A reference to the current portfolio, mapping stock tickers to invested amounts.
+ * @param strategy The investment strategy ("optimistic", "neutral", or "conservative").
+ * @return A Stock_Manager_Result object containing the buying, selling decisions, and reallocation funds.
+ */
+template <typename T>
+Stock_Manager_Result stock_manager(
+    const std::map<std::string, std::vector<T>>& stocks,
+    std::map<std::string, double>& my_portfolio,
+    const std::string& strategy) {
+    return stock_manager(stocks, my_portfolio, strategy, {});
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Thread_Pool
+ * @brief Persistent pool of worker threads that runs batches of indexed tasks.
+ *
+ * The threads are started once and sleep between batches, so a batch costs one wake-up instead of a thread start per
+ * task. The calling thread works on the batch too, and run() only returns once every task is finished, which makes each
+ * call a barrier. Tasks are handed out through an atomic counter, so uneven tasks balance themselves.
+ */
+class Thread_Pool {
+  public:
+    /**
+     * @param threads Total threads working on a batch, including the caller. 0 uses the hardware concurrency.
+     */
+    explicit Thread_Pool(size_t threads = 0);
+    ~Thread_Pool();
+
+    Thread_Pool(const Thread_Pool &) = delete;
+    Thread_Pool &operator=(const Thread_Pool &) = delete;
+
+    /**
+     * @brief Number of threads working on a batch, including the caller.
+     */
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Runs task(0) .. task(tasks - 1) across the pool and waits for all of them.
+     *
+     * Tasks must not throw and must not call run() on the same pool.
+     */
+    void run(size_t tasks, const std::function<void(size_t)> &task);
+
+  private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t)> *task_ = nullptr;
+    size_t tasks_ = 0;
+    std::atomic<size_t> next_{ 0 };
+    size_t active_ = 0;       // Workers still draining the current batch
+    uint64_t generation_ = 0; // Incremented for every batch
+    bool stop_ = false;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace calendar {
+
+    /**
+     * @brief Returned by the parsers for a string that is not a valid timestamp.
+     */
+    constexpr int64_t kInvalidTime = std::numeric_limits<int64_t>::min();
+
+    /**
+     * @brief Returned by Session_Calendar::hourIndex for a time outside every session.
+     */
+    constexpr size_t kNoSession = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Days since 1970-01-01 of a proleptic Gregorian date. Pure arithmetic, no time zone.
+     */
+    int64_t daysFromCivil(int year, unsigned month, unsigned day);
+
+    /**
+     * @brief Inverse of daysFromCivil.
+     */
+    void civilFromDays(int64_t days, int &year, unsigned &month, unsigned &day);
+
+    /**
+     * @brief Day of the week of a day number, 0 = Sunday.
+     */
+    unsigned weekday(int64_t days);
+
+    /**
+     * @brief Parses an ISO-8601 timestamp into seconds since the Unix epoch, in UTC.
+     *
+     * Accepts "YYYY-MM-DD", optionally followed by 'T' or ' ' and "HH:MM", ":SS" and a fraction (truncated), and then
+     * optionally 'Z' or a "+HH:MM" / "-HH:MM" offset. Without an offset the time is taken as UTC. Never allocates,
+     * never touches the locale or the local time zone.
+     *
+     * @return The epoch seconds, or kInvalidTime if the text is not a valid timestamp.
+     */
+    int64_t parseIso8601(std::string_view text);
+
+    /**
+     * @brief Parses many timestamps. out must have room for texts.size() values.
+     *
+     * @return The number of texts that parsed; the others are set to kInvalidTime.
+     */
+    size_t parseIso8601Batch(const std::vector<std::string_view> &texts, int64_t *out);
+
+    /**
+     * @struct Exchange_Config
+     * @brief Trading hours of an exchange, in its local time.
+     *
+     * Defaults describe US equities: 09:30 to 16:00 New York time with US daylight saving, hourly bars starting on the
+     * half hour (the last one is 30 minutes long), as Yahoo Finance reports them.
+     */
+    struct Exchange_Config {
+        int utc_offset_minutes = -300;        // Standard (winter) offset from UTC
+        bool us_daylight_saving = true;       // Add one hour under the US daylight saving rule of each year
+        int open_minutes = 9 * 60 + 30;       // Session open, minutes after local midnight
+        int close_minutes = 16 * 60;          // Session close, minutes after local midnight
+        int early_close_minutes = 13 * 60;    // Session close on early close days
+        int bar_minutes = 60;                 // Bar length
+        std::vector<int64_t> holidays;        // Closed weekdays, as day numbers (see daysFromCivil)
+        std::vector<int64_t> early_closes;    // Days that close at early_close_minutes, as day numbers
+    };
+
+    /**
+     * @brief True if US daylight saving is in effect on that day.
+     *
+     * From 2007: second Sunday of March to first Sunday of November. 1987 to 2006: first Sunday of April to last
+     * Sunday of October. Before 1987: last Sunday of April to last Sunday of October (the 1974-1975 emergency
+     * schedule is not modelled).
+     */
+    bool isUsDaylightSaving(int64_t day);
+
+    /**
+     * @brief NYSE full-day holidays of a year, as day numbers: New Year's Day, Martin Luther King Jr. Day, Washington's
+     * Birthday, Good Friday, Memorial Day, Juneteenth (from 2022), Independence Day, Labor Day, Thanksgiving and
+     * Christmas, with the usual weekend observance rules.
+     */
+    std::vector<int64_t> usEquityHolidays(int year);
+
+    /**
+     * @brief NYSE 13:00 early closes of a year, as day numbers: July 3 and Christmas Eve when they are trading
+     * weekdays, and the day after Thanksgiving.
+     */
+    std::vector<int64_t> usEquityEarlyCloses(int year);
+
+    /**
+     * @class Session_Calendar
+     * @brief Trading sessions of one exchange over a range of days, and the global index of every session hour.
+     *
+     * Construction walks the days once and stores, per day, the UTC open time and the index of its first bar. After
+     * that, hourIndex() maps any timestamp to its session hour with one division and two table reads, O(1), and
+     * barStart() maps an index back to a timestamp.
+     */
+    class Session_Calendar {
+      public:
+        /**
+         * @param first_day First day covered (day number).
+         * @param last_day Last day covered (day number, inclusive).
+         * @param config Trading hours and holidays.
+         */
+        Session_Calendar(int64_t first_day, int64_t last_day, const Exchange_Config &config = Exchange_Config());
+
+        /**
+         * @brief Calendar between two "YYYY-MM-DD" dates (inclusive) with the NYSE holidays and early closes of those
+         * years. Empty if either date does not parse.
+         */
+        static Session_Calendar usEquities(std::string_view first_date, std::string_view last_date);
+
+        /**
+         * @brief Index of the session hour that contains the timestamp, or kNoSession outside trading hours.
+         */
+        size_t hourIndex(int64_t epoch_seconds) const;
+
+        /**
+         * @brief UTC start of a session hour.
+         */
+        int64_t barStart(size_t index) const { return bar_starts_[index]; }
+
+        /**
+         * @brief Number of session hours in the calendar.
+         */
+        size_t hours() const { return bar_starts_.size(); }
+
+        /**
+         * @brief True if the exchange trades on that day.
+         */
+        bool isTradingDay(int64_t day) const;
+
+        /**
+         * @brief Places prices on the session-hour grid.
+         *
+         * Each price goes to the hour of its timestamp; hours with no bar repeat the previous price, and hours before
+         * the first bar are NaN. Prices outside every session are dropped.
+         *
+         * @param timestamps Epoch seconds of each price, ascending.
+         * @param prices Prices, one per timestamp.
+         * @return One price per session hour.
+         */
+        std::vector<double> align(const std::vector<int64_t> &timestamps, const std::vector<double> &prices) const;
+
+      private:
+        struct Day {
+            int64_t open = 0;              // UTC open of the session
+            uint32_t first_bar = 0;        // Index of the day's first bar
+            uint32_t session_seconds = 0;  // Length of the session, shorter on early close days
+            uint16_t bars = 0;             // Bars in the day, 0 when closed
+        };
+
+        int64_t first_day_ = 0;
+        int local_offset_seconds_ = 0; // Standard offset, used to find the local day of a timestamp
+        int64_t bar_seconds_ = 3600;
+        std::vector<Day> days_;
+        std::vector<int64_t> bar_starts_;
+    };
+
+} // namespace calendar
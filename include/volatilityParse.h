@@ -30,4 +30,28 @@ namespace volParsing {
      */
     std::map<std::string, std::vector<double>> true_volatility(std::map<std::string, std::vector<double>> input_map,
                                                                std::map<std::string, double> standard_ticker_vol_map);
+
+    /**
+     * @struct Volatility_State
+     * @brief Per-ticker state for computing the true volatility one price at a time.
+     */
+    struct Volatility_State {
+        std::vector<double> warmup_prices; // First 6 prices, used for the initial volatility
+        double last_price = 0.0;           // Most recent price seen
+        double volatility = 0.0;           // Current EWMA volatility (valid once count > 6)
+        size_t count = 0;                  // Number of prices seen so far
+    };
+
+    /**
+     * @brief Feeds one new price into a ticker's volatility state.
+     *
+     * Produces exactly the same sequence as tickerToVolHourly followed by true_volatility: the first 6 prices seed
+     * the initial volatility, and every later price applies one EWMA update.
+     *
+     * @param state The ticker's running state.
+     * @param price The new price.
+     * @param lambda The EWMA decay factor.
+     * @return True if a new volatility value was produced (state.volatility is then the latest one).
+     */
+    bool push_price(Volatility_State &state, double price, double lambda = 0.94);
 } // namespace volParsing
@@ -0,0 +1,310 @@
+#include "incrementalEngine.h"
+#include "portfolio_manager.h"
+#include "rangeIndex.h"
+#include "regimeDetector.h"
+#include "riskMetrics.h"
+#include "stock_manager.h"
+#include "volatilityFormula.h"
+#include "volatilityParse.h"
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+// The GIL is released only around pure functions of their arguments. Methods that change an IncrementalEngine or a
+// RangeIndex keep it, so two Python threads sharing one object cannot run them at the same time.
+
+namespace {
+
+    // forcecast only copies when the caller passes another dtype or a non-contiguous array; float64 C-contiguous
+    // arrays are read in place through the buffer protocol
+    using Array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+    using Series_Map = std::map<std::string, std::vector<double>>;
+
+    struct View {
+        const double *data;
+        size_t size;
+    };
+
+    View view(const Array &array) {
+        if (array.ndim() != 1) {
+            throw py::value_error("expected a 1-D array");
+        }
+        return View{ array.data(), static_cast<size_t>(array.shape(0)) };
+    }
+
+    std::vector<double> toVector(const Array &array) {
+        View v = view(array);
+        return std::vector<double>(v.data, v.data + v.size);
+    }
+
+    // Hands a vector to NumPy without copying: the array keeps the vector alive through a capsule
+    Array toArray(std::vector<double> &&values) {
+        auto owned = std::make_unique<std::vector<double>>(std::move(values));
+        py::capsule owner(owned.get(), [](void *p) { delete static_cast<std::vector<double> *>(p); });
+        std::vector<double> *vector = owned.release();
+        return Array(static_cast<py::ssize_t>(vector->size()), vector->data(), owner);
+    }
+
+    // The managers take std::map<std::string, std::vector<double>>, so their inputs are copied once here
+    Series_Map toSeries(const py::dict &series) {
+        Series_Map result;
+        for (const auto &item : series) {
+            result[py::cast<std::string>(item.first)] = toVector(py::cast<Array>(item.second));
+        }
+        return result;
+    }
+
+    py::dict toDict(Series_Map &&series) {
+        py::dict result;
+        for (auto &[ticker, values] : series) {
+            result[py::str(ticker)] = toArray(std::move(values));
+        }
+        return result;
+    }
+
+    // --- volFormula ---
+
+    Array logReturns(const Array &prices) {
+        std::vector<double> p = toVector(prices);
+        std::vector<double> returns;
+        if (p.size() > 1) { // logarithmicReturnFunction reads one past an empty vector
+            py::gil_scoped_release release;
+            returns = volFormula::logarithmicReturnFunction(p);
+        }
+        return toArray(std::move(returns));
+    }
+
+    double volatility(const Array &prices) {
+        std::vector<double> p = toVector(prices);
+        if (p.size() < 3) {
+            throw py::value_error("volatility needs at least 3 prices");
+        }
+        py::gil_scoped_release release;
+        return volFormula::volatilityAlgorithm(p);
+    }
+
+    // --- Volatility engines ---
+
+    Array trueVolatility(const Array &prices, double lambda) {
+        View p = view(prices);
+        size_t n = p.size > 6 ? p.size - 6 : 0;
+        Array out(static_cast<py::ssize_t>(n));
+        double *o = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            volParsing::Volatility_State state;
+            size_t k = 0;
+            for (size_t i = 0; i < p.size; ++i) {
+                if (volParsing::push_price(state, p.data[i], lambda)) {
+                    o[k++] = state.volatility;
+                }
+            }
+        }
+        return out;
+    }
+
+    py::dict trueVolatilityMap(const py::dict &prices, double lambda) {
+        py::dict result;
+        for (const auto &item : prices) {
+            result[item.first] = trueVolatility(py::cast<Array>(item.second), lambda);
+        }
+        return result;
+    }
+
+    Array percentageChanges(const Array &prices) {
+        std::vector<double> p = toVector(prices);
+        std::vector<double> changes;
+        {
+            py::gil_scoped_release release;
+            changes = series_percentage_changes(p);
+        }
+        return toArray(std::move(changes));
+    }
+
+    // --- Managers ---
+
+    py::tuple stockManager(const py::dict &volatility, std::map<std::string, double> my_portfolio,
+                           const std::string &strategy, const py::dict &threshold_scales) {
+        Series_Map stocks = toSeries(volatility);
+        Series_Map scales = toSeries(threshold_scales);
+        Stock_Manager_Result result;
+        {
+            py::gil_scoped_release release;
+            result = stock_manager(stocks, my_portfolio, strategy, scales);
+        }
+        py::dict out;
+        out["buying_stocks"] = result.buying_stocks;
+        out["selling_stocks"] = result.selling_stocks;
+        out["reallocation_funds"] = toArray(std::move(result.reallocation_funds));
+        return py::make_tuple(out, my_portfolio);
+    }
+
+    py::tuple portfolioManager(const std::vector<std::vector<std::string>> &buying_stocks,
+                               const Array &reallocation_funds, std::map<std::string, double> my_portfolio,
+                               const std::string &strategy, const py::dict &volatility,
+                               const py::dict &percentage_changes, const metrics::Metrics_Config &metrics_config,
+                               const Selection_Config &selection) {
+        std::vector<double> funds = toVector(reallocation_funds);
+        Series_Map stocks = toSeries(volatility);
+        Series_Map changes = toSeries(percentage_changes);
+        Portfolio_Manager_Result result;
+        {
+            py::gil_scoped_release release;
+            result = portfolio_manager(buying_stocks, funds, my_portfolio, strategy, stocks, changes, metrics_config,
+                                       selection);
+        }
+        py::dict out;
+        out["allocations"] = result.allocations;
+        out["portfolio_values"] = result.portfolio_values;
+        out["metrics"] = result.metrics;
+        out["unallocated_funds"] = result.unallocated_funds;
+        return py::make_tuple(out, my_portfolio);
+    }
+
+    // --- RangeIndex ---
+
+    template <double (rangeIndex::Range_Index::*Query)(size_t, size_t) const>
+    double rangeQuery(const rangeIndex::Range_Index &index, py::ssize_t begin, py::ssize_t end) {
+        if (begin < 0 || end < 0) {
+            throw py::value_error("range bounds must not be negative");
+        }
+        return (index.*Query)(static_cast<size_t>(begin), static_cast<size_t>(end));
+    }
+
+} // namespace
+
+PYBIND11_MODULE(pyvolatility, m) {
+    m.doc() = "NumPy bindings for the volatility library";
+
+    // A ticker missing from a map surfaces as std::out_of_range from std::map::at
+    py::register_exception_translator([](std::exception_ptr error) {
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        } catch (const std::out_of_range &e) {
+            PyErr_SetString(PyExc_KeyError, e.what());
+        }
+    });
+
+    // volFormula
+    m.def("update_volatility", &volFormula::update_volatility, py::arg("old_volatility"), py::arg("new_price"),
+          py::arg("old_price"), py::arg("lambda_") = 0.94, "One EWMA volatility update.");
+    m.def("log_returns", &logReturns, py::arg("prices"), "Logarithmic returns of a price array.");
+    m.def("volatility", &volatility, py::arg("prices"), "Sample volatility of the log returns of a price array.");
+
+    // Volatility engines
+    m.def("true_volatility", &trueVolatility, py::arg("prices"), py::arg("lambda_") = 0.94,
+          "EWMA volatility of one price array, seeded from its first 6 prices (as true_volatility).");
+    m.def("true_volatility_map", &trueVolatilityMap, py::arg("prices"), py::arg("lambda_") = 0.94,
+          "true_volatility for every array of a {ticker: prices} dict.");
+    m.def("percentage_changes", &percentageChanges, py::arg("prices"),
+          "Percentage change between consecutive prices (as calculate_percentage_changes).");
+    m.def(
+        "threshold_scales",
+        [](const py::dict &volatility) {
+            Series_Map series = toSeries(volatility);
+            Series_Map scales;
+            {
+                py::gil_scoped_release release;
+                scales = regime::thresholdScales(series);
+            }
+            return toDict(std::move(scales));
+        },
+        py::arg("volatility"), "Per-hour stock_manager threshold multipliers from the regime detector.");
+
+    // Manager settings and results
+    py::class_<metrics::Metrics_Config>(m, "MetricsConfig", "Annualization and tail settings of the metrics.")
+        .def(py::init<>())
+        .def_readwrite("periods_per_year", &metrics::Metrics_Config::periods_per_year)
+        .def_readwrite("risk_free_rate", &metrics::Metrics_Config::risk_free_rate)
+        .def_readwrite("var_confidence", &metrics::Metrics_Config::var_confidence)
+        .def_readwrite("tail_metrics", &metrics::Metrics_Config::tail_metrics);
+
+    py::class_<metrics::Metrics_Summary>(m, "MetricsSummary", "Risk and performance figures of a run.")
+        .def_readonly("bars", &metrics::Metrics_Summary::bars)
+        .def_readonly("last_value", &metrics::Metrics_Summary::last_value)
+        .def_readonly("peak_value", &metrics::Metrics_Summary::peak_value)
+        .def_readonly("current_drawdown", &metrics::Metrics_Summary::current_drawdown)
+        .def_readonly("max_drawdown", &metrics::Metrics_Summary::max_drawdown)
+        .def_readonly("total_return", &metrics::Metrics_Summary::total_return)
+        .def_readonly("mean_return", &metrics::Metrics_Summary::mean_return)
+        .def_readonly("realized_volatility", &metrics::Metrics_Summary::realized_volatility)
+        .def_readonly("sharpe", &metrics::Metrics_Summary::sharpe)
+        .def_readonly("sortino", &metrics::Metrics_Summary::sortino)
+        .def_readonly("traded", &metrics::Metrics_Summary::traded)
+        .def_readonly("turnover", &metrics::Metrics_Summary::turnover)
+        .def_readonly("value_at_risk", &metrics::Metrics_Summary::value_at_risk)
+        .def_readonly("expected_shortfall", &metrics::Metrics_Summary::expected_shortfall);
+
+    py::class_<Selection_Config>(m, "SelectionConfig", "Candidate limit and minimum ticket of portfolio_manager.")
+        .def(py::init([](size_t top_k, double min_ticket) { return Selection_Config{ top_k, min_ticket }; }),
+             py::arg("top_k") = 0, py::arg("min_ticket") = 0.0)
+        .def_readwrite("top_k", &Selection_Config::top_k)
+        .def_readwrite("min_ticket", &Selection_Config::min_ticket);
+
+    // Managers
+    m.def("stock_manager", &stockManager, py::arg("volatility"), py::arg("portfolio"), py::arg("strategy"),
+          py::arg("threshold_scales") = py::dict(),
+          "Runs stock_manager. Returns (result dict, updated portfolio).");
+    m.def("portfolio_manager", &portfolioManager, py::arg("buying_stocks"), py::arg("reallocation_funds"),
+          py::arg("portfolio"), py::arg("strategy"), py::arg("volatility"), py::arg("percentage_changes"),
+          py::arg("metrics_config") = metrics::Metrics_Config(), py::arg("selection") = Selection_Config(),
+          "Runs portfolio_manager. Returns (result dict with allocations, portfolio_values, metrics and "
+          "unallocated_funds, updated portfolio).");
+
+    // Range queries
+    py::class_<rangeIndex::Range_Index>(m, "RangeIndex", "Window statistics over one series.")
+        .def(py::init([](const Array &values) { return rangeIndex::Range_Index(toVector(values)); }),
+             py::arg("values"))
+        .def("append", &rangeIndex::Range_Index::append, py::arg("value"), "Appends one value to the series.")
+        .def("sum", &rangeQuery<&rangeIndex::Range_Index::sum>, py::arg("begin"), py::arg("end"),
+             "Sum over [begin, end).")
+        .def("mean", &rangeQuery<&rangeIndex::Range_Index::mean>, py::arg("begin"), py::arg("end"),
+             "Mean over [begin, end).")
+        .def("variance", &rangeQuery<&rangeIndex::Range_Index::variance>, py::arg("begin"), py::arg("end"),
+             "Sample variance over [begin, end).")
+        .def("min", &rangeQuery<&rangeIndex::Range_Index::min>, py::arg("begin"), py::arg("end"),
+             "Minimum over [begin, end).")
+        .def("max", &rangeQuery<&rangeIndex::Range_Index::max>, py::arg("begin"), py::arg("end"),
+             "Maximum over [begin, end).")
+        .def("__len__", &rangeIndex::Range_Index::size);
+
+    // Incremental engine with checkpoints
+    py::class_<incremental::Engine_State>(m, "IncrementalEngine",
+                                          "Incremental engine that continues a run from checkpoints.")
+        .def(py::init(&incremental::start), py::arg("strategy"), py::arg("portfolio"))
+        .def(
+            "advance",
+            [](incremental::Engine_State &state, const py::dict &new_bars) {
+                incremental::advance(state, toSeries(new_bars));
+            },
+            py::arg("new_bars"), "Processes a {ticker: prices} batch of new bars.")
+        .def(
+            "save",
+            [](const incremental::Engine_State &state, const std::string &path) {
+                return incremental::saveCheckpoint(path, state);
+            },
+            py::arg("path"), "Writes a checkpoint. Returns True on success.")
+        .def_static(
+            "load",
+            [](const std::string &path) {
+                incremental::Engine_State state;
+                if (!incremental::loadCheckpoint(path, state)) {
+                    throw py::value_error("could not load checkpoint " + path);
+                }
+                return state;
+            },
+            py::arg("path"), "Reads a checkpoint written by save.")
+        .def_readonly("strategy", &incremental::Engine_State::strategy)
+        .def_readonly("hours_processed", &incremental::Engine_State::hours_processed)
+        .def_readonly("portfolio", &incremental::Engine_State::portfolio);
+}
@@ -0,0 +1,522 @@
+#include "backtestService.h"
+#include "pipeline.h"
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace service {
+
+    namespace {
+
+        constexpr uint32_t kRequestMagic = 0x51544256; // "VBTQ"
+        constexpr uint32_t kUnknownStrategyCode = 0xFF;
+        constexpr uint32_t kMaxTickers = 1 << 16;
+
+        const char *const kStrategies[] = { "optimistic", "neutral", "conservative" };
+
+        struct Request_Header {
+            uint32_t magic;
+            uint32_t strategy; // Index into kStrategies
+            double capital;
+            int64_t begin_time;
+            int64_t end_time;
+            uint32_t ticker_count;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(Request_Header) == 40, "request header layout");
+
+        struct Response_Header {
+            uint32_t status;
+            uint32_t holding_count;
+            uint64_t begin_hour;
+            uint64_t end_hour;
+            double initial_value;
+            double final_value;
+            double max_drawdown;
+            double total_return;
+            double realized_volatility;
+            double sharpe;
+            double sortino;
+            double turnover;
+            double value_at_risk;
+            double expected_shortfall;
+            uint64_t compute_ns;
+        };
+        static_assert(sizeof(Response_Header) == 112, "response header layout");
+
+        bool writeAll(int fd, const void *data, size_t size) {
+            const char *bytes = static_cast<const char *>(data);
+            while (size > 0) {
+                ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        bool readAll(int fd, void *data, size_t size) {
+            char *bytes = static_cast<char *>(data);
+            while (size > 0) {
+                ssize_t received = ::recv(fd, bytes, size, 0);
+                if (received < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (received <= 0) {
+                    return false;
+                }
+                bytes += received;
+                size -= static_cast<size_t>(received);
+            }
+            return true;
+        }
+
+        bool makeAddress(const std::string &path, sockaddr_un &address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                std::cerr << "Socket path too long: " << path << std::endl;
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size());
+            return true;
+        }
+
+        // Strings on the wire are a uint16 length followed by the bytes
+        void appendString(std::vector<char> &buffer, const std::string &value) {
+            uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+            const char *length_bytes = reinterpret_cast<const char *>(&length);
+            buffer.insert(buffer.end(), length_bytes, length_bytes + sizeof(length));
+            buffer.insert(buffer.end(), value.data(), value.data() + length);
+        }
+
+        bool readString(int fd, std::string &value) {
+            uint16_t length = 0;
+            if (!readAll(fd, &length, sizeof(length))) {
+                return false;
+            }
+            value.resize(length);
+            return length == 0 || readAll(fd, &value[0], length);
+        }
+
+        uint32_t strategyCode(const std::string &strategy) {
+            auto found = std::find(std::begin(kStrategies), std::end(kStrategies), strategy);
+            return found == std::end(kStrategies) ? kUnknownStrategyCode
+                                                   : static_cast<uint32_t>(found - std::begin(kStrategies));
+        }
+
+        // Same slicing as the StageGraph manager stage, restricted to the requested tickers and read straight from
+        // the column views
+        std::map<std::string, std::vector<double>> sliceWindow(const Market_Data &data,
+                                                               const std::map<std::string, double> &portfolio,
+                                                               sharedData::Series Ticker_Columns::*column,
+                                                               size_t begin, size_t end, bool hold_last) {
+            std::map<std::string, std::vector<double>> sliced;
+            for (const auto &[ticker, value] : portfolio) {
+                auto found = data.columns.find(ticker);
+                if (found == data.columns.end()) {
+                    continue;
+                }
+                const sharedData::Series &series = found->second.*column;
+                std::vector<double> window = pipeline::sliceSeries(series.data, series.size, begin, end, hold_last);
+                if (!window.empty()) {
+                    sliced.emplace_hint(sliced.end(), ticker, std::move(window));
+                }
+            }
+            return sliced;
+        }
+
+        sharedData::Series viewOf(const std::map<std::string, std::vector<double>> &series, const std::string &ticker) {
+            auto found = series.find(ticker);
+            if (found == series.end()) {
+                return sharedData::Series();
+            }
+            return sharedData::Series{ found->second.data(), found->second.size() };
+        }
+
+    } // namespace
+
+    std::shared_ptr<const Market_Data> buildMarketData(const std::map<std::string, std::vector<double>> &prices,
+                                                       const std::vector<int64_t> &bar_starts) {
+        pipeline::StageGraph graph;
+        graph.setPrices(prices);
+
+        auto data = std::make_shared<Market_Data>();
+        data->prices = prices;
+        data->true_volatility = graph.trueVolatility();
+        data->percentage_changes = graph.percentageChanges();
+        data->hours = graph.hours();
+        for (const auto &[ticker, series] : data->prices) {
+            data->columns.emplace_hint(data->columns.end(), ticker,
+                                       Ticker_Columns{ viewOf(data->prices, ticker),
+                                                       viewOf(data->true_volatility, ticker),
+                                                       viewOf(data->percentage_changes, ticker) });
+        }
+
+        size_t price_hours = 0;
+        for (const auto &[ticker, series] : prices) {
+            price_hours = std::max(price_hours, series.size());
+        }
+        // Volatility starts after the warm-up prices, so manager hour h belongs to price bar h + offset
+        size_t offset = price_hours - std::min(price_hours, data->hours);
+        for (size_t hour = 0; hour < data->hours && hour + offset < bar_starts.size(); ++hour) {
+            data->hour_starts.push_back(bar_starts[hour + offset]);
+        }
+        return data;
+    }
+
+    std::shared_ptr<const Market_Data> buildMarketData(const sharedData::MarketView &view) {
+        auto data = std::make_shared<Market_Data>();
+        for (size_t i = 0; i < view.tickerCount(); ++i) {
+            Ticker_Columns columns{ view.prices(i), view.volatility(i), view.percentageChanges(i) };
+            data->hours = std::max(data->hours, columns.volatility.size);
+            data->columns.emplace(view.ticker(i), columns);
+        }
+        return data;
+    }
+
+    const char *statusName(Status status) {
+        switch (status) {
+        case Status::Ok:
+            return "ok";
+        case Status::BadRequest:
+            return "bad request";
+        case Status::UnknownStrategy:
+            return "unknown strategy";
+        case Status::UnknownTicker:
+            return "unknown ticker";
+        case Status::EmptyWindow:
+            return "empty window";
+        }
+        return "unknown";
+    }
+
+    Backtest_Response runBacktest(const Market_Data &data, const Backtest_Request &request) {
+        Backtest_Response response;
+        if (!std::isfinite(request.capital) || request.capital <= 0) {
+            response.status = Status::BadRequest;
+            return response;
+        }
+        if (strategyCode(request.strategy) == kUnknownStrategyCode) {
+            response.status = Status::UnknownStrategy;
+            return response;
+        }
+
+        // Date window to manager hours
+        bool timed = request.begin_time != 0 || request.end_time != 0;
+        if (timed && data.hour_starts.empty()) {
+            response.status = Status::EmptyWindow;
+            return response;
+        }
+        const std::vector<int64_t> &starts = data.hour_starts;
+        size_t begin = request.begin_time == 0
+                           ? 0
+                           : std::lower_bound(starts.begin(), starts.end(), request.begin_time) - starts.begin();
+        size_t end = request.end_time == 0
+                         ? data.hours
+                         : std::lower_bound(starts.begin(), starts.end(), request.end_time) - starts.begin();
+        if (begin >= end) {
+            response.status = Status::EmptyWindow;
+            return response;
+        }
+
+        // Starting portfolio, split equally like create_portfolio
+        std::map<std::string, double> portfolio;
+        if (request.tickers.empty()) {
+            for (const auto &[ticker, columns] : data.columns) {
+                portfolio.emplace_hint(portfolio.end(), ticker, 0.0);
+            }
+        } else {
+            for (const auto &ticker : request.tickers) {
+                if (data.columns.find(ticker) == data.columns.end()) {
+                    response.status = Status::UnknownTicker;
+                    return response;
+                }
+                portfolio[ticker] = 0.0;
+            }
+        }
+        for (auto &[ticker, value] : portfolio) {
+            value = request.capital / portfolio.size();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::map<std::string, std::vector<double>> vol_window =
+            sliceWindow(data, portfolio, &Ticker_Columns::volatility, begin, end, true);
+        std::map<std::string, std::vector<double>> pct_window =
+            sliceWindow(data, portfolio, &Ticker_Columns::percentage_changes, begin, end, false);
+
+        response.initial_value = portfolio_value(portfolio);
+        Stock_Manager_Result stock_result = stock_manager(vol_window, portfolio, request.strategy);
+        Portfolio_Manager_Result portfolio_result =
+            portfolio_manager(stock_result.buying_stocks, stock_result.reallocation_funds, portfolio, request.strategy,
+                              vol_window, pct_window);
+        response.compute_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        response.begin_hour = begin;
+        response.end_hour = end;
+        response.final_value = portfolio_value(portfolio);
+        response.metrics = portfolio_result.metrics;
+        response.final_portfolio = std::move(portfolio);
+        return response;
+    }
+
+    // ---------------------------------------------------------------------
+    // Daemon
+    // ---------------------------------------------------------------------
+
+    Backtest_Daemon::Backtest_Daemon(std::shared_ptr<const Market_Data> data) : data_(std::move(data)) {}
+
+    Backtest_Daemon::~Backtest_Daemon() { stop(); }
+
+    bool Backtest_Daemon::start(const Daemon_Config &config) {
+        sockaddr_un address;
+        if (listener_ >= 0 || !data_ || !makeAddress(config.socket_path, address)) {
+            return false;
+        }
+
+        listener_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener_ < 0) {
+            std::cerr << "Failed to create socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        ::unlink(config.socket_path.c_str());
+        if (::bind(listener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listener_, SOMAXCONN) != 0) {
+            std::cerr << "Failed to listen on " << config.socket_path << ": " << std::strerror(errno) << std::endl;
+            ::close(listener_);
+            listener_ = -1;
+            return false;
+        }
+        socket_path_ = config.socket_path;
+        io_timeout_ms_ = config.io_timeout_ms;
+        idle_timeout_ms_ = config.idle_timeout_ms;
+
+        size_t workers = config.workers != 0 ? config.workers : std::max(1u, std::thread::hardware_concurrency());
+        stop_.store(false, std::memory_order_relaxed);
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back(&Backtest_Daemon::workerLoop, this);
+        }
+        return true;
+    }
+
+    void Backtest_Daemon::stop() {
+        if (listener_ < 0) {
+            return;
+        }
+        stop_.store(true, std::memory_order_release);
+        // Wakes every worker blocked in accept()
+        ::shutdown(listener_, SHUT_RDWR);
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+        ::close(listener_);
+        listener_ = -1;
+        ::unlink(socket_path_.c_str());
+    }
+
+    void Backtest_Daemon::workerLoop() {
+        while (!stop_.load(std::memory_order_acquire)) {
+            int client = ::accept(listener_, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                return;
+            }
+            // Reads and writes inside a message give up after the timeout, so a client that sends half a header or
+            // stops reading cannot hold the worker indefinitely
+            timeval timeout{ io_timeout_ms_ / 1000, (io_timeout_ms_ % 1000) * 1000 };
+            ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            serveConnection(client);
+            ::close(client);
+        }
+    }
+
+    void Backtest_Daemon::serveConnection(int client) {
+        std::vector<char> buffer;
+        auto idle_since = std::chrono::steady_clock::now();
+        while (true) {
+            // Wait for the next request in short slices, so an idle client does not hold a worker past shutdown
+            pollfd ready{ client, POLLIN, 0 };
+            int polled = ::poll(&ready, 1, 200);
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (polled == 0 || (polled < 0 && errno == EINTR)) {
+                // A client that stays silent gives its worker back to the clients waiting in the accept queue
+                if (idle_timeout_ms_ > 0 &&
+                    std::chrono::steady_clock::now() - idle_since >= std::chrono::milliseconds(idle_timeout_ms_)) {
+                    return;
+                }
+                continue;
+            }
+            Request_Header header;
+            if (polled < 0 || !readAll(client, &header, sizeof(header))) {
+                return;
+            }
+
+            Backtest_Request request;
+            Backtest_Response response;
+            bool valid = header.magic == kRequestMagic && header.ticker_count <= kMaxTickers;
+            if (valid) {
+                request.strategy = header.strategy < std::size(kStrategies) ? kStrategies[header.strategy] : "";
+                request.capital = header.capital;
+                request.begin_time = header.begin_time;
+                request.end_time = header.end_time;
+                request.tickers.resize(header.ticker_count);
+                for (auto &ticker : request.tickers) {
+                    if (!readString(client, ticker)) {
+                        return;
+                    }
+                }
+                response = runBacktest(*data_, request);
+            } else {
+                response.status = Status::BadRequest;
+            }
+
+            Response_Header out{};
+            out.status = static_cast<uint32_t>(response.status);
+            out.holding_count = static_cast<uint32_t>(response.final_portfolio.size());
+            out.begin_hour = response.begin_hour;
+            out.end_hour = response.end_hour;
+            out.initial_value = response.initial_value;
+            out.final_value = response.final_value;
+            out.max_drawdown = response.metrics.max_drawdown;
+            out.total_return = response.metrics.total_return;
+            out.realized_volatility = response.metrics.realized_volatility;
+            out.sharpe = response.metrics.sharpe;
+            out.sortino = response.metrics.sortino;
+            out.turnover = response.metrics.turnover;
+            out.value_at_risk = response.metrics.value_at_risk;
+            out.expected_shortfall = response.metrics.expected_shortfall;
+            out.compute_ns = response.compute_ns;
+
+            // One write per response
+            buffer.clear();
+            const char *header_bytes = reinterpret_cast<const char *>(&out);
+            buffer.insert(buffer.end(), header_bytes, header_bytes + sizeof(out));
+            for (const auto &[ticker, value] : response.final_portfolio) {
+                appendString(buffer, ticker);
+                const char *value_bytes = reinterpret_cast<const char *>(&value);
+                buffer.insert(buffer.end(), value_bytes, value_bytes + sizeof(value));
+            }
+            // Counted before the write, so a client holding the response also sees it in served()
+            served_.fetch_add(1, std::memory_order_relaxed);
+            if (!writeAll(client, buffer.data(), buffer.size())) {
+                return;
+            }
+
+            // After a malformed header the rest of the stream cannot be framed
+            if (!valid) {
+                return;
+            }
+            idle_since = std::chrono::steady_clock::now();
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Client
+    // ---------------------------------------------------------------------
+
+    Backtest_Client::~Backtest_Client() { close(); }
+
+    bool Backtest_Client::connect(const std::string &socket_path) {
+        close();
+        sockaddr_un address;
+        if (!makeAddress(socket_path, address)) {
+            return false;
+        }
+
+        // The daemon may still be loading its data, so retry for a couple of seconds
+        for (int attempt = 0; attempt < 200; ++attempt) {
+            fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd_ >= 0 && ::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) {
+                return true;
+            }
+            close();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::cerr << "Failed to connect to backtest daemon at " << socket_path << std::endl;
+        return false;
+    }
+
+    bool Backtest_Client::run(const Backtest_Request &request, Backtest_Response &response) {
+        if (fd_ < 0) {
+            return false;
+        }
+
+        Request_Header header{};
+        header.magic = kRequestMagic;
+        header.strategy = strategyCode(request.strategy);
+        header.capital = request.capital;
+        header.begin_time = request.begin_time;
+        header.end_time = request.end_time;
+        header.ticker_count = static_cast<uint32_t>(request.tickers.size());
+
+        std::vector<char> buffer;
+        const char *header_bytes = reinterpret_cast<const char *>(&header);
+        buffer.insert(buffer.end(), header_bytes, header_bytes + sizeof(header));
+        for (const auto &ticker : request.tickers) {
+            appendString(buffer, ticker);
+        }
+
+        Response_Header in;
+        if (!writeAll(fd_, buffer.data(), buffer.size()) || !readAll(fd_, &in, sizeof(in))) {
+            close();
+            return false;
+        }
+
+        response = Backtest_Response{};
+        response.status = static_cast<Status>(in.status);
+        response.begin_hour = in.begin_hour;
+        response.end_hour = in.end_hour;
+        response.initial_value = in.initial_value;
+        response.final_value = in.final_value;
+        response.metrics.max_drawdown = in.max_drawdown;
+        response.metrics.total_return = in.total_return;
+        response.metrics.realized_volatility = in.realized_volatility;
+        response.metrics.sharpe = in.sharpe;
+        response.metrics.sortino = in.sortino;
+        response.metrics.turnover = in.turnover;
+        response.metrics.value_at_risk = in.value_at_risk;
+        response.metrics.expected_shortfall = in.expected_shortfall;
+        response.compute_ns = in.compute_ns;
+        for (uint32_t i = 0; i < in.holding_count; ++i) {
+            std::string ticker;
+            double value = 0.0;
+            if (!readString(fd_, ticker) || !readAll(fd_, &value, sizeof(value))) {
+                close();
+                return false;
+            }
+            response.final_portfolio.emplace_hint(response.final_portfolio.end(), std::move(ticker), value);
+        }
+        return true;
+    }
+
+    void Backtest_Client::close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+} // namespace service
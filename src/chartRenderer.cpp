@@ -0,0 +1,663 @@
+#include "chartRenderer.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace chart {
+
+    std::vector<size_t> lttb(const std::vector<double> &x, const std::vector<double> &y, size_t threshold) {
+        size_t n = std::min(x.size(), y.size());
+        std::vector<size_t> kept;
+        if (threshold >= n || threshold < 3) {
+            kept.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                kept[i] = i;
+            }
+            return kept;
+        }
+
+        kept.reserve(threshold);
+        kept.push_back(0);
+
+        // Buckets cover points 1 .. n-2, the first and last points are always kept
+        double bucket_size = static_cast<double>(n - 2) / (threshold - 2);
+        size_t a = 0;
+
+        for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+            // Average of the next bucket (or the last point for the final bucket)
+            size_t next_start = static_cast<size_t>(std::floor((bucket + 1) * bucket_size)) + 1;
+            size_t next_end = std::min(static_cast<size_t>(std::floor((bucket + 2) * bucket_size)) + 1, n);
+            double avg_x = 0.0;
+            double avg_y = 0.0;
+            if (next_start >= next_end) {
+                avg_x = x[n - 1];
+                avg_y = y[n - 1];
+            } else {
+                for (size_t i = next_start; i < next_end; ++i) {
+                    avg_x += x[i];
+                    avg_y += y[i];
+                }
+                avg_x /= (next_end - next_start);
+                avg_y /= (next_end - next_start);
+            }
+
+            // Pick the point in this bucket with the largest triangle area
+            size_t start = static_cast<size_t>(std::floor(bucket * bucket_size)) + 1;
+            size_t end = std::min(static_cast<size_t>(std::floor((bucket + 1) * bucket_size)) + 1, n - 1);
+            double best_area = -1.0;
+            size_t best = start;
+            for (size_t i = start; i < end; ++i) {
+                double area = std::fabs((x[a] - avg_x) * (y[i] - y[a]) - (x[a] - x[i]) * (avg_y - y[a]));
+                if (area > best_area) {
+                    best_area = area;
+                    best = i;
+                }
+            }
+
+            kept.push_back(best);
+            a = best;
+        }
+
+        kept.push_back(n - 1);
+        return kept;
+    }
+
+    namespace {
+
+        struct Color {
+            uint8_t r, g, b;
+        };
+
+        // Tableau 10, then hues spaced by the golden angle, so every series of a chart gets its own color
+        const std::array<Color, 10> kPalette = { { { 31, 119, 180 },
+                                                   { 255, 127, 14 },
+                                                   { 44, 160, 44 },
+                                                   { 214, 39, 40 },
+                                                   { 148, 103, 189 },
+                                                   { 140, 86, 75 },
+                                                   { 227, 119, 194 },
+                                                   { 127, 127, 127 },
+                                                   { 188, 189, 34 },
+                                                   { 23, 190, 207 } } };
+
+        Color seriesColor(size_t index) {
+            if (index < kPalette.size()) {
+                return kPalette[index];
+            }
+            // HSV with saturation 0.65 and value 0.8
+            double hue = std::fmod((index - kPalette.size()) * 0.618033988749895, 1.0) * 6.0;
+            double chroma = 0.8 * 0.65;
+            double x = chroma * (1.0 - std::fabs(std::fmod(hue, 2.0) - 1.0));
+            double r = 0.0, g = 0.0, b = 0.0;
+            switch (static_cast<int>(hue)) {
+            case 0:
+                r = chroma, g = x;
+                break;
+            case 1:
+                r = x, g = chroma;
+                break;
+            case 2:
+                g = chroma, b = x;
+                break;
+            case 3:
+                g = x, b = chroma;
+                break;
+            case 4:
+                r = x, b = chroma;
+                break;
+            default:
+                r = chroma, b = x;
+                break;
+            }
+            double m = 0.8 - chroma;
+            auto channel = [m](double value) { return static_cast<uint8_t>(std::lround((value + m) * 255)); };
+            return Color{ channel(r), channel(g), channel(b) };
+        }
+
+        std::string hexColor(const Color &c) {
+            std::ostringstream out;
+            out << '#' << std::hex << std::setfill('0') << std::setw(2) << int(c.r) << std::setw(2) << int(c.g)
+                << std::setw(2) << int(c.b);
+            return out.str();
+        }
+
+        struct Layout {
+            double left, top, right, bottom; // Plot area in pixels
+            double x_min, x_max, y_min, y_max;
+
+            double px(double x) const { return left + (x - x_min) / (x_max - x_min) * (right - left); }
+            double py(double y) const { return bottom - (y - y_min) / (y_max - y_min) * (bottom - top); }
+        };
+
+        Layout makeLayout(const std::vector<Chart_Series> &series, const Chart_Options &options) {
+            Layout layout;
+            layout.left = 80;
+            layout.top = 50;
+            layout.right = static_cast<double>(options.width) - 180;
+            layout.bottom = static_cast<double>(options.height) - 60;
+            layout.x_min = layout.y_min = std::numeric_limits<double>::max();
+            layout.x_max = layout.y_max = std::numeric_limits<double>::lowest();
+            for (const auto &s : series) {
+                size_t n = std::min(s.x.size(), s.y.size());
+                for (size_t i = 0; i < n; ++i) {
+                    layout.x_min = std::min(layout.x_min, s.x[i]);
+                    layout.x_max = std::max(layout.x_max, s.x[i]);
+                    layout.y_min = std::min(layout.y_min, s.y[i]);
+                    layout.y_max = std::max(layout.y_max, s.y[i]);
+                }
+            }
+            if (layout.x_min > layout.x_max) {
+                layout.x_min = 0;
+                layout.x_max = 1;
+                layout.y_min = 0;
+                layout.y_max = 1;
+            }
+            if (layout.x_max == layout.x_min) {
+                layout.x_max = layout.x_min + 1;
+            }
+            if (layout.y_max == layout.y_min) {
+                layout.y_max = layout.y_min + 1;
+            }
+            return layout;
+        }
+
+        size_t pixelWidth(const Layout &layout) {
+            return static_cast<size_t>(std::max(3.0, layout.right - layout.left));
+        }
+
+        std::string escapeXml(const std::string &text) {
+            std::string out;
+            for (char c : text) {
+                if (c == '<') {
+                    out += "&lt;";
+                } else if (c == '>') {
+                    out += "&gt;";
+                } else if (c == '&') {
+                    out += "&amp;";
+                } else if (c == '"') {
+                    out += "&quot;";
+                } else {
+                    out += c;
+                }
+            }
+            return out;
+        }
+
+        std::string tickLabel(double value) {
+            std::ostringstream out;
+            out << std::setprecision(6) << value;
+            return out.str();
+        }
+
+        // 5x7 bitmap font for the PNG labels, one byte per row with the leftmost pixel in bit 4. Lowercase letters
+        // are drawn as capitals.
+        struct Glyph {
+            char c;
+            uint8_t rows[7];
+        };
+
+        const Glyph kFont[] = {
+            { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+            { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+            { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+            { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+            { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+            { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+            { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+            { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+            { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+            { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+            { 'A', { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 } },
+            { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+            { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+            { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+            { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+            { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+            { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+            { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+            { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+            { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+            { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+            { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+            { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+            { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+            { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+            { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+            { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+            { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+            { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+            { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+            { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+            { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+            { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+            { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+            { 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+            { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+            { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+            { ',', { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 } },
+            { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+            { '+', { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 } },
+            { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+            { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+            { '$', { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 } },
+            { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+            { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+            { '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+            { '_', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F } },
+            { '=', { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 } },
+        };
+
+        const uint8_t *glyphRows(char c) {
+            char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            for (const Glyph &glyph : kFont) {
+                if (glyph.c == upper) {
+                    return glyph.rows;
+                }
+            }
+            return nullptr; // Space and anything the font lacks
+        }
+
+        long textWidth(const std::string &text, long scale = 1) {
+            return text.empty() ? 0 : (static_cast<long>(text.size()) * 6 - 1) * scale;
+        }
+
+        // PNG helpers: CRC32 for chunks, Adler32 for the zlib stream
+        uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+            static std::array<uint32_t, 256> table = []() {
+                std::array<uint32_t, 256> t{};
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    t[i] = c;
+                }
+                return t;
+            }();
+            crc = ~crc;
+            for (size_t i = 0; i < size; ++i) {
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        void putU32(std::vector<uint8_t> &out, uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+            putU32(out, static_cast<uint32_t>(data.size()));
+            size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            putU32(out, crc32(out.data() + start, out.size() - start));
+        }
+
+        // Bit sink for deflate, which packs bits starting at the least significant bit of each byte
+        class Deflate_Writer {
+          public:
+            explicit Deflate_Writer(std::vector<uint8_t> &out) : out_(out) {}
+
+            void bits(uint32_t value, int count) {
+                buffer_ |= value << used_;
+                used_ += count;
+                while (used_ >= 8) {
+                    out_.push_back(static_cast<uint8_t>(buffer_));
+                    buffer_ >>= 8;
+                    used_ -= 8;
+                }
+            }
+
+            // Huffman codes go out most significant bit first
+            void code(uint32_t value, int count) {
+                uint32_t reversed = 0;
+                for (int i = 0; i < count; ++i) {
+                    reversed = (reversed << 1) | ((value >> i) & 1);
+                }
+                bits(reversed, count);
+            }
+
+            // A literal/length symbol in the fixed Huffman code
+            void symbol(uint32_t value) {
+                if (value < 144) {
+                    code(0x30 + value, 8);
+                } else if (value < 256) {
+                    code(0x190 + value - 144, 9);
+                } else if (value < 280) {
+                    code(value - 256, 7);
+                } else {
+                    code(0xC0 + value - 280, 8);
+                }
+            }
+
+            void flush() {
+                if (used_ > 0) {
+                    out_.push_back(static_cast<uint8_t>(buffer_));
+                }
+                buffer_ = 0;
+                used_ = 0;
+            }
+
+          private:
+            std::vector<uint8_t> &out_;
+            uint32_t buffer_ = 0;
+            int used_ = 0;
+        };
+
+        // One deflate block with the fixed Huffman codes and greedy LZ77 matches (RFC 1951). Filtered chart rows are
+        // mostly zeros, which become runs of 258-byte matches of a few bits each.
+        void deflate(const std::vector<uint8_t> &data, std::vector<uint8_t> &out) {
+            static const uint16_t kLengthBase[29] = { 3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const uint16_t kDistanceBase[30] = { 1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                                        33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                                        1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const uint8_t kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+            constexpr size_t kWindow = 32768;
+            constexpr size_t kMaxMatch = 258;
+            constexpr int kHashBits = 15;
+
+            Deflate_Writer writer(out);
+            writer.bits(1, 1); // Last block
+            writer.bits(1, 2); // Fixed Huffman codes
+
+            // Hash chains: the most recent position of every 3-byte prefix, and for each position the previous one
+            // with the same hash
+            constexpr int kMaxChain = 32;
+            std::vector<int64_t> head(size_t(1) << kHashBits, -1);
+            std::vector<int64_t> previous(kWindow, -1);
+            auto hash = [&](size_t i) {
+                uint32_t value = data[i] | (uint32_t(data[i + 1]) << 8) | (uint32_t(data[i + 2]) << 16);
+                return (value * 2654435761u) >> (32 - kHashBits);
+            };
+
+            size_t n = data.size();
+            size_t i = 0;
+            while (i < n) {
+                size_t length = 0;
+                size_t distance = 0;
+                if (i + 3 <= n) {
+                    size_t limit = std::min(kMaxMatch, n - i);
+                    int64_t candidate = head[hash(i)];
+                    for (int chain = 0; chain < kMaxChain && candidate >= 0 && length < limit; ++chain) {
+                        size_t from = static_cast<size_t>(candidate);
+                        if (i - from > kWindow) {
+                            break;
+                        }
+                        size_t match = 0;
+                        while (match < limit && data[from + match] == data[i + match]) {
+                            ++match;
+                        }
+                        if (match > length) {
+                            length = match;
+                            distance = i - from;
+                        }
+                        candidate = previous[from % kWindow];
+                    }
+                }
+                if (length < 3) {
+                    length = 1;
+                }
+                for (size_t k = i; k < i + length && k + 3 <= n; ++k) {
+                    uint32_t h = hash(k);
+                    previous[k % kWindow] = head[h];
+                    head[h] = static_cast<int64_t>(k);
+                }
+                if (length == 1) {
+                    writer.symbol(data[i]);
+                    ++i;
+                    continue;
+                }
+
+                size_t code = 0;
+                while (code + 1 < 29 && kLengthBase[code + 1] <= length) {
+                    ++code;
+                }
+                writer.symbol(static_cast<uint32_t>(257 + code));
+                writer.bits(static_cast<uint32_t>(length - kLengthBase[code]), kLengthExtra[code]);
+                code = 0;
+                while (code + 1 < 30 && kDistanceBase[code + 1] <= distance) {
+                    ++code;
+                }
+                writer.code(static_cast<uint32_t>(code), 5);
+                writer.bits(static_cast<uint32_t>(distance - kDistanceBase[code]), kDistanceExtra[code]);
+                i += length;
+            }
+            writer.symbol(256); // End of block
+            writer.flush();
+        }
+
+        class Canvas {
+          public:
+            Canvas(size_t width, size_t height) : width_(width), height_(height), pixels_(width * height * 3, 255) {}
+
+            void set(long x, long y, const Color &c) {
+                if (x < 0 || y < 0 || x >= static_cast<long>(width_) || y >= static_cast<long>(height_)) {
+                    return;
+                }
+                uint8_t *p = &pixels_[(static_cast<size_t>(y) * width_ + static_cast<size_t>(x)) * 3];
+                p[0] = c.r;
+                p[1] = c.g;
+                p[2] = c.b;
+            }
+
+            // Bresenham line, drawn two pixels thick
+            void line(double x0d, double y0d, double x1d, double y1d, const Color &c) {
+                long x0 = std::lround(x0d), y0 = std::lround(y0d), x1 = std::lround(x1d), y1 = std::lround(y1d);
+                long dx = std::labs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+                long dy = -std::labs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+                long err = dx + dy;
+                while (true) {
+                    set(x0, y0, c);
+                    set(x0, y0 + 1, c);
+                    if (x0 == x1 && y0 == y1) {
+                        break;
+                    }
+                    long e2 = 2 * err;
+                    if (e2 >= dy) {
+                        err += dy;
+                        x0 += sx;
+                    }
+                    if (e2 <= dx) {
+                        err += dx;
+                        y0 += sy;
+                    }
+                }
+            }
+
+            void fill(long x0, long y0, long x1, long y1, const Color &c) {
+                for (long y = y0; y < y1; ++y) {
+                    for (long x = x0; x < x1; ++x) {
+                        set(x, y, c);
+                    }
+                }
+            }
+
+            // Text in the 5x7 font, 6 pixels per character. (x, y) is the top-left corner; vertical text reads bottom
+            // to top from (x, y) as its bottom-left corner.
+            void text(long x, long y, const std::string &label, const Color &c, long scale = 1, bool vertical = false) {
+                for (size_t k = 0; k < label.size(); ++k) {
+                    const uint8_t *rows = glyphRows(label[k]);
+                    if (rows == nullptr) {
+                        continue;
+                    }
+                    for (long row = 0; row < 7 * scale; ++row) {
+                        for (long col = 0; col < 5 * scale; ++col) {
+                            if ((rows[row / scale] & (0x10 >> (col / scale))) == 0) {
+                                continue;
+                            }
+                            long along = static_cast<long>(k) * 6 * scale + col;
+                            if (vertical) {
+                                set(x + row, y - along, c);
+                            } else {
+                                set(x + along, y + row, c);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Rows use the Up filter, so the background and axes repeated down the image become zeros
+            bool writePng(const std::string &filename) const {
+                std::vector<uint8_t> raw;
+                raw.reserve(height_ * (width_ * 3 + 1));
+                for (size_t y = 0; y < height_; ++y) {
+                    raw.push_back(2); // Filter type: up
+                    const uint8_t *row = &pixels_[y * width_ * 3];
+                    for (size_t i = 0; i < width_ * 3; ++i) {
+                        raw.push_back(static_cast<uint8_t>(row[i] - (y > 0 ? row[i - width_ * 3] : 0)));
+                    }
+                }
+
+                std::vector<uint8_t> zlib = { 0x78, 0x01 };
+                deflate(raw, zlib);
+                uint32_t a = 1, b = 0;
+                for (uint8_t byte : raw) {
+                    a = (a + byte) % 65521;
+                    b = (b + a) % 65521;
+                }
+                putU32(zlib, (b << 16) | a);
+
+                std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+                std::vector<uint8_t> header;
+                putU32(header, static_cast<uint32_t>(width_));
+                putU32(header, static_cast<uint32_t>(height_));
+                header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8-bit RGB
+                putChunk(png, "IHDR", header);
+                putChunk(png, "IDAT", zlib);
+                putChunk(png, "IEND", {});
+
+                std::ofstream file(filename, std::ios::binary);
+                if (!file.is_open()) {
+                    std::cerr << "Failed to open file: " << filename << std::endl;
+                    return false;
+                }
+                file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+                return static_cast<bool>(file);
+            }
+
+          private:
+            size_t width_, height_;
+            std::vector<uint8_t> pixels_;
+        };
+
+    } // namespace
+
+    bool renderSvg(const std::string &filename, const std::vector<Chart_Series> &series, const Chart_Options &options) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        Layout layout = makeLayout(series, options);
+        size_t threshold = pixelWidth(layout);
+
+        file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << options.width << "\" height=\""
+             << options.height << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+        file << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+        file << "<rect x=\"" << layout.left << "\" y=\"" << layout.top << "\" width=\"" << layout.right - layout.left
+             << "\" height=\"" << layout.bottom - layout.top << "\" fill=\"none\" stroke=\"black\"/>\n";
+
+        // Axis ticks and labels
+        file << std::setprecision(6);
+        for (int i = 0; i <= 5; ++i) {
+            double fx = layout.x_min + (layout.x_max - layout.x_min) * i / 5.0;
+            double fy = layout.y_min + (layout.y_max - layout.y_min) * i / 5.0;
+            file << "<text x=\"" << layout.px(fx) << "\" y=\"" << layout.bottom + 18
+                 << "\" text-anchor=\"middle\">" << tickLabel(fx) << "</text>\n";
+            file << "<text x=\"" << layout.left - 6 << "\" y=\"" << layout.py(fy) + 4 << "\" text-anchor=\"end\">"
+                 << tickLabel(fy) << "</text>\n";
+        }
+        file << "<text x=\"" << options.width / 2.0 << "\" y=\"30\" text-anchor=\"middle\" font-size=\"16\">"
+             << escapeXml(options.title) << "</text>\n";
+        file << "<text x=\"" << (layout.left + layout.right) / 2 << "\" y=\"" << options.height - 15
+             << "\" text-anchor=\"middle\">" << escapeXml(options.x_label) << "</text>\n";
+        file << "<text transform=\"translate(20," << (layout.top + layout.bottom) / 2
+             << ") rotate(-90)\" text-anchor=\"middle\">" << escapeXml(options.y_label) << "</text>\n";
+
+        // Lines, downsampled to the plot width
+        file << std::fixed << std::setprecision(1);
+        for (size_t s = 0; s < series.size(); ++s) {
+            const Chart_Series &line = series[s];
+            std::string color = hexColor(seriesColor(s));
+            file << "<polyline fill=\"none\" stroke-width=\"2\" stroke=\"" << color << "\" points=\"";
+            for (size_t i : lttb(line.x, line.y, threshold)) {
+                file << layout.px(line.x[i]) << ',' << layout.py(line.y[i]) << ' ';
+            }
+            file << "\"/>\n";
+
+            double legend_y = layout.top + 10 + 20.0 * s;
+            file << "<rect x=\"" << layout.right + 15 << "\" y=\"" << legend_y - 8
+                 << "\" width=\"14\" height=\"4\" fill=\"" << color << "\"/>\n";
+            file << "<text x=\"" << layout.right + 35 << "\" y=\"" << legend_y - 2 << "\">" << escapeXml(line.name)
+                 << "</text>\n";
+        }
+
+        file << "</svg>\n";
+        return static_cast<bool>(file);
+    }
+
+    bool renderPng(const std::string &filename, const std::vector<Chart_Series> &series, const Chart_Options &options) {
+        Layout layout = makeLayout(series, options);
+        size_t threshold = pixelWidth(layout);
+        Canvas canvas(options.width, options.height);
+        Color black{ 0, 0, 0 };
+
+        canvas.line(layout.left, layout.top, layout.right, layout.top, black);
+        canvas.line(layout.left, layout.bottom, layout.right, layout.bottom, black);
+        canvas.line(layout.left, layout.top, layout.left, layout.bottom, black);
+        canvas.line(layout.right, layout.top, layout.right, layout.bottom, black);
+
+        // Axis ticks and labels, placed like the SVG ones
+        for (int i = 0; i <= 5; ++i) {
+            double fx = layout.x_min + (layout.x_max - layout.x_min) * i / 5.0;
+            double fy = layout.y_min + (layout.y_max - layout.y_min) * i / 5.0;
+            long x = std::lround(layout.px(fx));
+            long y = std::lround(layout.py(fy));
+            canvas.fill(x, static_cast<long>(layout.bottom), x + 1, static_cast<long>(layout.bottom) + 5, black);
+            canvas.fill(static_cast<long>(layout.left) - 5, y, static_cast<long>(layout.left), y + 1, black);
+            std::string x_tick = tickLabel(fx);
+            std::string y_tick = tickLabel(fy);
+            canvas.text(x - textWidth(x_tick) / 2, static_cast<long>(layout.bottom) + 9, x_tick, black);
+            canvas.text(static_cast<long>(layout.left) - 8 - textWidth(y_tick), y - 3, y_tick, black);
+        }
+        long title_x = static_cast<long>(options.width / 2) - textWidth(options.title, 2) / 2;
+        canvas.text(title_x, 16, options.title, black, 2);
+        canvas.text(static_cast<long>((layout.left + layout.right) / 2) - textWidth(options.x_label) / 2,
+                    static_cast<long>(options.height) - 22, options.x_label, black);
+        canvas.text(14, static_cast<long>((layout.top + layout.bottom) / 2) + textWidth(options.y_label) / 2,
+                    options.y_label, black, 1, true);
+
+        for (size_t s = 0; s < series.size(); ++s) {
+            const Chart_Series &line = series[s];
+            Color color = seriesColor(s);
+            std::vector<size_t> kept = lttb(line.x, line.y, threshold);
+            for (size_t k = 1; k < kept.size(); ++k) {
+                canvas.line(layout.px(line.x[kept[k - 1]]), layout.py(line.y[kept[k - 1]]), layout.px(line.x[kept[k]]),
+                            layout.py(line.y[kept[k]]), color);
+            }
+
+            long legend_y = static_cast<long>(layout.top + 10 + 20 * s);
+            long legend_x = static_cast<long>(layout.right + 15);
+            canvas.fill(legend_x, legend_y - 8, legend_x + 14, legend_y - 4, color);
+            canvas.text(legend_x + 20, legend_y - 9, line.name, black);
+        }
+
+        return canvas.writePng(filename);
+    }
+
+} // namespace chart
@@ -0,0 +1,162 @@
+#include "eventJournal.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace journal {
+
+    namespace {
+
+        constexpr char kMagic[8] = { 'V', 'O', 'L', 'J', 'R', 'N', 'L', '1' };
+
+        // Largest batch moved from the ring buffer to the file in one write
+        constexpr size_t kBatch = 1024;
+
+        template <typename T>
+        void writeValue(std::ofstream &file, const T &value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+    } // namespace
+
+    Journal_Writer::Journal_Writer(size_t capacity) : queue_(capacity), file_buffer_(1 << 20) {}
+
+    Journal_Writer::~Journal_Writer() {
+        if (writer_.joinable()) {
+            close();
+        }
+    }
+
+    bool Journal_Writer::open(const std::string &filename, const std::vector<std::string> &tickers) {
+        if (tickers.size() >= kNoTicker) {
+            std::cerr << "Too many tickers for a journal: " << tickers.size() << std::endl;
+            return false;
+        }
+        file_.rdbuf()->pubsetbuf(file_buffer_.data(), static_cast<std::streamsize>(file_buffer_.size()));
+        file_.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+        filename_ = filename;
+
+        file_.write(kMagic, sizeof(kMagic));
+        writeValue<uint32_t>(file_, static_cast<uint32_t>(tickers.size()));
+        for (const auto &ticker : tickers) {
+            writeValue<uint16_t>(file_, static_cast<uint16_t>(ticker.size()));
+            file_.write(ticker.data(), static_cast<std::streamsize>(ticker.size()));
+        }
+
+        stop_.store(false, std::memory_order_relaxed);
+        writer_ = std::thread(&Journal_Writer::writerLoop, this);
+        return static_cast<bool>(file_);
+    }
+
+    void Journal_Writer::writerLoop() {
+        Event batch[kBatch];
+        while (true) {
+            // Read the flag before draining, so events queued before close() are always written
+            bool stopping = stop_.load(std::memory_order_acquire);
+            size_t count = 0;
+            while (count < kBatch) {
+                std::optional<Event> event = queue_.try_pop();
+                if (!event) {
+                    break;
+                }
+                batch[count++] = *event;
+            }
+
+            if (count > 0) {
+                file_.write(reinterpret_cast<const char *>(batch), static_cast<std::streamsize>(count * sizeof(Event)));
+                written_.fetch_add(count, std::memory_order_relaxed);
+                continue;
+            }
+            if (stopping) {
+                return;
+            }
+            // Nothing queued: back off briefly instead of spinning a core
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    bool Journal_Writer::close() {
+        if (!writer_.joinable()) {
+            return !failed_;
+        }
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+        file_.flush();
+        failed_ = !file_;
+        file_.close();
+        if (failed_) {
+            std::cerr << "Failed to write journal: " << filename_ << std::endl;
+        }
+        return !failed_;
+    }
+
+    bool Journal_Reader::open(const std::string &filename) {
+        if (file_.is_open()) {
+            file_.close();
+        }
+        file_.clear();
+        file_.open(filename, std::ios::binary);
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        char magic[sizeof(kMagic)];
+        uint32_t ticker_count = 0;
+        if (!file_.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+            !readValue(file_, ticker_count) || ticker_count >= kNoTicker) {
+            std::cerr << "Not a journal (or an unsupported version): " << filename << std::endl;
+            return false;
+        }
+
+        tickers_.clear();
+        for (uint32_t i = 0; i < ticker_count; ++i) {
+            uint16_t size = 0;
+            if (!readValue(file_, size)) {
+                std::cerr << "Journal header is corrupt: " << filename << std::endl;
+                return false;
+            }
+            std::string ticker(size, '\0');
+            if (size > 0 && !file_.read(&ticker[0], size)) {
+                std::cerr << "Journal header is corrupt: " << filename << std::endl;
+                return false;
+            }
+            tickers_.push_back(std::move(ticker));
+        }
+        return true;
+    }
+
+    const std::string &Journal_Reader::tickerName(uint16_t ticker) const {
+        return ticker < tickers_.size() ? tickers_[ticker] : none_;
+    }
+
+    bool Journal_Reader::next(Event &event) { return readValue(file_, event); }
+
+    const char *typeName(Event_Type type) {
+        switch (type) {
+        case Event_Type::PriceChange:
+            return "price_change";
+        case Event_Type::Buy:
+            return "buy";
+        case Event_Type::Sell:
+            return "sell";
+        case Event_Type::ReallocationFunds:
+            return "reallocation_funds";
+        case Event_Type::Allocation:
+            return "allocation";
+        case Event_Type::Holding:
+            return "holding";
+        }
+        return "unknown";
+    }
+
+} // namespace journal
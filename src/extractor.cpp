@@ -1,3 +1,5 @@
+#include "extractor.h"
+#include "tradingCalendar.h"
 #include <curl/curl.h>
 #include <fstream>
 #include <iostream>
@@ -5,11 +7,11 @@
 #include <sstream>
 #include <string>
 #include <vector>
-// #include <nlohmann/json.hpp>
-#include <ctime>
-#include <iomanip> // For std::setprecision and std::fixed
+#include <iomanip> // For std::setprecision
+#include <limits>
+#include <nlohmann/json.hpp>
 
-// using json = nlohmann::json;
+using json = nlohmann::json;
 
 namespace extractor {
 
@@ -32,16 +34,15 @@ namespace extractor {
     /**
      * @brief Converts a date string to a Unix timestamp.
      *
-     * The function converts a date in the format "YYYY-MM-DD" into a Unix timestamp.
+     * The date is read as ISO-8601 (see calendar::parseIso8601); a plain "YYYY-MM-DD" is midnight UTC, whatever the
+     * machine's locale and time zone.
      *
      * @param date The date string to convert.
-     * @return The Unix timestamp representation of the date.
+     * @return The Unix timestamp representation of the date, or -1 if it does not parse.
      */
     long convertToTimestamp(const std::string &date) {
-        std::tm tm = {};
-        std::istringstream ss(date);
-        ss >> std::get_time(&tm, "%Y-%m-%d");
-        return std::mktime(&tm);
+        int64_t timestamp = calendar::parseIso8601(date);
+        return timestamp == calendar::kInvalidTime ? -1 : static_cast<long>(timestamp);
     }
 
     /**
@@ -57,10 +58,35 @@ namespace extractor {
      */
     void getStockData(const std::string &ticker, const std::string &startDate, const std::string &endDate,
                       std::map<std::string, std::vector<double>> &tickerToPrices) {
+        std::string response_data;
+        if (!fetchStockJson(ticker, startDate, endDate, response_data)) {
+            return;
+        }
+
+        // Only a ticker that parsed gets an entry
+        std::vector<double> prices;
+        if (parseStockJson(ticker, response_data, prices)) {
+            std::vector<double> &stored = tickerToPrices[ticker];
+            stored.insert(stored.end(), prices.begin(), prices.end());
+            std::cout << "Data for " << ticker << " has been processed and stored." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Downloads the raw Yahoo Finance chart response for a ticker.
+     *
+     * @param ticker The stock ticker symbol (e.g., "AAPL").
+     * @param start_date The start date for data retrieval in "YYYY-MM-DD" format.
+     * @param end_date The end date for data retrieval in "YYYY-MM-DD" format.
+     * @param response_data A reference to a string that receives the response body.
+     * @return True if the request succeeded.
+     */
+    bool fetchStockJson(const std::string &ticker, const std::string &startDate, const std::string &endDate,
+                        std::string &response_data) {
         CURL *curl = curl_easy_init();
         if (!curl) {
             std::cerr << "Failed to initialize CURL" << std::endl;
-            return;
+            return false;
         }
 
         long period1 = convertToTimestamp(startDate);
@@ -74,40 +100,66 @@ namespace extractor {
         headers = curl_slist_append(headers, "User-Agent: Mozilla/5.0");
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
-        std::string response_data;
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallBack);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
 
         CURLcode res = curl_easy_perform(curl);
+        curl_slist_free_all(headers);
+        curl_easy_cleanup(curl);
         if (res != CURLE_OK) {
             std::cerr << "Failed to fetch data: " << curl_easy_strerror(res) << std::endl;
-            curl_easy_cleanup(curl);
-            curl_slist_free_all(headers);
-            return;
+            return false;
         }
+        return true;
+    }
+
+    /**
+     * @brief Extracts the hourly close prices from a Yahoo Finance chart response.
+     *
+     * @param ticker The stock ticker symbol, used in error messages.
+     * @param response_data The raw response body.
+     * @param prices A reference to a vector the non-null close prices are appended to.
+     * @return True if the response contained price data.
+     */
+    bool parseStockJson(const std::string &ticker, const std::string &response_data, std::vector<double> &prices) {
+        std::vector<int64_t> timestamps;
+        return parseStockJson(ticker, response_data, prices, timestamps);
+    }
 
+    /**
+     * @brief Extracts the hourly close prices and their timestamps from a Yahoo Finance chart response.
+     *
+     * @param ticker The stock ticker symbol, used in error messages.
+     * @param response_data The raw response body.
+     * @param prices A reference to a vector the non-null close prices are appended to.
+     * @param timestamps A reference to a vector the epoch seconds of those prices are appended to.
+     * @return True if the response contained price data.
+     */
+    bool parseStockJson(const std::string &ticker, const std::string &response_data, std::vector<double> &prices,
+                        std::vector<int64_t> &timestamps) {
         try {
             json data = json::parse(response_data);
 
-            if (!data["chart"]["result"][0]["timestamp"].is_null()) {
-                auto timestamps = data["chart"]["result"][0]["timestamp"];
-                auto prices = data["chart"]["result"][0]["indicators"]["quote"][0]["close"];
+            if (data["chart"]["result"][0]["timestamp"].is_null()) {
+                std::cerr << "No price data for " << ticker << std::endl;
+                return false;
+            }
 
-                for (size_t i = 0; i < timestamps.size(); i++) {
-                    if (!prices[i].is_null()) {
-                        tickerToPrices[ticker].push_back(static_cast<double>(prices[i]));
-                    }
-                }
+            const auto &bar_times = data["chart"]["result"][0]["timestamp"];
+            const auto &closes = data["chart"]["result"][0]["indicators"]["quote"][0]["close"];
 
-                std::cout << "Data for " << ticker << " has been processed and stored." << std::endl;
+            for (size_t i = 0; i < bar_times.size() && i < closes.size(); i++) {
+                if (!closes[i].is_null()) {
+                    prices.push_back(static_cast<double>(closes[i]));
+                    timestamps.push_back(bar_times[i].get<int64_t>());
+                }
             }
+            return true;
         } catch (const json::exception &e) {
             std::cerr << "JSON error: " << e.what() << std::endl;
+            return false;
         }
-
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
     }
 
     /**
@@ -127,7 +179,8 @@ namespace extractor {
         }
 
         file << "ticker,price\n";
-        file << std::fixed << std::setprecision(20);
+        // Enough digits for every double to read back exactly; short values may print more digits than needed
+        file << std::setprecision(std::numeric_limits<double>::max_digits10);
         for (const auto &[ticker, prices] : ticker_to_prices) {
             for (const auto &price : prices) {
                 file << ticker << "," << price << "\n";
@@ -138,6 +191,39 @@ namespace extractor {
         std::cout << "Data has been saved to " << filename << std::endl;
     }
 
+    /**
+     * @brief Loads stock data from a CSV file written by saveToCsv.
+     *
+     * Rows are "ticker,price" and are appended to each ticker's series in file order.
+     *
+     * @param filename The name of the CSV file to read.
+     * @param ticker_to_prices A reference to a map to store the loaded prices.
+     * @return True if the file could be opened and parsed.
+     */
+    bool loadFromCsv(const std::string &filename, std::map<std::string, std::vector<double>> &ticker_to_prices) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        std::string line;
+        std::getline(file, line); // Skip the "ticker,price" header
+        while (std::getline(file, line)) {
+            size_t comma = line.find(',');
+            if (comma == std::string::npos) {
+                continue;
+            }
+            try {
+                ticker_to_prices[line.substr(0, comma)].push_back(std::stod(line.substr(comma + 1)));
+            } catch (const std::exception &) {
+                std::cerr << "Bad row in " << filename << ": " << line << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
     // Function to print a std::map (used for debugging purposes)
     void printMap(const std::map<std::string, double> &myMap, const std::string &title) {
         std::cout << title << std::endl;
@@ -0,0 +1,249 @@
+#include "incrementalEngine.h"
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace incremental {
+
+    Engine_State start(const std::string &strategy, const std::map<std::string, double> &my_portfolio) {
+        Engine_State state;
+        state.strategy = strategy;
+        state.portfolio = my_portfolio;
+        return state;
+    }
+
+    void advanceHour(Engine_State &state, const std::map<std::string, double> &hour_prices) {
+        std::vector<std::string> buying_stocks_hour;
+        double reallocation_funds_hour = 0.0;
+
+        for (const auto &[stock, price] : hour_prices) {
+            Ticker_State &ticker = state.tickers[stock];
+            double &invested_money = state.portfolio[stock];
+
+            // Market change since the previous bar, exactly as portfolio_manager applies it
+            if (ticker.volatility.count > 0) {
+                double prev_price = ticker.volatility.last_price;
+                double percentage_change = prev_price != 0 ? ((price - prev_price) / prev_price) * 100.0 : 0.0;
+                invested_money *= (1.0 + (percentage_change / 100.0));
+            }
+
+            if (!volParsing::push_price(ticker.volatility, price)) {
+                continue;
+            }
+            ticker.volatility_sum += ticker.volatility.volatility;
+            ++ticker.volatility_count;
+
+            Stock_Decision decision = decide_stock(ticker.volatility.volatility, invested_money, state.strategy);
+            if (decision.buy) {
+                buying_stocks_hour.push_back(stock);
+            } else if (decision.sell) {
+                reallocation_funds_hour -= decision.adjustment;
+            }
+            invested_money += decision.adjustment;
+        }
+
+        if (!buying_stocks_hour.empty() && reallocation_funds_hour > 0) {
+            std::vector<double> weights;
+            double total_weight = 0.0;
+            for (const auto &stock : buying_stocks_hour) {
+                const Ticker_State &ticker = state.tickers[stock];
+                weights.push_back(allocation_weight(ticker.volatility_sum / ticker.volatility_count, state.strategy));
+                total_weight += weights.back();
+            }
+            for (size_t i = 0; i < buying_stocks_hour.size(); ++i) {
+                state.portfolio[buying_stocks_hour[i]] += (weights[i] / total_weight) * reallocation_funds_hour;
+            }
+        }
+
+        ++state.hours_processed;
+    }
+
+    void advance(Engine_State &state, const std::map<std::string, std::vector<double>> &new_bars) {
+        size_t hours = 0;
+        for (const auto &[ticker, prices] : new_bars) {
+            hours = std::max(hours, prices.size());
+        }
+
+        std::map<std::string, double> hour_prices;
+        for (size_t hour = 0; hour < hours; ++hour) {
+            hour_prices.clear();
+            for (const auto &[ticker, prices] : new_bars) {
+                if (hour < prices.size()) {
+                    hour_prices.emplace_hint(hour_prices.end(), ticker, prices[hour]);
+                }
+            }
+            advanceHour(state, hour_prices);
+        }
+    }
+
+    bool advance(Engine_State &state, const std::map<std::string, std::vector<double>> &new_bars,
+                 const std::vector<int64_t> &bar_times) {
+        size_t hours = 0;
+        for (const auto &[ticker, prices] : new_bars) {
+            hours = std::max(hours, prices.size());
+        }
+        if (bar_times.size() != hours) {
+            std::cerr << "Batch has " << hours << " hours but " << bar_times.size() << " timestamps" << std::endl;
+            return false;
+        }
+        int64_t previous = state.last_timestamp;
+        for (int64_t time : bar_times) {
+            if (time <= previous) {
+                std::cerr << "Bar at " << time << " is not after " << previous << " (batch replayed or out of order)"
+                          << std::endl;
+                return false;
+            }
+            previous = time;
+        }
+
+        advance(state, new_bars);
+        if (!bar_times.empty()) {
+            state.last_timestamp = bar_times.back();
+        }
+        return true;
+    }
+
+    namespace {
+
+        // The last byte is the format version; version 1 had no last_timestamp
+        constexpr char kMagic[8] = { 'V', 'O', 'L', 'C', 'K', 'P', 'T', '2' };
+
+        template <typename T>
+        void writeValue(std::ofstream &file, const T &value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        void writeString(std::ofstream &file, const std::string &value) {
+            writeValue<uint64_t>(file, value.size());
+            file.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+        bool readString(std::ifstream &file, std::string &value) {
+            uint64_t size = 0;
+            if (!readValue(file, size) || size > (1u << 20)) {
+                return false;
+            }
+            value.resize(size);
+            return size == 0 || static_cast<bool>(file.read(&value[0], static_cast<std::streamsize>(size)));
+        }
+
+    } // namespace
+
+    bool saveCheckpoint(const std::string &filename, const Engine_State &state) {
+        // Write to a temporary file first so a crash never leaves a half-written checkpoint behind
+        std::string temporary = filename + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open file: " << temporary << std::endl;
+                return false;
+            }
+
+            file.write(kMagic, sizeof(kMagic));
+            writeString(file, state.strategy);
+            writeValue<uint64_t>(file, state.hours_processed);
+            writeValue(file, state.last_timestamp);
+
+            writeValue<uint64_t>(file, state.tickers.size());
+            for (const auto &[ticker, ticker_state] : state.tickers) {
+                const volParsing::Volatility_State &vol = ticker_state.volatility;
+                writeString(file, ticker);
+                writeValue<uint64_t>(file, vol.count);
+                writeValue(file, vol.last_price);
+                writeValue(file, vol.volatility);
+                writeValue<uint64_t>(file, vol.warmup_prices.size());
+                for (double price : vol.warmup_prices) {
+                    writeValue(file, price);
+                }
+                writeValue(file, ticker_state.volatility_sum);
+                writeValue<uint64_t>(file, ticker_state.volatility_count);
+            }
+
+            writeValue<uint64_t>(file, state.portfolio.size());
+            for (const auto &[ticker, value] : state.portfolio) {
+                writeString(file, ticker);
+                writeValue(file, value);
+            }
+
+            if (!file) {
+                std::cerr << "Failed to write checkpoint: " << temporary << std::endl;
+                return false;
+            }
+        }
+
+        if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::cerr << "Failed to replace checkpoint: " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadCheckpoint(const std::string &filename, Engine_State &state) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        char magic[sizeof(kMagic)];
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic) - 1) != 0 ||
+            (magic[7] != '1' && magic[7] != '2')) {
+            std::cerr << "Not a checkpoint file (or an unsupported version): " << filename << std::endl;
+            return false;
+        }
+
+        Engine_State loaded;
+        uint64_t hours = 0;
+        uint64_t ticker_count = 0;
+        bool ok = readString(file, loaded.strategy) && readValue(file, hours) &&
+                  (magic[7] == '1' || readValue(file, loaded.last_timestamp)) && readValue(file, ticker_count);
+        loaded.hours_processed = hours;
+
+        for (uint64_t i = 0; ok && i < ticker_count; ++i) {
+            std::string ticker;
+            Ticker_State ticker_state;
+            volParsing::Volatility_State &vol = ticker_state.volatility;
+            uint64_t count = 0;
+            uint64_t warmup = 0;
+            uint64_t volatility_count = 0;
+            ok = readString(file, ticker) && readValue(file, count) && readValue(file, vol.last_price) &&
+                 readValue(file, vol.volatility) && readValue(file, warmup) && warmup <= 6;
+            for (uint64_t w = 0; ok && w < warmup; ++w) {
+                double price = 0.0;
+                ok = readValue(file, price);
+                vol.warmup_prices.push_back(price);
+            }
+            ok = ok && readValue(file, ticker_state.volatility_sum) && readValue(file, volatility_count);
+            vol.count = count;
+            ticker_state.volatility_count = volatility_count;
+            loaded.tickers.emplace(ticker, std::move(ticker_state));
+        }
+
+        uint64_t portfolio_size = 0;
+        ok = ok && readValue(file, portfolio_size);
+        for (uint64_t i = 0; ok && i < portfolio_size; ++i) {
+            std::string ticker;
+            double value = 0.0;
+            ok = readString(file, ticker) && readValue(file, value);
+            loaded.portfolio[ticker] = value;
+        }
+
+        if (!ok) {
+            std::cerr << "Checkpoint is truncated or corrupt: " << filename << std::endl;
+            return false;
+        }
+        state = std::move(loaded);
+        return true;
+    }
+
+} // namespace incremental
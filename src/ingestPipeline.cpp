@@ -0,0 +1,169 @@
+#include "ingestPipeline.h"
+#include "extractor.h"
+#include "spscQueue.h"
+#include "stock_manager.h"
+#include "volatilityParse.h"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+namespace ingest {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        double secondsSince(Clock::time_point start) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        // Work item between stages; `done` marks the end of the stream
+        struct Payload_Item {
+            std::string ticker;
+            std::string payload;
+            bool done = false;
+        };
+
+        struct Prices_Item {
+            std::string ticker;
+            std::vector<double> prices;
+            bool done = false;
+        };
+
+    } // namespace
+
+    Ingest_Result run(const std::vector<std::string> &tickers, const Fetch_Function &fetch,
+                      const Parse_Function &parse, size_t queue_capacity) {
+        Ingest_Result result;
+        auto wall_start = Clock::now();
+
+        Spsc_Queue<Payload_Item> fetched(queue_capacity);
+        Spsc_Queue<Prices_Item> parsed(queue_capacity);
+
+        // An exception in a stage is kept and rethrown here after both threads are joined. The failing stage stops
+        // its work but still drains its input and sends `done`, so no other stage is left blocked on a queue
+        std::exception_ptr fetch_error;
+        std::exception_ptr parse_error;
+        std::exception_ptr compute_error;
+        std::atomic<bool> failed{ false };
+
+        // Stage 1: fetch
+        std::thread fetcher([&]() {
+            try {
+                for (const auto &ticker : tickers) {
+                    if (failed.load(std::memory_order_relaxed)) {
+                        break;
+                    }
+                    Payload_Item item;
+                    item.ticker = ticker;
+                    auto start = Clock::now();
+                    bool ok = fetch(ticker, item.payload);
+                    result.fetch_seconds += secondsSince(start);
+                    if (ok) {
+                        fetched.push(std::move(item));
+                    }
+                }
+            } catch (...) {
+                fetch_error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+            Payload_Item end;
+            end.done = true;
+            fetched.push(std::move(end));
+        });
+
+        // Stage 2: parse
+        std::thread parser([&]() {
+            while (true) {
+                Payload_Item item = fetched.pop();
+                if (item.done) {
+                    break;
+                }
+                if (parse_error) {
+                    continue;
+                }
+                try {
+                    Prices_Item prices;
+                    prices.ticker = item.ticker;
+                    auto start = Clock::now();
+                    bool ok = parse(item.ticker, item.payload, prices.prices);
+                    result.parse_seconds += secondsSince(start);
+                    if (ok) {
+                        parsed.push(std::move(prices));
+                    }
+                } catch (...) {
+                    parse_error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            Prices_Item end;
+            end.done = true;
+            parsed.push(std::move(end));
+        });
+
+        // Stage 3: per-ticker volatility and percentage changes, on this thread
+        while (true) {
+            Prices_Item item = parsed.pop();
+            if (item.done) {
+                break;
+            }
+            if (compute_error) {
+                continue;
+            }
+            try {
+                auto start = Clock::now();
+                const std::vector<double> &prices = item.prices;
+
+                // Same sequence as tickerToVolHourly + true_volatility, one ticker at a time
+                volParsing::Volatility_State state;
+                std::vector<double> volatility;
+                volatility.reserve(prices.size() > 6 ? prices.size() - 6 : 0);
+                for (double price : prices) {
+                    bool produced = volParsing::push_price(state, price);
+                    if (state.count == 6) {
+                        result.initial_volatility[item.ticker] = state.volatility;
+                    }
+                    if (produced) {
+                        volatility.push_back(state.volatility);
+                    }
+                }
+                if (prices.size() < 6) {
+                    std::cout << " Not enough data for " << item.ticker << std::endl;
+                } else if (!volatility.empty()) {
+                    result.true_volatility[item.ticker] = std::move(volatility);
+                }
+
+                result.percentage_changes[item.ticker] = series_percentage_changes(prices);
+                result.ticker_to_prices[item.ticker] = std::move(item.prices);
+                result.compute_seconds += secondsSince(start);
+            } catch (...) {
+                compute_error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        fetcher.join();
+        parser.join();
+        for (const std::exception_ptr &error : { fetch_error, parse_error, compute_error }) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        result.wall_seconds = secondsSince(wall_start);
+        return result;
+    }
+
+    Ingest_Result run(const std::vector<std::string> &tickers, const std::string &startDate,
+                      const std::string &endDate) {
+        Fetch_Function fetch = [&](const std::string &ticker, std::string &payload) {
+            return extractor::fetchStockJson(ticker, startDate, endDate, payload);
+        };
+        Parse_Function parse = [](const std::string &ticker, const std::string &payload, std::vector<double> &prices) {
+            return extractor::parseStockJson(ticker, payload, prices);
+        };
+        return run(tickers, fetch, parse);
+    }
+
+} // namespace ingest
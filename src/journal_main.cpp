@@ -0,0 +1,98 @@
+#include "eventJournal.h"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Decodes an event journal written by main.
+ *
+ * Usage: volatility_journal <journal> [--csv]
+ *
+ * Without --csv the events are printed hour by hour in the layout main used to print them. With --csv every event is
+ * one "hour,type,ticker,value" row.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <journal> [--csv]\n";
+        return 1;
+    }
+    bool csv = argc > 2 && std::string(argv[2]) == "--csv";
+
+    journal::Journal_Reader reader;
+    if (!reader.open(argv[1])) {
+        return 1;
+    }
+
+    journal::Event event;
+    if (csv) {
+        std::cout << "hour,type,ticker,value\n";
+        std::cout << std::setprecision(std::numeric_limits<double>::max_digits10);
+        while (reader.next(event)) {
+            std::cout << event.hour << "," << journal::typeName(event.type) << ","
+                      << reader.tickerName(event.ticker) << "," << event.value << "\n";
+        }
+        return 0;
+    }
+
+    // Pretty print: one block per hour, a heading whenever the event type changes
+    uint32_t hour = std::numeric_limits<uint32_t>::max();
+    journal::Event_Type section = journal::Event_Type::PriceChange;
+    while (reader.next(event)) {
+        if (event.hour != hour) {
+            if (hour != std::numeric_limits<uint32_t>::max()) {
+                std::cout << "\n--------------------------\n";
+            }
+            hour = event.hour;
+            std::cout << "Hour " << hour + 1 << " Results:";
+            section = journal::Event_Type{};
+        }
+        if (event.type != section) {
+            section = event.type;
+            switch (section) {
+            case journal::Event_Type::PriceChange:
+                std::cout << "\n  Stock Price Changes:";
+                break;
+            case journal::Event_Type::Buy:
+                std::cout << "\n  Buying:";
+                break;
+            case journal::Event_Type::Sell:
+                std::cout << "\n  Selling:";
+                break;
+            case journal::Event_Type::ReallocationFunds:
+                break;
+            case journal::Event_Type::Allocation:
+                std::cout << "\n  How much we bought:";
+                break;
+            case journal::Event_Type::Holding:
+                std::cout << "\n  Your Portfolio at the end of this hour:";
+                break;
+            }
+        }
+
+        const std::string &ticker = reader.tickerName(event.ticker);
+        switch (event.type) {
+        case journal::Event_Type::PriceChange:
+            std::cout << "\n    " << ticker << ": " << (event.value >= 0 ? "+" : "") << event.value << "%";
+            break;
+        case journal::Event_Type::Buy:
+        case journal::Event_Type::Sell:
+            std::cout << " " << ticker;
+            break;
+        case journal::Event_Type::ReallocationFunds:
+            std::cout << "\n  Funds Available for Reallocation: $" << event.value;
+            break;
+        case journal::Event_Type::Allocation:
+            std::cout << "\n    - " << ticker << ": $" << event.value;
+            break;
+        case journal::Event_Type::Holding:
+            std::cout << "\n    " << ticker << ": $" << event.value;
+            break;
+        }
+    }
+    if (hour != std::numeric_limits<uint32_t>::max()) {
+        std::cout << "\n--------------------------\n";
+    }
+    return 0;
+}
@@ -1,16 +1,27 @@
-// #include "extractor.h"
-// #include "portfolio_manager.h"
-// #include "stock_manager.h"
+#include "backtestService.h"
+#include "chartRenderer.h"
+#include "eventJournal.h"
+#include "extractor.h"
+#include "ingestPipeline.h"
+#include "portfolio_manager.h"
+#include "precision.h"
+#include "sharedMarketData.h"
+#include "stock_manager.h"
+#include "tradingCalendar.h"
 #include "volatilityFormula.h"
 // #include "volatility_parse.h"
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 #include <map>
-// #include <matplot/matplot.h>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 /**
@@ -126,7 +137,265 @@ double calculate_total_portfolio_value(const std::map<std::string, double> &port
     return total_value;
 }
 
-int main() {
+/**
+ * @brief Reads a starting capital from a command line argument.
+ *
+ * @param text The argument.
+ * @param capital Set to the amount if it parses.
+ * @return False if the argument is not a positive number.
+ */
+bool parse_capital(const std::string &text, double &capital) {
+    try {
+        size_t used = 0;
+        double value = std::stod(text, &used);
+        if (used != text.size() || !std::isfinite(value) || value <= 0) {
+            throw std::invalid_argument("Must be positive");
+        }
+        capital = value;
+        return true;
+    } catch (std::exception &) {
+        return false;
+    }
+}
+
+/**
+ * @brief Prints the window, holdings, value and risk figures of a backtest.
+ */
+void print_response(const service::Backtest_Response &response) {
+    std::cout << "Hours " << response.begin_hour << " to " << response.end_hour << "\n";
+    for (const auto &[stock, value] : response.final_portfolio) {
+        std::cout << stock << ": $" << value << "\n";
+    }
+    std::cout << "Value: $" << response.initial_value << " -> $" << response.final_value << " ("
+              << response.metrics.total_return * 100 << "%)\n";
+    std::cout << "Max drawdown: " << response.metrics.max_drawdown * 100 << "%, Sharpe: " << response.metrics.sharpe
+              << ", Sortino: " << response.metrics.sortino << "\n";
+    std::cout << "Computed in " << response.compute_ns / 1000.0 << " us\n";
+}
+
+/**
+ * @brief Runs the backtest daemon until SIGINT or SIGTERM.
+ *
+ * Usage: volatility_app --daemon <prices.csv> [first_date] [socket_path]
+ *
+ * The price panel and its volatility are loaded once and kept in memory. With first_date ("YYYY-MM-DD", the day of
+ * the first bar) every hour is stamped with its US equity session time, so requests can select a date window.
+ *
+ * @return The process exit code.
+ */
+int run_daemon(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --daemon <prices.csv> [first_date] [socket_path]\n";
+        return 1;
+    }
+    std::map<std::string, std::vector<double>> ticker_to_prices;
+    if (!extractor::loadFromCsv(argv[2], ticker_to_prices) || ticker_to_prices.empty()) {
+        std::cerr << "No prices loaded from " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::vector<int64_t> bar_starts;
+    if (argc > 3 && std::string(argv[3]) != "-") {
+        int64_t first_time = calendar::parseIso8601(argv[3]);
+        if (first_time == calendar::kInvalidTime) {
+            std::cerr << "Invalid first date: " << argv[3] << std::endl;
+            return 1;
+        }
+        size_t price_hours = 0;
+        for (const auto &[ticker, prices] : ticker_to_prices) {
+            price_hours = std::max(price_hours, prices.size());
+        }
+        // Every trading day has at least one bar, so this many days always covers the panel
+        int64_t first_day = first_time / 86400;
+        int year;
+        unsigned month, day;
+        calendar::civilFromDays(first_day + 2 * static_cast<int64_t>(price_hours) + 14, year, month, day);
+        char last_date[16];
+        std::snprintf(last_date, sizeof(last_date), "%04d-%02u-%02u", year, month, day);
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities(argv[3], last_date);
+        for (size_t hour = 0; hour < price_hours && hour < sessions.hours(); ++hour) {
+            bar_starts.push_back(sessions.barStart(hour));
+        }
+    }
+
+    service::Daemon_Config config;
+    if (argc > 4) {
+        config.socket_path = argv[4];
+    }
+    std::shared_ptr<const service::Market_Data> data = service::buildMarketData(ticker_to_prices, bar_starts);
+
+    // Block the stop signals before the workers start, so only sigwait below receives them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    service::Backtest_Daemon daemon(data);
+    if (!daemon.start(config)) {
+        return 1;
+    }
+    std::cout << "Serving " << data->prices.size() << " tickers, " << data->hours << " hours on "
+              << config.socket_path << std::endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    daemon.stop();
+    std::cout << "Stopped after " << daemon.served() << " requests" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Sends one backtest request to a running daemon and prints the result.
+ *
+ * Usage: volatility_app --query <strategy> [capital] [from] [to] [TICKER,TICKER,...] [socket_path]
+ *
+ * from and to are ISO-8601 times (to is exclusive); "-" leaves an argument at its default.
+ *
+ * @return The process exit code.
+ */
+int run_query(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --query <strategy> [capital] [from] [to] [TICKER,...] [socket_path]\n";
+        return 1;
+    }
+    auto given = [&](int index) { return argc > index && std::string(argv[index]) != "-"; };
+
+    service::Backtest_Request request;
+    request.strategy = argv[2];
+    if (given(3) && !parse_capital(argv[3], request.capital)) {
+        std::cerr << "Invalid capital: " << argv[3] << "\n";
+        std::cerr << "Usage: " << argv[0] << " --query <strategy> [capital] [from] [to] [TICKER,...] [socket_path]\n";
+        return 1;
+    }
+    for (int index : { 4, 5 }) {
+        if (!given(index)) {
+            continue;
+        }
+        int64_t time = calendar::parseIso8601(argv[index]);
+        if (time == calendar::kInvalidTime) {
+            std::cerr << "Invalid time: " << argv[index] << std::endl;
+            return 1;
+        }
+        (index == 4 ? request.begin_time : request.end_time) = time;
+    }
+    if (given(6)) {
+        std::stringstream tickers(argv[6]);
+        std::string ticker;
+        while (std::getline(tickers, ticker, ',')) {
+            request.tickers.push_back(ticker);
+        }
+    }
+    service::Daemon_Config config;
+    if (argc > 7) {
+        config.socket_path = argv[7];
+    }
+
+    service::Backtest_Client client;
+    service::Backtest_Response response;
+    if (!client.connect(config.socket_path) || !client.run(request, response)) {
+        return 1;
+    }
+    if (response.status != service::Status::Ok) {
+        std::cerr << "Request rejected: " << service::statusName(response.status) << std::endl;
+        return 1;
+    }
+
+    print_response(response);
+    return 0;
+}
+
+/**
+ * @brief Publishes a price panel and its volatility into shared memory until SIGINT or SIGTERM.
+ *
+ * Usage: volatility_app --publish <prices.csv> [segment_name]
+ *
+ * Workers started with --worker map the segment read-only instead of loading and computing their own copy. The
+ * segment is removed when the loader stops.
+ *
+ * @return The process exit code.
+ */
+int run_publish(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --publish <prices.csv> [segment_name]\n";
+        return 1;
+    }
+    std::map<std::string, std::vector<double>> ticker_to_prices;
+    if (!extractor::loadFromCsv(argv[2], ticker_to_prices) || ticker_to_prices.empty()) {
+        std::cerr << "No prices loaded from " << argv[2] << std::endl;
+        return 1;
+    }
+    std::string segment = argc > 3 ? argv[3] : sharedData::kDefaultSegment;
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::shared_ptr<const service::Market_Data> data = service::buildMarketData(ticker_to_prices);
+    if (!sharedData::publish(segment, data->prices, data->true_volatility, data->percentage_changes)) {
+        return 1;
+    }
+    std::cout << "Published " << data->prices.size() << " tickers, " << data->hours << " hours to " << segment
+              << std::endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    sharedData::unpublish(segment);
+    std::cout << "Removed " << segment << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Runs one backtest on a panel published with --publish and prints the result.
+ *
+ * Usage: volatility_app --worker <strategy> [capital] [segment_name]
+ *
+ * @return The process exit code.
+ */
+int run_worker(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --worker <strategy> [capital] [segment_name]\n";
+        return 1;
+    }
+    service::Backtest_Request request;
+    request.strategy = argv[2];
+    if (argc > 3 && std::string(argv[3]) != "-" && !parse_capital(argv[3], request.capital)) {
+        std::cerr << "Invalid capital: " << argv[3] << "\n";
+        std::cerr << "Usage: " << argv[0] << " --worker <strategy> [capital] [segment_name]\n";
+        return 1;
+    }
+    std::string segment = argc > 4 ? argv[4] : sharedData::kDefaultSegment;
+
+    sharedData::MarketView view;
+    if (!view.attach(segment)) {
+        return 1;
+    }
+    service::Backtest_Response response = service::runBacktest(*service::buildMarketData(view), request);
+    if (response.status != service::Status::Ok) {
+        std::cerr << "Backtest rejected: " << service::statusName(response.status) << std::endl;
+        return 1;
+    }
+    std::cout << "Segment " << segment << ", generation " << view.generation() << "\n";
+    print_response(response);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string(argv[1]) == "--daemon") {
+        return run_daemon(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--query") {
+        return run_query(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--publish") {
+        return run_publish(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--worker") {
+        return run_worker(argc, argv);
+    }
+
     // INIT GAME
     float initial_investment;
     int months;
@@ -137,26 +406,26 @@ int main() {
     std::tie(initial_investment, months, strategy) = start_game();
 
     // GET PRICE PER HOUR -ISMA
-    // Map to store prices for each ticker
-    std::map<std::string, std::vector<double>> ticker_to_prices;
     std::vector<std::string> tickers = {
         "NVDA", "AAPL", "MSFT", "AMZN", "GOOGL", "META", "TSLA", "TSM", "AVGO", "ORCL"
     };
-    for (const auto &ticker : tickers) {
-        get_stock_data(ticker, "2023-12-30", "2024-11-18", ticker_to_prices);
-    }
+
+    // Fetch, parse and volatility run as a pipeline, so each ticker's volatility is computed while the next one
+    // is still downloading
+    ingest::Ingest_Result ingested = ingest::run(tickers, "2023-12-30", "2024-11-18");
 
     // GET PORTFOLIO
     // Determine initial investment per stock
     std::map<std::string, double> my_portfolio = create_portfolio(tickers, initial_investment);
 
     // GET VOLATILITY MAP
-    std::map<std::string, double> output = ticker_to_vol_hourly(ticker_to_prices);
-    std::map<std::string, std::vector<double>> true_vol = true_volatility(ticker_to_prices, output);
+    // Stored as precision::storage_t: float with -DVOLATILITY_FLOAT_STORAGE=ON, otherwise the ingested doubles as is
+    precision::Column_Map<precision::storage_t> true_vol =
+        precision::toStorage<precision::storage_t>(std::move(ingested.true_volatility));
 
-    // Calculate percentage changes
-    std::map<std::string, std::vector<double>> ticker_to_percentage_changes =
-        calculate_percentage_changes(ticker_to_prices);
+    // Percentage changes
+    precision::Column_Map<precision::storage_t> ticker_to_percentage_changes =
+        precision::toStorage<precision::storage_t>(std::move(ingested.percentage_changes));
 
     // Print the initial portfolio
     std::cout << "Initial Portfolio:\n";
@@ -175,73 +444,62 @@ int main() {
 
     std::vector<std::map<std::string, double>> portfolio_snapshots;
 
-    // PRINTING RESULTS/PLOT
-    // Print combined results for each hour
+    // HOURLY REPORT
+    // Every hour's price changes, decisions, allocations and holdings go to a binary journal written by a background
+    // thread; decode it with volatility_journal
+    std::vector<std::string> journal_tickers;
+    std::map<std::string, uint16_t> ticker_ids;
+    for (const auto &[stock, value] : my_portfolio) {
+        ticker_ids[stock] = static_cast<uint16_t>(journal_tickers.size());
+        journal_tickers.push_back(stock);
+    }
+    // A ticker outside the table is logged without one rather than as the first ticker
+    auto ticker_id = [&ticker_ids](const std::string &stock) {
+        auto found = ticker_ids.find(stock);
+        return found != ticker_ids.end() ? found->second : journal::kNoTicker;
+    };
+    journal::Journal_Writer hourly_journal;
+    bool journaling = hourly_journal.open("portfolio.journal", journal_tickers);
+
     size_t hours = stock_result.buying_stocks.size();
     for (size_t hour = 0; hour < hours; ++hour) {
-        std::cout << "Hour " << hour + 1 << " Results:\n";
+        // Use the stored portfolio values for this hour
+        if (hour < portfolio_result.portfolio_values.size()) {
+            portfolio_snapshots.push_back(portfolio_result.portfolio_values[hour]);
+        } else {
+            // If for some reason we don't have portfolio values for this hour, repeat the last one
+            portfolio_snapshots.push_back(portfolio_snapshots.empty() ? my_portfolio : portfolio_snapshots.back());
+        }
+        if (!journaling) {
+            continue;
+        }
 
-        // Print the percentage changes for each stock
-        std::cout << "  Stock Price Changes:\n";
+        uint32_t h = static_cast<uint32_t>(hour);
         for (const auto &[stock, percentage_changes] : ticker_to_percentage_changes) {
-            double percentage_change = 0.0;
             if (hour < percentage_changes.size()) {
-                percentage_change = percentage_changes[hour];
-                std::cout << "    " << stock << ": ";
-                if (percentage_change >= 0) {
-                    std::cout << "+";
-                }
-                std::cout << percentage_change << "%\n";
-            } else {
-                // If no data for this hour, assume no change
-                std::cout << "    " << stock << ": No data\n";
+                hourly_journal.log(h, journal::Event_Type::PriceChange, ticker_id(stock), percentage_changes[hour]);
             }
         }
-
-        // Stock Manager Results
-        std::cout << "  Stock Manager Decisions:\n";
-        std::cout << "    Buying: ";
         for (const auto &stock : stock_result.buying_stocks[hour]) {
-            std::cout << stock << " ";
+            hourly_journal.log(h, journal::Event_Type::Buy, ticker_id(stock));
         }
-        std::cout << "\n";
-
-        std::cout << "    Selling: ";
         for (const auto &stock : stock_result.selling_stocks[hour]) {
-            std::cout << stock << " ";
+            hourly_journal.log(h, journal::Event_Type::Sell, ticker_id(stock));
         }
-        std::cout << "\n";
-
-        std::cout << "    Funds Available for Reallocation: $" << stock_result.reallocation_funds[hour] << "\n";
-
-        // Portfolio Manager Results
-        std::cout << "  How much we bought:\n";
-        if (hour < portfolio_result.allocations.size() && !portfolio_result.allocations[hour].empty()) {
+        hourly_journal.log(h, journal::Event_Type::ReallocationFunds, journal::kNoTicker,
+                           stock_result.reallocation_funds[hour]);
+        if (hour < portfolio_result.allocations.size()) {
             for (const auto &[stock, allocated_funds] : portfolio_result.allocations[hour]) {
-                std::cout << "    - " << stock << ": $" << allocated_funds << "\n";
+                hourly_journal.log(h, journal::Event_Type::Allocation, ticker_id(stock), allocated_funds);
             }
-        } else {
-            std::cout << "    No funds allocated this hour.\n";
         }
-
-        // Print the updated portfolio at the start of the hour
-        std::cout << "  Your Portfolio at the end of this hour:\n";
-        // Use the stored portfolio values for this hour
-        if (hour < portfolio_result.portfolio_values.size()) {
-            const auto &portfolio_at_hour = portfolio_result.portfolio_values[hour];
-            portfolio_snapshots.push_back(portfolio_result.portfolio_values[hour]);
-            for (const auto &[stock, value] : portfolio_at_hour) {
-                std::cout << "    " << stock << ": $" << value << "\n";
-            }
-        } else {
-            // If for some reason we don't have portfolio values for this hour, print
-            // current my_portfolio
-            portfolio_snapshots.push_back(portfolio_snapshots.back());
-            for (const auto &[stock, value] : my_portfolio) {
-                std::cout << "    " << stock << ": $" << value << "\n";
-            }
+        for (const auto &[stock, value] : portfolio_snapshots.back()) {
+            hourly_journal.log(h, journal::Event_Type::Holding, ticker_id(stock), value);
         }
-        std::cout << "--------------------------\n";
+    }
+    if (journaling && hourly_journal.close()) {
+        std::cout << "Hourly report written to portfolio.journal (" << hourly_journal.written()
+                  << " events, decode with volatility_journal)\n";
     }
 
     // Print final portfolio
@@ -260,40 +518,42 @@ int main() {
     }
     std::cout << gain_loss << " (" << (gain_loss / initial_investment) * 100 << "%)\n";
 
-    // PLOT the portfolio over time
-    std::map<std::string, std::vector<double>> stock_data;
-    std::vector<double> time_hours(portfolio_snapshots.size());
+    // Risk and performance, computed bar by bar inside portfolio_manager
+    const metrics::Metrics_Summary &summary = portfolio_result.metrics;
+    std::cout << "\nRisk and Performance:\n";
+    std::cout << "  Max drawdown: " << summary.max_drawdown * 100 << "%\n";
+    std::cout << "  Realized volatility (annualized): " << summary.realized_volatility * 100 << "%\n";
+    std::cout << "  Sharpe ratio: " << summary.sharpe << "\n";
+    std::cout << "  Sortino ratio: " << summary.sortino << "\n";
+    std::cout << "  Turnover: " << summary.turnover << "x\n";
+    std::cout << "  1-hour VaR (95%): " << summary.value_at_risk * 100 << "%\n";
+    std::cout << "  1-hour CVaR (95%): " << summary.expected_shortfall * 100 << "%\n";
 
+    // PLOT the portfolio over time
+    // One series per ticker, rendered headless and downsampled to the chart width
+    std::map<std::string, chart::Chart_Series> stock_data;
     for (size_t i = 0; i < portfolio_snapshots.size(); ++i) {
-        time_hours[i] = i;
         for (const auto &[stock, value] : portfolio_snapshots[i]) {
-            stock_data[stock].push_back(value);
+            chart::Chart_Series &series = stock_data[stock];
+            series.name = stock;
+            series.x.push_back(static_cast<double>(i));
+            series.y.push_back(value);
         }
     }
 
-    auto ax = gca();
-    hold(ax, on);
-    std::vector<std::string> colors = { "b", "g", "r", "c", "m", "y", "k", "#b", "g", "r" };
-    std::vector<std::string> markers = { "*", "*", "*", "*", "*", "*", "*", "x", "x", "x" };
-    size_t color_index = 0;
-
-    for (const auto &[stock, values] : stock_data) {
-        auto line = plot(time_hours, values);
-        (*line).line_width(2);
-        (*line).color(colors[color_index % colors.size()]);
-        (*line).marker_size(8);
-        (*line).display_name(stock);
-        ++color_index;
+    std::vector<chart::Chart_Series> lines;
+    for (auto &[stock, series] : stock_data) {
+        lines.push_back(std::move(series));
     }
 
-    xlabel("Hour");
-    ylabel("Portfolio value ($)");
-    title("Portfolio Over Hours per Ticker");
-    legend()->location(legend::general_alignment::bottomright);
-    hold(ax, off);
-    show();
+    chart::Chart_Options chart_options;
+    chart_options.title = "Portfolio Over Hours per Ticker";
+    chart_options.x_label = "Hour";
+    chart_options.y_label = "Portfolio value ($)";
+    if (chart::renderSvg("portfolio.svg", lines, chart_options) &&
+        chart::renderPng("portfolio.png", lines, chart_options)) {
+        std::cout << "\nPortfolio chart written to portfolio.svg and portfolio.png\n";
+    }
 
     return 0;
 }
-
-int main() { return 0; }
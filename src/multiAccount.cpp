@@ -0,0 +1,194 @@
+#include "multiAccount.h"
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace accounts {
+
+    namespace {
+
+        constexpr uint8_t kNone = 0;
+        constexpr uint8_t kBuy = 1;
+        constexpr uint8_t kSell = 2;
+
+        // Enough rows per shard that waking the pool pays for itself
+        constexpr size_t kRowsPerShard = 64;
+
+    } // namespace
+
+    Multi_Account_Engine::Multi_Account_Engine(std::vector<std::string> tickers) : tickers_(std::move(tickers)) {
+        // Ticker order must match the map order the single-account engine iterates in
+        std::sort(tickers_.begin(), tickers_.end());
+        tickers_.erase(std::unique(tickers_.begin(), tickers_.end()), tickers_.end());
+        market_.resize(tickers_.size());
+        has_bar_.resize(tickers_.size());
+        has_change_.resize(tickers_.size());
+        has_volatility_.resize(tickers_.size());
+        change_factor_.resize(tickers_.size());
+    }
+
+    size_t Multi_Account_Engine::addAccount(const std::string &strategy, const std::map<std::string, double> &holdings) {
+        auto group = std::find_if(groups_.begin(), groups_.end(),
+                                  [&](const Strategy_Group &g) { return g.strategy == strategy; });
+        if (group == groups_.end()) {
+            Strategy_Group created;
+            created.strategy = strategy;
+            created.decision.resize(tickers_.size());
+            created.sell_fraction.resize(tickers_.size());
+            groups_.push_back(std::move(created));
+            group = groups_.end() - 1;
+        }
+
+        size_t row = group->rows++;
+        group->holdings.resize(group->rows * tickers_.size(), 0.0);
+        double *holding_row = group->holdings.data() + row * tickers_.size();
+        for (size_t i = 0; i < tickers_.size(); ++i) {
+            auto found = holdings.find(tickers_[i]);
+            if (found != holdings.end()) {
+                holding_row[i] = found->second;
+            }
+        }
+
+        slots_.push_back(Slot{ static_cast<size_t>(group - groups_.begin()), row });
+        return slots_.size() - 1;
+    }
+
+    void Multi_Account_Engine::advanceHour(const std::vector<double> &prices, Thread_Pool *pool) {
+        size_t tickers = tickers_.size();
+
+        // Market step, once per bar: price change and EWMA volatility of every ticker
+        for (size_t i = 0; i < tickers; ++i) {
+            double price = i < prices.size() ? prices[i] : std::numeric_limits<double>::quiet_NaN();
+            has_bar_[i] = !std::isnan(price);
+            has_change_[i] = 0;
+            has_volatility_[i] = 0;
+            if (!has_bar_[i]) {
+                continue;
+            }
+            incremental::Ticker_State &ticker = market_[i];
+            if (ticker.volatility.count > 0) {
+                double prev_price = ticker.volatility.last_price;
+                double percentage_change = prev_price != 0 ? ((price - prev_price) / prev_price) * 100.0 : 0.0;
+                change_factor_[i] = 1.0 + (percentage_change / 100.0);
+                has_change_[i] = 1;
+            }
+            if (volParsing::push_price(ticker.volatility, price)) {
+                ticker.volatility_sum += ticker.volatility.volatility;
+                ++ticker.volatility_count;
+                has_volatility_[i] = 1;
+            }
+        }
+
+        // Signal step, once per strategy: decisions and allocation shares
+        for (Strategy_Group &group : groups_) {
+            group.buys.clear();
+            group.shares.clear();
+            double total_weight = 0.0;
+            for (size_t i = 0; i < tickers; ++i) {
+                group.decision[i] = kNone;
+                if (!has_volatility_[i]) {
+                    continue;
+                }
+                // Decisions sell a fraction of the invested money, so deciding on 1.0 gives that fraction
+                Stock_Decision decision = decide_stock(market_[i].volatility.volatility, 1.0, group.strategy);
+                if (decision.buy) {
+                    group.decision[i] = kBuy;
+                    group.buys.push_back(i);
+                    const incremental::Ticker_State &ticker = market_[i];
+                    group.shares.push_back(
+                        allocation_weight(ticker.volatility_sum / ticker.volatility_count, group.strategy));
+                    total_weight += group.shares.back();
+                } else if (decision.sell) {
+                    group.decision[i] = kSell;
+                    group.sell_fraction[i] = -decision.adjustment;
+                }
+            }
+            for (double &share : group.shares) {
+                share /= total_weight;
+            }
+        }
+
+        // Account step: every account of every strategy, optionally sharded across the pool
+        for (Strategy_Group &group : groups_) {
+            size_t shards = pool != nullptr ? std::min(group.rows / kRowsPerShard + 1, pool->size() * 4) : 1;
+            if (shards <= 1) {
+                applyBar(group, 0, group.rows);
+                continue;
+            }
+            pool->run(shards, [&](size_t shard) {
+                applyBar(group, shard * group.rows / shards, (shard + 1) * group.rows / shards);
+            });
+        }
+
+        ++hours_processed_;
+    }
+
+    void Multi_Account_Engine::applyBar(Strategy_Group &group, size_t begin_row, size_t end_row) const {
+        size_t tickers = tickers_.size();
+        for (size_t row = begin_row; row < end_row; ++row) {
+            double *holding = group.holdings.data() + row * tickers;
+            double reallocation_funds_hour = 0.0;
+            for (size_t i = 0; i < tickers; ++i) {
+                if (has_change_[i]) {
+                    holding[i] *= change_factor_[i];
+                }
+                if (group.decision[i] == kSell) {
+                    double adjustment = -(holding[i] * group.sell_fraction[i]);
+                    reallocation_funds_hour -= adjustment;
+                    holding[i] += adjustment;
+                }
+            }
+            if (!group.buys.empty() && reallocation_funds_hour > 0) {
+                for (size_t k = 0; k < group.buys.size(); ++k) {
+                    holding[group.buys[k]] += group.shares[k] * reallocation_funds_hour;
+                }
+            }
+        }
+    }
+
+    void Multi_Account_Engine::advance(const std::map<std::string, std::vector<double>> &new_bars, Thread_Pool *pool) {
+        std::vector<const std::vector<double> *> series(tickers_.size(), nullptr);
+        size_t hours = 0;
+        for (size_t i = 0; i < tickers_.size(); ++i) {
+            auto found = new_bars.find(tickers_[i]);
+            if (found != new_bars.end()) {
+                series[i] = &found->second;
+                hours = std::max(hours, found->second.size());
+            }
+        }
+
+        std::vector<double> prices(tickers_.size());
+        for (size_t hour = 0; hour < hours; ++hour) {
+            for (size_t i = 0; i < tickers_.size(); ++i) {
+                prices[i] = series[i] != nullptr && hour < series[i]->size()
+                                ? (*series[i])[hour]
+                                : std::numeric_limits<double>::quiet_NaN();
+            }
+            advanceHour(prices, pool);
+        }
+    }
+
+    double Multi_Account_Engine::holding(size_t account, size_t ticker) const {
+        const Slot &slot = slots_[account];
+        return groups_[slot.group].holdings[slot.row * tickers_.size() + ticker];
+    }
+
+    std::map<std::string, double> Multi_Account_Engine::portfolio(size_t account) const {
+        std::map<std::string, double> result;
+        for (size_t i = 0; i < tickers_.size(); ++i) {
+            result.emplace_hint(result.end(), tickers_[i], holding(account, i));
+        }
+        return result;
+    }
+
+    double Multi_Account_Engine::accountValue(size_t account) const {
+        double total_value = 0.0;
+        for (size_t i = 0; i < tickers_.size(); ++i) {
+            total_value += holding(account, i);
+        }
+        return total_value;
+    }
+
+} // namespace accounts
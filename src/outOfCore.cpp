@@ -0,0 +1,195 @@
+#include "outOfCore.h"
+#include "portfolio_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace outOfCore {
+
+    namespace {
+
+        constexpr char kMagic[8] = { 'V', 'O', 'L', 'B', 'A', 'R', 'S', '1' };
+
+        // Offset of the hour count inside the header, patched by Bar_Store_Writer::close
+        constexpr std::streamoff kHoursOffset = sizeof(kMagic) + sizeof(uint64_t);
+
+        template <typename T>
+        void writeValue(std::ofstream &file, const T &value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+    } // namespace
+
+    Bar_Store_Writer::~Bar_Store_Writer() {
+        if (file_.is_open()) {
+            close();
+        }
+    }
+
+    bool Bar_Store_Writer::open(const std::string &filename, const std::vector<std::string> &tickers) {
+        file_.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+        filename_ = filename;
+        tickers_ = tickers.size();
+        hours_ = 0;
+
+        file_.write(kMagic, sizeof(kMagic));
+        writeValue<uint64_t>(file_, tickers_);
+        writeValue<uint64_t>(file_, hours_);
+        for (const auto &ticker : tickers) {
+            writeValue<uint64_t>(file_, ticker.size());
+            file_.write(ticker.data(), static_cast<std::streamsize>(ticker.size()));
+        }
+        return static_cast<bool>(file_);
+    }
+
+    bool Bar_Store_Writer::appendHour(const std::vector<double> &prices) {
+        if (prices.size() != tickers_) {
+            std::cerr << "Expected " << tickers_ << " prices per hour, got " << prices.size() << std::endl;
+            return false;
+        }
+        file_.write(reinterpret_cast<const char *>(prices.data()),
+                    static_cast<std::streamsize>(prices.size() * sizeof(double)));
+        ++hours_;
+        return static_cast<bool>(file_);
+    }
+
+    bool Bar_Store_Writer::close() {
+        file_.seekp(kHoursOffset);
+        writeValue(file_, hours_);
+        bool ok = static_cast<bool>(file_);
+        file_.close();
+        if (!ok) {
+            std::cerr << "Failed to write bar store: " << filename_ << std::endl;
+        }
+        return ok;
+    }
+
+    bool Bar_Store_Reader::open(const std::string &filename) {
+        file_.open(filename, std::ios::binary);
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+        filename_ = filename;
+
+        char magic[sizeof(kMagic)];
+        uint64_t ticker_count = 0;
+        uint64_t hours = 0;
+        if (!file_.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+            !readValue(file_, ticker_count) || !readValue(file_, hours)) {
+            std::cerr << "Not a bar store (or an unsupported version): " << filename << std::endl;
+            return false;
+        }
+
+        tickers_.clear();
+        for (uint64_t i = 0; i < ticker_count; ++i) {
+            uint64_t size = 0;
+            if (!readValue(file_, size) || size > 256) {
+                std::cerr << "Bar store header is corrupt: " << filename << std::endl;
+                return false;
+            }
+            std::string ticker(size, '\0');
+            if (size > 0 && !file_.read(&ticker[0], static_cast<std::streamsize>(size))) {
+                std::cerr << "Bar store header is corrupt: " << filename << std::endl;
+                return false;
+            }
+            tickers_.push_back(std::move(ticker));
+        }
+        hours_ = hours;
+        next_hour_ = 0;
+        truncated_ = false;
+        return true;
+    }
+
+    size_t Bar_Store_Reader::readChunk(size_t max_hours, std::vector<double> &buffer) {
+        size_t hours = std::min(max_hours, hours_ - next_hour_);
+        if (hours == 0 || tickers_.empty()) {
+            return 0;
+        }
+        buffer.resize(hours * tickers_.size());
+        if (!file_.read(reinterpret_cast<char *>(buffer.data()),
+                        static_cast<std::streamsize>(buffer.size() * sizeof(double)))) {
+            std::cerr << "Bar store is truncated: " << filename_ << std::endl;
+            truncated_ = true;
+            return 0;
+        }
+        next_hour_ += hours;
+        return hours;
+    }
+
+    bool writeStore(const std::string &filename, const std::map<std::string, std::vector<double>> &ticker_to_prices) {
+        std::vector<std::string> tickers;
+        size_t hours = 0;
+        for (const auto &[ticker, prices] : ticker_to_prices) {
+            tickers.push_back(ticker);
+            hours = std::max(hours, prices.size());
+        }
+
+        Bar_Store_Writer writer;
+        if (!writer.open(filename, tickers)) {
+            return false;
+        }
+        std::vector<double> row(tickers.size());
+        for (size_t hour = 0; hour < hours; ++hour) {
+            size_t i = 0;
+            for (const auto &[ticker, prices] : ticker_to_prices) {
+                row[i++] = hour < prices.size() ? prices[hour] : std::numeric_limits<double>::quiet_NaN();
+            }
+            if (!writer.appendHour(row)) {
+                return false;
+            }
+        }
+        return writer.close();
+    }
+
+    Chunked_Result processStore(const std::string &filename, incremental::Engine_State state, size_t chunk_hours,
+                                const metrics::Metrics_Config &metrics_config) {
+        Chunked_Result result;
+        Bar_Store_Reader reader;
+        if (!reader.open(filename)) {
+            result.state = std::move(state);
+            return result;
+        }
+
+        const std::vector<std::string> &tickers = reader.tickers();
+        metrics::Metrics_Engine metrics_engine(metrics_config);
+        std::vector<double> buffer;
+        buffer.reserve(std::max<size_t>(chunk_hours, 1) * tickers.size());
+        result.buffer_bytes = buffer.capacity() * sizeof(double);
+
+        // One reusable map per hour, keyed in store order (which is sorted when written by writeStore)
+        std::map<std::string, double> hour_prices;
+        size_t hours = 0;
+        while ((hours = reader.readChunk(std::max<size_t>(chunk_hours, 1), buffer)) > 0) {
+            ++result.chunks;
+            for (size_t hour = 0; hour < hours; ++hour) {
+                const double *row = buffer.data() + hour * tickers.size();
+                hour_prices.clear();
+                for (size_t i = 0; i < tickers.size(); ++i) {
+                    if (!std::isnan(row[i])) {
+                        hour_prices.emplace(tickers[i], row[i]);
+                    }
+                }
+                incremental::advanceHour(state, hour_prices);
+                metrics_engine.update(portfolio_value(state.portfolio));
+            }
+        }
+
+        result.state = std::move(state);
+        result.metrics = metrics_engine.summary();
+        result.truncated = reader.truncated();
+        return result;
+    }
+
+} // namespace outOfCore
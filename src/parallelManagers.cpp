@@ -0,0 +1,342 @@
+#include "parallelManagers.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace parallel {
+
+    namespace {
+
+        constexpr uint8_t kNone = 0;
+        constexpr uint8_t kBuy = 1;
+        constexpr uint8_t kSell = 2;
+        constexpr size_t kNever = std::numeric_limits<size_t>::max();
+
+        struct Range {
+            size_t begin;
+            size_t end;
+        };
+
+        // A few shards per thread, so a slow shard does not hold up the whole batch
+        size_t shardCount(const Thread_Pool &pool, size_t items) { return std::min(items, pool.size() * 4); }
+
+        Range shardRange(size_t shard, size_t shards, size_t items) {
+            return Range{ shard * items / shards, (shard + 1) * items / shards };
+        }
+
+    } // namespace
+
+    Stock_Manager_Result stockManager(Thread_Pool &pool, const std::map<std::string, std::vector<double>> &stocks,
+                                      std::map<std::string, double> &my_portfolio, const std::string &strategy,
+                                      const std::map<std::string, std::vector<double>> &threshold_scales) {
+        Stock_Manager_Result result;
+
+        size_t max_hours = 0;
+        for (const auto &[stock, volatility_values] : stocks) {
+            max_hours = std::max(max_hours, volatility_values.size());
+        }
+        if (max_hours == 0) {
+            return result;
+        }
+
+        // Flatten the maps once. Map nodes never move, so the holding pointers stay valid while shards write to them
+        size_t tickers = stocks.size();
+        std::vector<const std::string *> names;
+        std::vector<const std::vector<double> *> volatility;
+        std::vector<const std::vector<double> *> scales;
+        std::vector<double *> invested;
+        for (const auto &[stock, volatility_values] : stocks) {
+            names.push_back(&stock);
+            volatility.push_back(&volatility_values);
+            auto found = threshold_scales.find(stock);
+            scales.push_back(found != threshold_scales.end() ? &found->second : nullptr);
+            invested.push_back(&my_portfolio[stock]);
+        }
+
+        // Decisions per hour and ticker, hour-major
+        std::vector<uint8_t> codes(max_hours * tickers, kNone);
+        std::vector<double> adjustments(max_hours * tickers, 0.0);
+
+        size_t shards = shardCount(pool, tickers);
+        pool.run(shards, [&](size_t shard) {
+            Range range = shardRange(shard, shards, tickers);
+            for (size_t hour = 0; hour < max_hours; ++hour) {
+                uint8_t *code_row = codes.data() + hour * tickers;
+                double *adjustment_row = adjustments.data() + hour * tickers;
+                for (size_t i = range.begin; i < range.end; ++i) {
+                    const std::vector<double> &volatility_values = *volatility[i];
+                    double avg_volatility =
+                        hour < volatility_values.size() ? volatility_values[hour] : volatility_values.back();
+                    double threshold_scale = 1.0;
+                    if (scales[i] != nullptr && hour < scales[i]->size()) {
+                        threshold_scale = (*scales[i])[hour];
+                    }
+
+                    Stock_Decision decision = decide_stock(avg_volatility, *invested[i], strategy, threshold_scale);
+                    code_row[i] = decision.buy ? kBuy : (decision.sell ? kSell : kNone);
+                    adjustment_row[i] = decision.adjustment;
+                    *invested[i] += decision.adjustment;
+                }
+            }
+        });
+
+        // Per-hour reduction, in ticker order so the funds are summed exactly as stock_manager sums them
+        result.buying_stocks.resize(max_hours);
+        result.selling_stocks.resize(max_hours);
+        result.reallocation_funds.resize(max_hours);
+        size_t hour_shards = shardCount(pool, max_hours);
+        pool.run(hour_shards, [&](size_t shard) {
+            Range range = shardRange(shard, hour_shards, max_hours);
+            for (size_t hour = range.begin; hour < range.end; ++hour) {
+                const uint8_t *code_row = codes.data() + hour * tickers;
+                const double *adjustment_row = adjustments.data() + hour * tickers;
+                double reallocation_funds_hour = 0.0;
+                for (size_t i = 0; i < tickers; ++i) {
+                    if (code_row[i] == kBuy) {
+                        result.buying_stocks[hour].push_back(*names[i]);
+                    } else if (code_row[i] == kSell) {
+                        reallocation_funds_hour -= adjustment_row[i];
+                        result.selling_stocks[hour].push_back(*names[i]);
+                    }
+                }
+                result.reallocation_funds[hour] = reallocation_funds_hour;
+            }
+        });
+
+        return result;
+    }
+
+    Portfolio_Manager_Result
+    portfolioManager(Thread_Pool &pool, const std::vector<std::vector<std::string>> &buying_stocks,
+                     const std::vector<double> &reallocation_funds, std::map<std::string, double> &my_portfolio,
+                     const std::string &strategy, const std::map<std::string, std::vector<double>> &stocks,
+                     const std::map<std::string, std::vector<double>> &ticker_to_percentage_changes,
+                     const metrics::Metrics_Config &metrics_config, const Selection_Config &selection) {
+        Portfolio_Manager_Result result;
+        if (buying_stocks.empty() || reallocation_funds.empty()) {
+            return result;
+        }
+        size_t hours = buying_stocks.size();
+
+        // Every ticker that is held or a buying candidate, indexed in map order so ticker order matches
+        // portfolio_manager
+        std::map<std::string, size_t> index;
+        for (const auto &[stock, value] : my_portfolio) {
+            index.emplace(stock, 0);
+        }
+        for (const auto &hour_stocks : buying_stocks) {
+            for (const auto &stock : hour_stocks) {
+                index.emplace(stock, 0);
+            }
+        }
+        size_t tickers = index.size();
+        std::vector<const std::string *> names;
+        std::vector<double> initial_value(tickers, 0.0);
+        std::vector<size_t> first_hour(tickers, kNever); // First hour a ticker is in the portfolio
+        std::vector<const std::vector<double> *> percentage_changes(tickers, nullptr);
+        std::vector<const std::vector<double> *> volatility(tickers, nullptr);
+        for (auto &[stock, i] : index) {
+            i = names.size();
+            names.push_back(&stock);
+            auto held = my_portfolio.find(stock);
+            if (held != my_portfolio.end()) {
+                initial_value[i] = held->second;
+                first_hour[i] = 0;
+            }
+            auto changes = ticker_to_percentage_changes.find(stock);
+            if (changes != ticker_to_percentage_changes.end()) {
+                percentage_changes[i] = &changes->second;
+            }
+            auto found = stocks.find(stock);
+            if (found != stocks.end()) {
+                volatility[i] = &found->second;
+            }
+        }
+
+        // Average volatility of every ticker that has volatility data
+        std::vector<double> average_volatility(tickers, 0.0);
+        size_t shards = shardCount(pool, tickers);
+        pool.run(shards, [&](size_t shard) {
+            Range range = shardRange(shard, shards, tickers);
+            for (size_t i = range.begin; i < range.end; ++i) {
+                if (volatility[i] != nullptr) {
+                    double sum = 0.0;
+                    for (double vol : *volatility[i]) {
+                        sum += vol;
+                    }
+                    average_volatility[i] = sum / volatility[i]->size();
+                }
+            }
+        });
+
+        // Each hour's candidates as (position in the buying list, weight), cut to top_k and, with a minimum ticket,
+        // heaped heaviest first. None of that depends on the funds or the holdings, so it runs in parallel by hour
+        auto heavier = [](const std::pair<size_t, double> &a, const std::pair<size_t, double> &b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        };
+        std::vector<std::vector<std::pair<size_t, double>>> hour_candidates(hours);
+        std::vector<uint8_t> missing_volatility(hours, 0);
+        size_t hour_shards = shardCount(pool, hours);
+        pool.run(hour_shards, [&](size_t shard) {
+            Range range = shardRange(shard, hour_shards, hours);
+            for (size_t hour = range.begin; hour < range.end; ++hour) {
+                std::vector<std::pair<size_t, double>> &candidates = hour_candidates[hour];
+                for (size_t c = 0; c < buying_stocks[hour].size(); ++c) {
+                    size_t i = index.find(buying_stocks[hour][c])->second;
+                    if (volatility[i] == nullptr) {
+                        missing_volatility[hour] = 1;
+                    }
+                    candidates.emplace_back(c, allocation_weight(average_volatility[i], strategy));
+                }
+                if (selection.top_k > 0 && candidates.size() > selection.top_k) {
+                    std::nth_element(candidates.begin(), candidates.begin() + (selection.top_k - 1), candidates.end(),
+                                     heavier);
+                    candidates.resize(selection.top_k);
+                }
+                if (selection.min_ticket > 0) {
+                    std::make_heap(candidates.begin(), candidates.end(), lighter_candidate);
+                }
+            }
+        });
+
+        // Funds carried over for lack of a full ticket tie each hour to the one before, so the funds are settled
+        // serially in hour order. An hour costs O(1) without a minimum ticket and O(m log n) with one, for the m
+        // candidates it keeps
+        std::vector<double> hour_funds(hours, 0.0); // Funds split over the candidates; 0 if the hour buys nothing
+        std::vector<double> carried(hours, 0.0);    // Funds carried out of each hour
+        double carried_funds = 0.0;
+        for (size_t hour = 0; hour < hours; ++hour) {
+            double funds = std::max(reallocation_funds[hour], 0.0) + carried_funds;
+            if (!buying_stocks[hour].empty() && funds > 0) {
+                if (missing_volatility[hour]) {
+                    for (const auto &stock : buying_stocks[hour]) {
+                        stocks.at(stock); // Bought without volatility data: fail the same way portfolio_manager does
+                    }
+                }
+                std::vector<std::pair<size_t, double>> &candidates = hour_candidates[hour];
+                if (selection.min_ticket > 0) {
+                    keep_full_tickets(candidates, funds, selection.min_ticket);
+                }
+                if (candidates.empty()) {
+                    carried_funds = funds;
+                } else {
+                    carried_funds = 0.0;
+                    hour_funds[hour] = funds;
+                }
+            } else if (selection.min_ticket > 0) {
+                carried_funds = funds; // Nothing to buy yet, as in portfolio_manager
+            }
+            carried[hour] = carried_funds;
+        }
+        result.unallocated_funds = carried_funds;
+
+        // With the funds known, every hour's allocations are again independent
+        std::vector<std::vector<std::pair<size_t, double>>> hour_allocations(hours);
+        std::vector<double> traded(hours, 0.0);
+        result.allocations.resize(hours);
+        bool reordered = selection.top_k > 0 || selection.min_ticket > 0;
+        pool.run(hour_shards, [&](size_t shard) {
+            Range range = shardRange(shard, hour_shards, hours);
+            for (size_t hour = range.begin; hour < range.end; ++hour) {
+                traded[hour] = std::max(reallocation_funds[hour], 0.0);
+                if (hour_funds[hour] <= 0) {
+                    continue;
+                }
+
+                // Back to buying order, in which portfolio_manager sums the weights and places the allocations
+                std::vector<std::pair<size_t, double>> &candidates = hour_candidates[hour];
+                if (reordered) {
+                    std::sort(candidates.begin(), candidates.end());
+                }
+                double total_weight = 0.0;
+                for (const auto &[position, weight] : candidates) {
+                    total_weight += weight;
+                }
+
+                std::vector<std::pair<size_t, double>> &allocations = hour_allocations[hour];
+                for (const auto &[position, weight] : candidates) {
+                    const std::string &stock = buying_stocks[hour][position];
+                    double allocation = (weight / total_weight) * hour_funds[hour];
+                    allocations.emplace_back(index.find(stock)->second, allocation);
+                    result.allocations[hour][stock] = allocation;
+                    traded[hour] += allocation;
+                }
+
+                // Ticker order, keeping the buy order of repeated tickers, so each shard finds its slice by search
+                std::stable_sort(allocations.begin(), allocations.end(),
+                                 [](const auto &a, const auto &b) { return a.first < b.first; });
+            }
+        });
+
+        // Every ticker follows its own timeline: market change, then its allocations for the hour
+        std::vector<double> values(hours * tickers, 0.0);
+        pool.run(shards, [&](size_t shard) {
+            Range range = shardRange(shard, shards, tickers);
+            std::vector<double> value(initial_value.begin() + range.begin, initial_value.begin() + range.end);
+            for (size_t hour = 0; hour < hours; ++hour) {
+                for (size_t i = range.begin; i < range.end; ++i) {
+                    const std::vector<double> *changes = percentage_changes[i];
+                    if (first_hour[i] != kNever && changes != nullptr && hour < changes->size()) {
+                        value[i - range.begin] *= (1.0 + ((*changes)[hour] / 100.0));
+                    }
+                }
+
+                const auto &allocations = hour_allocations[hour];
+                auto it = std::lower_bound(allocations.begin(), allocations.end(), range.begin,
+                                           [](const auto &a, size_t i) { return a.first < i; });
+                for (; it != allocations.end() && it->first < range.end; ++it) {
+                    value[it->first - range.begin] += it->second;
+                    if (first_hour[it->first] == kNever) {
+                        first_hour[it->first] = hour;
+                    }
+                }
+
+                std::copy(value.begin(), value.end(), values.begin() + hour * tickers + range.begin);
+            }
+        });
+
+        // Snapshots and totals per hour, in ticker order like the portfolio map
+        std::vector<double> hour_value(hours, 0.0);
+        result.portfolio_values.resize(hours);
+        pool.run(hour_shards, [&](size_t shard) {
+            Range range = shardRange(shard, hour_shards, hours);
+            for (size_t hour = range.begin; hour < range.end; ++hour) {
+                const double *row = values.data() + hour * tickers;
+                std::map<std::string, double> &snapshot = result.portfolio_values[hour];
+                double total_value = 0.0;
+                for (size_t i = 0; i < tickers; ++i) {
+                    if (first_hour[i] <= hour) {
+                        snapshot.emplace_hint(snapshot.end(), *names[i], row[i]);
+                        total_value += row[i];
+                    }
+                }
+                hour_value[hour] = total_value;
+            }
+        });
+
+        // Net asset values, fed exactly as portfolio_manager does: holdings plus sale proceeds not yet reallocated,
+        // including those carried to a later hour
+        double pending_funds = 0.0;
+        for (size_t hour = 0; hour < hours; ++hour) {
+            pending_funds += std::max(reallocation_funds[hour], 0.0);
+        }
+        metrics::Metrics_Engine metrics_engine(metrics_config);
+        metrics_engine.update(portfolio_value(my_portfolio) + pending_funds);
+        for (size_t hour = 0; hour < hours; ++hour) {
+            pending_funds -= std::max(reallocation_funds[hour], 0.0);
+            metrics_engine.update(hour_value[hour] + pending_funds + carried[hour], traded[hour]);
+        }
+        result.metrics = metrics_engine.summary();
+
+        const double *last_row = values.data() + (hours - 1) * tickers;
+        for (size_t i = 0; i < tickers; ++i) {
+            if (first_hour[i] != kNever) {
+                my_portfolio[*names[i]] = last_row[i];
+            }
+        }
+
+        return result;
+    }
+
+} // namespace parallel
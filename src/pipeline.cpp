@@ -0,0 +1,240 @@
+#include "pipeline.h"
+#include "volatilityParse.h"
+#include <algorithm>
+#include <iostream>
+
+namespace pipeline {
+
+    uint64_t hashBytes(const void *data, size_t size, uint64_t seed) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(const std::string &value, uint64_t seed) {
+        size_t length = value.size();
+        seed = hashBytes(&length, sizeof(length), seed);
+        return hashBytes(value.data(), value.size(), seed);
+    }
+
+    uint64_t hashSeries(const std::map<std::string, std::vector<double>> &series, uint64_t seed) {
+        for (const auto &[ticker, values] : series) {
+            seed = hashString(ticker, seed);
+            size_t length = values.size();
+            seed = hashBytes(&length, sizeof(length), seed);
+            seed = hashBytes(values.data(), values.size() * sizeof(double), seed);
+        }
+        return seed;
+    }
+
+    uint64_t hashPortfolio(const std::map<std::string, double> &portfolio, uint64_t seed) {
+        for (const auto &[ticker, value] : portfolio) {
+            seed = hashString(ticker, seed);
+            seed = hashBytes(&value, sizeof(value), seed);
+        }
+        return seed;
+    }
+
+    std::vector<double> sliceSeries(const double *values, size_t size, size_t begin, size_t end, bool hold_last) {
+        if (size == 0) {
+            return {};
+        }
+        if (begin >= size) {
+            return hold_last ? std::vector<double>{ values[size - 1] } : std::vector<double>();
+        }
+        return std::vector<double>(values + begin, values + std::min(end, size));
+    }
+
+    namespace {
+
+        // Slices every series of a map, leaving out the ones with nothing in the window
+        std::map<std::string, std::vector<double>> sliceMap(const std::map<std::string, std::vector<double>> &series,
+                                                            size_t begin, size_t end, bool hold_last) {
+            std::map<std::string, std::vector<double>> sliced;
+            for (const auto &[ticker, values] : series) {
+                std::vector<double> window = sliceSeries(values.data(), values.size(), begin, end, hold_last);
+                if (!window.empty()) {
+                    sliced.emplace_hint(sliced.end(), ticker, std::move(window));
+                }
+            }
+            return sliced;
+        }
+
+        double portfolioValue(const std::map<std::string, double> &portfolio) {
+            double total = 0.0;
+            for (const auto &[ticker, value] : portfolio) {
+                total += value;
+            }
+            return total;
+        }
+
+    } // namespace
+
+    StageGraph::StageGraph(size_t max_runs) : max_runs_(std::max<size_t>(max_runs, 1)) {}
+
+    void StageGraph::setPrices(const std::map<std::string, std::vector<double>> &prices) {
+        uint64_t key = hashSeries(prices, hashBytes(nullptr, 0));
+        if (key == prices_key_ && !prices_.empty()) {
+            return;
+        }
+        prices_ = prices;
+        prices_key_ = key;
+        initial_vol_valid_ = false;
+        true_vol_valid_ = false;
+        pct_changes_valid_ = false;
+    }
+
+    const std::map<std::string, double> &StageGraph::initialVolatility() {
+        if (initial_vol_valid_ && initial_vol_stats_.key == prices_key_) {
+            ++initial_vol_stats_.hits;
+            return initial_vol_;
+        }
+        ++initial_vol_stats_.misses;
+        initial_vol_ = volParsing::tickerToVolHourly(prices_);
+        initial_vol_stats_.key = prices_key_;
+        initial_vol_valid_ = true;
+        return initial_vol_;
+    }
+
+    const std::map<std::string, std::vector<double>> &StageGraph::trueVolatility() {
+        const std::map<std::string, double> &initial = initialVolatility();
+        uint64_t key = hashBytes(&initial_vol_stats_.key, sizeof(uint64_t), hashString("true_volatility", 0));
+        if (true_vol_valid_ && true_vol_stats_.key == key) {
+            ++true_vol_stats_.hits;
+            return true_vol_;
+        }
+        ++true_vol_stats_.misses;
+        true_vol_ = volParsing::true_volatility(prices_, initial);
+        true_vol_stats_.key = key;
+        true_vol_valid_ = true;
+        return true_vol_;
+    }
+
+    const std::map<std::string, std::vector<double>> &StageGraph::percentageChanges() {
+        if (pct_changes_valid_ && pct_changes_stats_.key == prices_key_) {
+            ++pct_changes_stats_.hits;
+            return pct_changes_;
+        }
+        ++pct_changes_stats_.misses;
+        pct_changes_ = calculate_percentage_changes(prices_);
+        pct_changes_stats_.key = prices_key_;
+        pct_changes_valid_ = true;
+        return pct_changes_;
+    }
+
+    size_t StageGraph::hours() {
+        // Only a lookup of the stage, so it does not count as a hit
+        const auto &true_vol = true_vol_valid_ ? true_vol_ : trueVolatility();
+        size_t max_hours = 0;
+        for (const auto &[ticker, values] : true_vol) {
+            max_hours = std::max(max_hours, values.size());
+        }
+        return max_hours;
+    }
+
+    const Run_Result &StageGraph::run(const std::string &strategy, const std::map<std::string, double> &portfolio,
+                                      size_t begin, size_t end) {
+        const auto &true_vol = trueVolatility();
+        const auto &pct_changes = percentageChanges();
+
+        uint64_t key = hashBytes(&true_vol_stats_.key, sizeof(uint64_t));
+        key = hashBytes(&pct_changes_stats_.key, sizeof(uint64_t), key);
+        key = hashString(strategy, key);
+        key = hashPortfolio(portfolio, key);
+        key = hashBytes(&begin, sizeof(begin), key);
+        key = hashBytes(&end, sizeof(end), key);
+
+        auto cached = runs_.find(key);
+        if (cached != runs_.end()) {
+            ++runs_stats_.hits;
+            cached->second.last_used = ++run_clock_;
+            return cached->second.result;
+        }
+        ++runs_stats_.misses;
+        runs_stats_.key = key;
+
+        if (runs_.size() >= max_runs_) {
+            auto oldest = std::min_element(runs_.begin(), runs_.end(), [](const auto &a, const auto &b) {
+                return a.second.last_used < b.second.last_used;
+            });
+            runs_.erase(oldest);
+            ++runs_stats_.evictions;
+        }
+
+        std::map<std::string, std::vector<double>> vol_window = sliceMap(true_vol, begin, end, true);
+        std::map<std::string, std::vector<double>> pct_window = sliceMap(pct_changes, begin, end, false);
+
+        Run_Result result;
+        result.final_portfolio = portfolio;
+        result.initial_value = portfolioValue(portfolio);
+        result.stock_result = stock_manager(vol_window, result.final_portfolio, strategy);
+        result.portfolio_result =
+            portfolio_manager(result.stock_result.buying_stocks, result.stock_result.reallocation_funds,
+                              result.final_portfolio, strategy, vol_window, pct_window);
+        result.final_value = portfolioValue(result.final_portfolio);
+
+        Cached_Run &entry = runs_[key];
+        entry.result = std::move(result);
+        entry.last_used = ++run_clock_;
+        return entry.result;
+    }
+
+    const Run_Result &StageGraph::run(const std::string &strategy, const std::map<std::string, double> &portfolio) {
+        return run(strategy, portfolio, 0, hours());
+    }
+
+    std::vector<Stage_Stats> StageGraph::stats() const {
+        Stage_Stats prices_stats{ "prices", prices_key_ };
+        return { prices_stats, initial_vol_stats_, true_vol_stats_, pct_changes_stats_, runs_stats_ };
+    }
+
+    void StageGraph::clearRuns() { runs_.clear(); }
+
+    std::vector<Walk_Forward_Window> walkForward(StageGraph &graph, const Walk_Forward_Config &config) {
+        std::vector<Walk_Forward_Window> windows;
+        if (config.train_hours == 0 || config.test_hours == 0 || config.strategies.empty()) {
+            std::cerr << "Walk-forward needs non-empty train/test windows and at least one strategy" << std::endl;
+            return windows;
+        }
+
+        size_t step = config.step_hours == 0 ? config.test_hours : config.step_hours;
+        size_t hours = graph.hours();
+
+        // Every window starts from the same equally split portfolio
+        std::map<std::string, double> start_portfolio;
+        const auto &true_vol = graph.trueVolatility();
+        for (const auto &[ticker, values] : true_vol) {
+            start_portfolio[ticker] = config.initial_investment / true_vol.size();
+        }
+
+        for (size_t train_begin = 0; train_begin + config.train_hours + config.test_hours <= hours;
+             train_begin += step) {
+            Walk_Forward_Window window;
+            window.train_begin = train_begin;
+            window.test_begin = train_begin + config.train_hours;
+            window.test_end = window.test_begin + config.test_hours;
+
+            bool first = true;
+            for (const auto &strategy : config.strategies) {
+                const Run_Result &train = graph.run(strategy, start_portfolio, window.train_begin, window.test_begin);
+                double train_return = train.final_value / train.initial_value - 1.0;
+                if (first || train_return > window.train_return) {
+                    window.strategy = strategy;
+                    window.train_return = train_return;
+                    first = false;
+                }
+            }
+
+            const Run_Result &test = graph.run(window.strategy, start_portfolio, window.test_begin, window.test_end);
+            window.test_return = test.final_value / test.initial_value - 1.0;
+            windows.push_back(window);
+        }
+
+        return windows;
+    }
+
+} // namespace pipeline
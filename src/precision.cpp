@@ -0,0 +1,67 @@
+#include "precision.h"
+#include "stock_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace precision {
+
+    Accuracy_Report compareToDouble(const std::map<std::string, std::vector<double>> &ticker_to_prices,
+                                    const std::string &strategy) {
+        Accuracy_Report report;
+
+        for (const auto &[ticker, prices] : ticker_to_prices) {
+            std::vector<float> prices_float(prices.begin(), prices.end());
+            for (size_t i = 0; i < prices.size(); ++i) {
+                if (prices[i] != 0) {
+                    report.max_rel_error_price =
+                        std::max(report.max_rel_error_price, std::abs((prices_float[i] - prices[i]) / prices[i]));
+                }
+            }
+
+            std::vector<double> volatility = trueVolatility(prices);
+            std::vector<float> volatility_float = trueVolatility(prices_float);
+            for (size_t i = 0; i < volatility.size(); ++i) {
+                double error = std::abs(volatility_float[i] - volatility[i]);
+                report.max_abs_error_volatility = std::max(report.max_abs_error_volatility, error);
+                if (volatility[i] != 0) {
+                    report.max_rel_error_volatility =
+                        std::max(report.max_rel_error_volatility, error / std::abs(volatility[i]));
+                }
+
+                // Invested money does not change which branch is taken, only the adjustment size
+                Stock_Decision exact = decide_stock(volatility[i], 1.0, strategy);
+                Stock_Decision approx = decide_stock(volatility_float[i], 1.0, strategy);
+                ++report.decisions;
+                if (exact.buy != approx.buy || exact.sell != approx.sell || exact.adjustment != approx.adjustment) {
+                    ++report.decision_mismatches;
+                }
+            }
+
+            std::vector<double> changes = percentageChanges(prices);
+            std::vector<float> changes_float = percentageChanges(prices_float);
+            for (size_t i = 0; i < changes.size(); ++i) {
+                report.max_abs_error_percentage =
+                    std::max(report.max_abs_error_percentage, std::abs(changes_float[i] - changes[i]));
+            }
+
+            size_t values = prices.size() + volatility.size() + changes.size();
+            report.bytes_double += values * sizeof(double);
+            report.bytes_float += values * sizeof(float);
+        }
+
+        return report;
+    }
+
+    void printReport(const Accuracy_Report &report) {
+        std::cout << "Float vs double storage:\n";
+        std::cout << "  Max relative price rounding: " << report.max_rel_error_price << "\n";
+        std::cout << "  Max volatility error: " << report.max_abs_error_volatility << " (relative "
+                  << report.max_rel_error_volatility << ")\n";
+        std::cout << "  Max percentage change error: " << report.max_abs_error_percentage << " points\n";
+        std::cout << "  Decision mismatches: " << report.decision_mismatches << " of " << report.decisions << "\n";
+        std::cout << "  Memory: " << report.bytes_double << " bytes as double, " << report.bytes_float
+                  << " bytes as float\n";
+    }
+
+} // namespace precision
@@ -0,0 +1,133 @@
+#include "rangeIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rangeIndex {
+
+    Range_Index::Range_Index(const std::vector<double> &values) {
+        prefix_sum_.reserve(values.size() + 1);
+        for (double value : values) {
+            append(value);
+        }
+    }
+
+    void Range_Index::append(double value) {
+        if (size() == 0) {
+            shift_ = value;
+        }
+        double shifted = value - shift_;
+        prefix_sum_.push_back(prefix_sum_.back() + shifted);
+
+        // The new value completes an aligned block at every level 2^k that divides the size; its two halves have the
+        // same count c, so the merge adds delta^2 * c / 2
+        size_t n = size();
+        if (moments_.empty()) {
+            moments_.emplace_back();
+        }
+        moments_[0].push_back(Moments{ shifted, 0.0 });
+        for (size_t k = 1; n % (size_t(1) << k) == 0; ++k) {
+            if (moments_.size() == k) {
+                moments_.emplace_back();
+            }
+            const Moments &left = moments_[k - 1][moments_[k - 1].size() - 2];
+            const Moments &right = moments_[k - 1].back();
+            double delta = right.mean - left.mean;
+            double half = static_cast<double>(size_t(1) << (k - 1));
+            moments_[k].push_back(Moments{ left.mean + delta / 2, left.m2 + right.m2 + delta * delta * half / 2 });
+        }
+
+        // The new value ends one new window at every level of the sparse table
+        if (min_table_.empty()) {
+            min_table_.emplace_back();
+            max_table_.emplace_back();
+        }
+        min_table_[0].push_back(value);
+        max_table_[0].push_back(value);
+        for (size_t k = 1; (size_t(1) << k) <= n; ++k) {
+            if (min_table_.size() == k) {
+                min_table_.emplace_back();
+                max_table_.emplace_back();
+            }
+            size_t half = size_t(1) << (k - 1);
+            size_t i = n - (size_t(1) << k);
+            min_table_[k].push_back(std::min(min_table_[k - 1][i], min_table_[k - 1][i + half]));
+            max_table_[k].push_back(std::max(max_table_[k - 1][i], max_table_[k - 1][i + half]));
+        }
+    }
+
+    size_t Range_Index::log2Floor(size_t n) {
+        size_t log = 0;
+        while (n >>= 1) {
+            ++log;
+        }
+        return log;
+    }
+
+    bool Range_Index::clamp(size_t &begin, size_t &end) const {
+        end = std::min(end, size());
+        return begin < end;
+    }
+
+    double Range_Index::sum(size_t begin, size_t end) const {
+        if (!clamp(begin, end)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return prefix_sum_[end] - prefix_sum_[begin] + shift_ * (end - begin);
+    }
+
+    double Range_Index::mean(size_t begin, size_t end) const {
+        if (!clamp(begin, end)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return (prefix_sum_[end] - prefix_sum_[begin]) / (end - begin) + shift_;
+    }
+
+    double Range_Index::variance(size_t begin, size_t end) const {
+        if (!clamp(begin, end) || end - begin < 2) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        // Walk the window in the largest aligned blocks that fit, merging each into the running count, mean and M2
+        double count = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        for (size_t position = begin; position < end;) {
+            size_t k = log2Floor(end - position);
+            while (position % (size_t(1) << k) != 0) {
+                --k;
+            }
+            const Moments &block = moments_[k][position >> k];
+            double block_count = static_cast<double>(size_t(1) << k);
+            double total = count + block_count;
+            double delta = block.mean - mean;
+            mean += delta * block_count / total;
+            m2 += block.m2 + delta * delta * count * block_count / total;
+            count = total;
+            position += size_t(1) << k;
+        }
+        return m2 / (count - 1);
+    }
+
+    double Range_Index::min(size_t begin, size_t end) const {
+        if (!clamp(begin, end)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        size_t k = log2Floor(end - begin);
+        return std::min(min_table_[k][begin], min_table_[k][end - (size_t(1) << k)]);
+    }
+
+    double Range_Index::max(size_t begin, size_t end) const {
+        if (!clamp(begin, end)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        size_t k = log2Floor(end - begin);
+        return std::max(max_table_[k][begin], max_table_[k][end - (size_t(1) << k)]);
+    }
+
+    Ticker_Range_Index::Ticker_Range_Index(const std::map<std::string, std::vector<double>> &series) {
+        for (const auto &[ticker, values] : series) {
+            indexes_.emplace(ticker, Range_Index(values));
+        }
+    }
+
+} // namespace rangeIndex
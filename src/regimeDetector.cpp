@@ -0,0 +1,101 @@
+#include "regimeDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace regime {
+
+    namespace {
+
+        // Keeps variances away from zero so a flat stretch cannot make one regime infinitely sharp
+        constexpr double kMinVariance = 1e-4;
+
+        double logVolatility(double volatility) { return std::log(std::max(volatility, 1e-12)); }
+
+    } // namespace
+
+    Regime_Detector::Regime_Detector(size_t tickers, const Regime_Config &config)
+        : config_(config), states_(tickers), warmup_sum_(tickers, 0.0), warmup_square_(tickers, 0.0) {}
+
+    void Regime_Detector::update(size_t ticker, double volatility) {
+        Regime_State &s = states_[ticker];
+        double x = logVolatility(volatility);
+        ++s.count;
+
+        // Warmup: gather the mean and spread, then seed the calm regime at the mean and the turbulent regime two
+        // deviations above it
+        if (s.count <= config_.warmup) {
+            warmup_sum_[ticker] += x;
+            warmup_square_[ticker] += x * x;
+            if (s.count == config_.warmup) {
+                double n = static_cast<double>(s.count);
+                double mean = warmup_sum_[ticker] / n;
+                double variance = std::max(kMinVariance, warmup_square_[ticker] / n - mean * mean);
+                double spread = std::sqrt(variance);
+                s.mean[0] = mean;
+                s.mean[1] = mean + 2.0 * spread;
+                s.variance[0] = variance;
+                s.variance[1] = variance;
+                s.p_turbulent = 0.0;
+            }
+            return;
+        }
+
+        // Predict
+        double stay = config_.stay_probability;
+        double prior = s.p_turbulent * stay + (1.0 - s.p_turbulent) * (1.0 - stay);
+
+        // Update: posterior odds from the log-likelihood ratio of the two Gaussians
+        double d0 = x - s.mean[0];
+        double d1 = x - s.mean[1];
+        double log_ratio = -0.5 * (d1 * d1 / s.variance[1] - d0 * d0 / s.variance[0]) -
+                           0.5 * std::log(s.variance[1] / s.variance[0]);
+        double log_odds = log_ratio + std::log(std::max(prior, 1e-12) / std::max(1.0 - prior, 1e-12));
+        log_odds = std::clamp(log_odds, -50.0, 50.0);
+        s.p_turbulent = 1.0 / (1.0 + std::exp(-log_odds));
+
+        // Adapt each regime toward the observation in proportion to its responsibility
+        double weight[2] = { config_.adaptation * (1.0 - s.p_turbulent), config_.adaptation * s.p_turbulent };
+        double delta[2] = { d0, d1 };
+        for (int k = 0; k < 2; ++k) {
+            s.mean[k] += weight[k] * delta[k];
+            s.variance[k] = std::max(kMinVariance, s.variance[k] + weight[k] * (delta[k] * delta[k] - s.variance[k]));
+        }
+
+        // Keep regime 0 the calm one
+        if (s.mean[0] > s.mean[1]) {
+            std::swap(s.mean[0], s.mean[1]);
+            std::swap(s.variance[0], s.variance[1]);
+            s.p_turbulent = 1.0 - s.p_turbulent;
+        }
+    }
+
+    double Regime_Detector::thresholdScale(size_t ticker) const {
+        const Regime_State &s = states_[ticker];
+        if (s.count < config_.warmup || config_.warmup == 0) {
+            return 1.0;
+        }
+        double scale = std::exp(s.mean[0]) / config_.reference_volatility;
+        if (s.p_turbulent > 0.5) {
+            scale *= config_.turbulent_tightening;
+        }
+        return std::clamp(scale, config_.min_scale, config_.max_scale);
+    }
+
+    std::map<std::string, std::vector<double>>
+    thresholdScales(const std::map<std::string, std::vector<double>> &true_volatility, const Regime_Config &config) {
+        std::map<std::string, std::vector<double>> scales;
+        Regime_Detector detector(1, config);
+        for (const auto &[ticker, volatility] : true_volatility) {
+            detector = Regime_Detector(1, config);
+            std::vector<double> &ticker_scales = scales[ticker];
+            ticker_scales.reserve(volatility.size());
+            for (double value : volatility) {
+                detector.update(0, value);
+                ticker_scales.push_back(detector.thresholdScale(0));
+            }
+        }
+        return scales;
+    }
+
+} // namespace regime
@@ -0,0 +1,349 @@
+#include "replay.h"
+#include "portfolio_manager.h"
+#include "stock_manager.h"
+#include "volatilityParse.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace replay {
+
+    // ---------------------------------------------------------------------
+    // Latency histogram
+    // ---------------------------------------------------------------------
+
+    size_t Latency_Histogram::bucketOf(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        // Position of the highest set bit picks the power of two, the next 5 bits pick the sub-bucket
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - 5;
+        size_t sub = static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+        return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+    }
+
+    uint64_t Latency_Histogram::bucketUpperBound(size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        size_t shift = bucket / kSubBuckets - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    void Latency_Histogram::record(uint64_t nanoseconds) {
+        ++counts_[std::min(bucketOf(nanoseconds), kBuckets - 1)];
+        ++count_;
+        sum_ += nanoseconds;
+        min_ = std::min(min_, nanoseconds);
+        max_ = std::max(max_, nanoseconds);
+    }
+
+    uint64_t Latency_Histogram::percentile(double p) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * count_ + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, count_));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            seen += counts_[bucket];
+            if (seen >= rank) {
+                return std::min(bucketUpperBound(bucket), max_);
+            }
+        }
+        return max_;
+    }
+
+    void Latency_Histogram::merge(const Latency_Histogram &other) {
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            counts_[bucket] += other.counts_[bucket];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    // ---------------------------------------------------------------------
+    // Socket helpers
+    // ---------------------------------------------------------------------
+
+    namespace {
+
+        int64_t nowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        bool writeAll(int fd, const void *data, size_t size) {
+            const char *bytes = static_cast<const char *>(data);
+            while (size > 0) {
+                ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        bool readAll(int fd, void *data, size_t size) {
+            char *bytes = static_cast<char *>(data);
+            while (size > 0) {
+                ssize_t received = ::recv(fd, bytes, size, 0);
+                if (received < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (received <= 0) {
+                    return false;
+                }
+                bytes += received;
+                size -= static_cast<size_t>(received);
+            }
+            return true;
+        }
+
+        bool makeAddress(const std::string &path, sockaddr_un &address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                std::cerr << "Socket path too long: " << path << std::endl;
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size());
+            return true;
+        }
+
+    } // namespace
+
+    // ---------------------------------------------------------------------
+    // Server
+    // ---------------------------------------------------------------------
+
+    bool serveReplay(const Replay_Config &config, const std::map<std::string, std::vector<double>> &ticker_to_prices) {
+        sockaddr_un address;
+        if (!makeAddress(config.socket_path, address)) {
+            return false;
+        }
+
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            std::cerr << "Failed to create socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        ::unlink(config.socket_path.c_str());
+        if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, 1) != 0) {
+            std::cerr << "Failed to listen on " << config.socket_path << ": " << std::strerror(errno) << std::endl;
+            ::close(listener);
+            return false;
+        }
+
+        int client = ::accept(listener, nullptr, nullptr);
+        ::close(listener);
+        ::unlink(config.socket_path.c_str());
+        if (client < 0) {
+            std::cerr << "Failed to accept replay client: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // Handshake: ticker count followed by length-prefixed names
+        std::vector<const std::vector<double> *> series;
+        uint32_t ticker_count = static_cast<uint32_t>(ticker_to_prices.size());
+        bool ok = writeAll(client, &ticker_count, sizeof(ticker_count));
+        size_t max_hours = 0;
+        for (const auto &[ticker, prices] : ticker_to_prices) {
+            uint32_t length = static_cast<uint32_t>(ticker.size());
+            ok = ok && writeAll(client, &length, sizeof(length)) && writeAll(client, ticker.data(), ticker.size());
+            series.push_back(&prices);
+            max_hours = std::max(max_hours, prices.size());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t hour = 0; ok && hour < max_hours; ++hour) {
+            if (config.speed > 0.0) {
+                auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(hour * config.bar_seconds / config.speed));
+                std::this_thread::sleep_until(due);
+            }
+
+            // Find the last ticker that has a bar this hour so it can carry the end-of-hour flag
+            size_t last = series.size();
+            for (size_t i = 0; i < series.size(); ++i) {
+                if (hour < series[i]->size()) {
+                    last = i;
+                }
+            }
+
+            for (size_t i = 0; ok && i < series.size(); ++i) {
+                if (hour >= series[i]->size()) {
+                    continue;
+                }
+                Bar_Message bar{};
+                bar.ticker = static_cast<uint32_t>(i);
+                bar.hour = static_cast<uint32_t>(hour);
+                bar.price = (*series[i])[hour];
+                bar.flags = i == last ? kLastInHour : 0;
+                bar.send_ns = nowNs();
+                ok = writeAll(client, &bar, sizeof(bar));
+            }
+        }
+
+        Bar_Message end{};
+        end.flags = kEndOfStream;
+        end.send_ns = nowNs();
+        ok = ok && writeAll(client, &end, sizeof(end));
+
+        ::close(client);
+        if (!ok) {
+            std::cerr << "Replay client disconnected early" << std::endl;
+        }
+        return ok;
+    }
+
+    // ---------------------------------------------------------------------
+    // Client
+    // ---------------------------------------------------------------------
+
+    bool runReplayClient(const std::string &socket_path, const std::string &strategy,
+                         const std::map<std::string, double> &my_portfolio, Replay_Report &report) {
+        sockaddr_un address;
+        if (!makeAddress(socket_path, address)) {
+            return false;
+        }
+
+        // The server may still be starting up, so retry for a couple of seconds
+        int fd = -1;
+        for (int attempt = 0; attempt < 200; ++attempt) {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) {
+                break;
+            }
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (fd < 0) {
+            std::cerr << "Failed to connect to replay server at " << socket_path << std::endl;
+            return false;
+        }
+
+        uint32_t ticker_count = 0;
+        if (!readAll(fd, &ticker_count, sizeof(ticker_count))) {
+            ::close(fd);
+            return false;
+        }
+        std::vector<std::string> tickers(ticker_count);
+        for (auto &ticker : tickers) {
+            uint32_t length = 0;
+            if (!readAll(fd, &length, sizeof(length))) {
+                ::close(fd);
+                return false;
+            }
+            ticker.resize(length);
+            if (!readAll(fd, &ticker[0], length)) {
+                ::close(fd);
+                return false;
+            }
+        }
+
+        // Per-ticker state, indexed like the handshake so the hot path never touches a std::map
+        std::vector<volParsing::Volatility_State> volatility(ticker_count);
+        std::vector<double> volatility_sum(ticker_count, 0.0);
+        std::vector<size_t> volatility_count(ticker_count, 0);
+        std::vector<double> holdings(ticker_count, 0.0);
+        for (uint32_t i = 0; i < ticker_count; ++i) {
+            auto it = my_portfolio.find(tickers[i]);
+            holdings[i] = it == my_portfolio.end() ? 0.0 : it->second;
+        }
+
+        std::vector<uint32_t> buying_stocks_hour;
+        buying_stocks_hour.reserve(ticker_count);
+        double reallocation_funds_hour = 0.0;
+
+        report = Replay_Report{};
+        bool ok = false;
+        Bar_Message bar;
+        while (readAll(fd, &bar, sizeof(bar))) {
+            int64_t received_ns = nowNs();
+            if (bar.flags & kEndOfStream) {
+                ok = true;
+                break;
+            }
+            if (bar.ticker >= ticker_count) {
+                std::cerr << "Replay bar for unknown ticker index " << bar.ticker << std::endl;
+                break;
+            }
+
+            uint32_t i = bar.ticker;
+            volParsing::Volatility_State &state = volatility[i];
+
+            // Market change since the previous bar, as portfolio_manager applies it
+            if (state.count > 0 && state.last_price != 0) {
+                holdings[i] *= bar.price / state.last_price;
+            }
+
+            // Decisions start once the ticker has a true volatility value, like stock_manager's input
+            if (volParsing::push_price(state, bar.price)) {
+                volatility_sum[i] += state.volatility;
+                ++volatility_count[i];
+
+                Stock_Decision decision = decide_stock(state.volatility, holdings[i], strategy);
+                if (decision.buy) {
+                    buying_stocks_hour.push_back(i);
+                } else if (decision.sell) {
+                    reallocation_funds_hour -= decision.adjustment;
+                }
+                holdings[i] += decision.adjustment;
+            }
+
+            if (bar.flags & kLastInHour) {
+                // Reallocate the freed funds across this hour's buys with the portfolio_manager weights
+                if (!buying_stocks_hour.empty() && reallocation_funds_hour > 0) {
+                    double total_weight = 0.0;
+                    for (uint32_t stock : buying_stocks_hour) {
+                        total_weight += allocation_weight(volatility_sum[stock] / volatility_count[stock], strategy);
+                    }
+                    for (uint32_t stock : buying_stocks_hour) {
+                        double weight = allocation_weight(volatility_sum[stock] / volatility_count[stock], strategy);
+                        holdings[stock] += weight / total_weight * reallocation_funds_hour;
+                    }
+                }
+                buying_stocks_hour.clear();
+                reallocation_funds_hour = 0.0;
+                ++report.hours;
+            }
+
+            int64_t delivery = received_ns - bar.send_ns;
+            int64_t latency = nowNs() - received_ns;
+            report.delivery.record(delivery > 0 ? static_cast<uint64_t>(delivery) : 0);
+            report.latency.record(latency > 0 ? static_cast<uint64_t>(latency) : 0);
+            ++report.bars;
+        }
+        ::close(fd);
+
+        for (uint32_t i = 0; i < ticker_count; ++i) {
+            report.final_portfolio[tickers[i]] = holdings[i];
+        }
+        if (!ok) {
+            std::cerr << "Replay stream ended without an end-of-stream marker" << std::endl;
+        }
+        return ok;
+    }
+
+} // namespace replay
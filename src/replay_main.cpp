@@ -0,0 +1,120 @@
+#include "extractor.h"
+#include "replay.h"
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Prints the minimum, mean, percentiles and maximum of a latency histogram.
+ */
+void print_histogram(const std::string &title, const replay::Latency_Histogram &histogram) {
+    std::cout << title << "\n";
+    std::cout << "  min:   " << histogram.min() << "\n";
+    std::cout << "  mean:  " << histogram.mean() << "\n";
+    std::cout << "  p50:   " << histogram.percentile(50.0) << "\n";
+    std::cout << "  p99:   " << histogram.percentile(99.0) << "\n";
+    std::cout << "  p99.9: " << histogram.percentile(99.9) << "\n";
+    std::cout << "  max:   " << histogram.max() << "\n";
+}
+
+/**
+ * @brief Parses a finite number that is positive, or also zero if allowed, the same way main's parse_capital does.
+ *
+ * @param text The argument.
+ * @param allow_zero True to accept 0.
+ * @param number Set to the value if it parses.
+ * @return False if the argument is not such a number.
+ */
+bool parse_number(const std::string &text, bool allow_zero, double &number) {
+    try {
+        size_t used = 0;
+        double value = std::stod(text, &used);
+        if (used != text.size() || !std::isfinite(value) || value < 0 || (value == 0 && !allow_zero)) {
+            throw std::invalid_argument("Out of range");
+        }
+        number = value;
+        return true;
+    } catch (std::exception &) {
+        return false;
+    }
+}
+
+/**
+ * @brief Prints the command line of volatility_replay.
+ */
+void print_usage(const char *program) {
+    std::cerr << "Usage: " << program << " <prices.csv> [speed] [strategy] [investment]\n";
+    std::cerr << "  speed: 0 = as fast as possible (default), 1 = real time, N = N times real time\n";
+}
+
+/**
+ * @brief Replays a saved price CSV through a local socket and reports tick-to-decision latency.
+ *
+ * Usage: volatility_replay <prices.csv> [speed] [strategy] [investment]
+ *
+ * The server and the client run in the same process on separate threads and talk over a Unix domain socket. The
+ * decision latency starts when a bar is read, so it is the same at every speed; the delivery time covers the socket
+ * hop and, at speed 0, the backlog of bars the server has already written.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    replay::Replay_Config config;
+    double initial_investment = 20000.0;
+    if (argc > 2 && !parse_number(argv[2], true, config.speed)) {
+        std::cerr << "Invalid speed: " << argv[2] << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (argc > 4 && !parse_number(argv[4], false, initial_investment)) {
+        std::cerr << "Invalid investment: " << argv[4] << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    std::string strategy = argc > 3 ? argv[3] : "neutral";
+
+    std::map<std::string, std::vector<double>> ticker_to_prices;
+    if (!extractor::loadFromCsv(argv[1], ticker_to_prices) || ticker_to_prices.empty()) {
+        std::cerr << "No prices loaded from " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Same equal split as create_portfolio in main
+    std::map<std::string, double> my_portfolio;
+    for (const auto &[ticker, prices] : ticker_to_prices) {
+        my_portfolio[ticker] = initial_investment / ticker_to_prices.size();
+    }
+
+    bool served = false;
+    std::thread server([&]() { served = replay::serveReplay(config, ticker_to_prices); });
+
+    replay::Replay_Report report;
+    bool consumed = replay::runReplayClient(config.socket_path, strategy, my_portfolio, report);
+    server.join();
+
+    if (!served || !consumed) {
+        return 1;
+    }
+
+    double final_value = 0.0;
+    for (const auto &[ticker, value] : report.final_portfolio) {
+        final_value += value;
+    }
+
+    std::cout << "Bars: " << report.bars << ", hours: " << report.hours << "\n";
+    print_histogram("Decision latency, bar received to decision done (ns):", report.latency);
+    print_histogram("Delivery, server send to bar received (ns):", report.delivery);
+    if (config.speed <= 0.0) {
+        std::cout << "  (at speed 0 delivery is mostly time queued in the socket buffer)\n";
+    }
+    std::cout << "Final portfolio value: $" << final_value << "\n";
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "riskMetrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace metrics {
+
+    Metrics_Engine::Metrics_Engine(const Metrics_Config &config) : config_(config) {}
+
+    void Metrics_Engine::update(double portfolio_value, double traded) {
+        ++bars_;
+        traded_ += traded;
+        value_sum_ += portfolio_value;
+
+        if (bars_ == 1) {
+            first_value_ = portfolio_value;
+            last_value_ = portfolio_value;
+            peak_value_ = portfolio_value;
+            return;
+        }
+
+        double r = last_value_ != 0 ? portfolio_value / last_value_ - 1.0 : 0.0;
+        last_value_ = portfolio_value;
+
+        // Drawdown
+        peak_value_ = std::max(peak_value_, portfolio_value);
+        if (peak_value_ > 0) {
+            max_drawdown_ = std::max(max_drawdown_, 1.0 - portfolio_value / peak_value_);
+        }
+
+        // Welford update of the mean and variance, plus the downside square sum below the risk-free rate
+        ++returns_;
+        double delta = r - mean_;
+        mean_ += delta / static_cast<double>(returns_);
+        m2_ += delta * (r - mean_);
+        double excess = r - config_.risk_free_rate / config_.periods_per_year;
+        if (excess < 0) {
+            downside_square_ += excess * excess;
+        }
+
+        if (!config_.tail_metrics) {
+            return;
+        }
+
+        // Insert into the tail or the body, then move the boundary so the tail holds exactly the worst k returns
+        if (!tail_.empty() && r <= tail_.top()) {
+            tail_.push(r);
+            tail_sum_ += r;
+        } else {
+            body_.push(r);
+        }
+        size_t k = static_cast<size_t>(std::ceil((1.0 - config_.var_confidence) * static_cast<double>(returns_)));
+        k = std::max<size_t>(k, 1);
+        while (tail_.size() > k) {
+            tail_sum_ -= tail_.top();
+            body_.push(tail_.top());
+            tail_.pop();
+        }
+        while (tail_.size() < k && !body_.empty()) {
+            tail_sum_ += body_.top();
+            tail_.push(body_.top());
+            body_.pop();
+        }
+    }
+
+    Metrics_Summary Metrics_Engine::summary() const {
+        Metrics_Summary s;
+        s.bars = bars_;
+        s.last_value = last_value_;
+        s.peak_value = peak_value_;
+        s.current_drawdown = peak_value_ > 0 ? 1.0 - last_value_ / peak_value_ : 0.0;
+        s.max_drawdown = max_drawdown_;
+        s.total_return = first_value_ != 0 ? last_value_ / first_value_ - 1.0 : 0.0;
+        s.traded = traded_;
+        s.turnover = value_sum_ > 0 ? traded_ / (2.0 * value_sum_ / static_cast<double>(bars_)) : 0.0;
+
+        if (returns_ == 0) {
+            return s;
+        }
+
+        double annualize = std::sqrt(config_.periods_per_year);
+        double excess_mean = mean_ - config_.risk_free_rate / config_.periods_per_year;
+        double deviation = returns_ > 1 ? std::sqrt(m2_ / static_cast<double>(returns_ - 1)) : 0.0;
+        double downside = std::sqrt(downside_square_ / static_cast<double>(returns_));
+
+        s.mean_return = mean_;
+        s.realized_volatility = deviation * annualize;
+        s.sharpe = deviation > 0 ? excess_mean / deviation * annualize : 0.0;
+        s.sortino = downside > 0 ? excess_mean / downside * annualize : 0.0;
+        if (!tail_.empty()) {
+            s.value_at_risk = -tail_.top();
+            s.expected_shortfall = -tail_sum_ / static_cast<double>(tail_.size());
+        }
+        return s;
+    }
+
+} // namespace metrics
@@ -0,0 +1,552 @@
+#include "seriesCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace codec {
+
+    namespace {
+
+        constexpr char kMagic[8] = { 'V', 'O', 'L', 'C', 'O', 'D', 'C', '1' };
+
+        constexpr uint32_t kValueColumn = 1;
+        constexpr uint32_t kTimeColumn = 2;
+
+        // Zero bytes after every bit stream. The reader loads ahead of its position and one value reads at most 77
+        // bits, so even a corrupt stream, caught after the value, never loads past the padding
+        constexpr size_t kPadding = 24;
+
+        struct Column_Header {
+            uint32_t kind;
+            uint32_t blocks;
+            uint64_t count;
+        };
+
+        struct Block_Header {
+            uint32_t values;
+            uint32_t bytes; // Bit stream plus padding
+        };
+
+        template <typename T>
+        void appendValue(std::vector<uint8_t> &out, const T &value) {
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        void writeValue(std::ofstream &file, const T &value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+        /**
+         * @brief Appends bits most significant first.
+         */
+        class Bit_Writer {
+          public:
+            explicit Bit_Writer(std::vector<uint8_t> &out) : out_(out) {}
+
+            // count <= 64
+            void write(uint64_t value, unsigned count) {
+                if (count > 32) {
+                    write(value >> 32, count - 32);
+                    value &= 0xFFFFFFFFULL;
+                    count = 32;
+                }
+                if (count == 0) {
+                    return;
+                }
+                // Fewer than 8 pending bits, so at most 40 bits are in use after the shift
+                pending_ = (pending_ << count) | (value & ((1ULL << count) - 1));
+                pending_bits_ += count;
+                while (pending_bits_ >= 8) {
+                    pending_bits_ -= 8;
+                    out_.push_back(static_cast<uint8_t>(pending_ >> pending_bits_));
+                }
+            }
+
+            void finish() {
+                if (pending_bits_ > 0) {
+                    out_.push_back(static_cast<uint8_t>(pending_ << (8 - pending_bits_)));
+                    pending_bits_ = 0;
+                }
+                out_.insert(out_.end(), kPadding, 0);
+            }
+
+          private:
+            std::vector<uint8_t> &out_;
+            uint64_t pending_ = 0;
+            unsigned pending_bits_ = 0;
+        };
+
+        /**
+         * @brief Reads bits most significant first from a 64-bit register.
+         *
+         * refill() tops the register up to at least 56 bits with one unaligned load and no branch, so the decoders
+         * refill once or twice per value and never branch on how many bits are left.
+         */
+        class Bit_Reader {
+          public:
+            explicit Bit_Reader(const uint8_t *data) : data_(data), next_(data) {}
+
+            void refill() {
+                uint64_t word;
+                std::memcpy(&word, next_, sizeof(word));
+                buffer_ |= __builtin_bswap64(word) >> available_;
+                next_ += (63 - available_) >> 3;
+                available_ |= 56;
+            }
+
+            // Next count bits without consuming them, 1 <= count <= bits available
+            uint64_t peek(unsigned count) const { return buffer_ >> (64 - count); }
+
+            // count <= bits available
+            void skip(unsigned count) {
+                buffer_ <<= count;
+                available_ -= count;
+            }
+
+            // 0 <= count <= bits available; shifting by 1 first keeps count = 0 well defined
+            uint64_t take(unsigned count) {
+                uint64_t value = (buffer_ >> 1) >> (63 - count);
+                skip(count);
+                return value;
+            }
+
+            // 0 <= count <= 64, refilling as needed
+            uint64_t read(unsigned count) {
+                refill();
+                if (count <= 56) {
+                    return take(count);
+                }
+                uint64_t high = take(count - 32);
+                refill();
+                return (high << 32) | take(32);
+            }
+
+            unsigned available() const { return available_; }
+
+            // Bits consumed so far
+            size_t position() const { return static_cast<size_t>(next_ - data_) * 8 - available_; }
+
+          private:
+            const uint8_t *data_;
+            const uint8_t *next_;
+            uint64_t buffer_ = 0;    // Unread bits, left aligned; the bits below them are zero
+            unsigned available_ = 0; // Unread bits in buffer_
+        };
+
+        int64_t signExtend(uint64_t value, unsigned bits) {
+            return static_cast<int64_t>(value << (64 - bits)) >> (64 - bits);
+        }
+
+        // Appends the column header, then one block per kBlockValues values written by encode_block
+        template <typename T, typename Encode_Block>
+        std::vector<uint8_t> encodeColumn(const std::vector<T> &input, uint32_t kind, Encode_Block encode_block) {
+            std::vector<uint8_t> out;
+            // Worst case: every value stored raw with its 13-bit window header
+            out.reserve(sizeof(Column_Header) + input.size() * 10 + (input.size() / kBlockValues + 1) * 32);
+            uint32_t blocks = static_cast<uint32_t>((input.size() + kBlockValues - 1) / kBlockValues);
+            appendValue(out, Column_Header{ kind, blocks, input.size() });
+            for (size_t begin = 0; begin < input.size(); begin += kBlockValues) {
+                size_t values = std::min(kBlockValues, input.size() - begin);
+                size_t header = out.size();
+                appendValue(out, Block_Header{ static_cast<uint32_t>(values), 0 });
+                Bit_Writer writer(out);
+                encode_block(writer, input.data() + begin, values);
+                writer.finish();
+                uint32_t bytes = static_cast<uint32_t>(out.size() - header - sizeof(Block_Header));
+                std::memcpy(out.data() + header + offsetof(Block_Header, bytes), &bytes, sizeof(bytes));
+            }
+            return out;
+        }
+
+        void encodeValueBlock(Bit_Writer &writer, const double *values, size_t count) {
+            uint64_t previous;
+            std::memcpy(&previous, &values[0], sizeof(previous));
+            writer.write(previous, 64);
+
+            unsigned window_leading = 0;
+            unsigned window_trailing = 0;
+            bool has_window = false;
+            for (size_t i = 1; i < count; ++i) {
+                uint64_t bits;
+                std::memcpy(&bits, &values[i], sizeof(bits));
+                uint64_t xored = bits ^ previous;
+                previous = bits;
+                if (xored == 0) {
+                    writer.write(0, 1);
+                    continue;
+                }
+
+                // The leading count is stored in 5 bits
+                unsigned leading = std::min(31u, static_cast<unsigned>(__builtin_clzll(xored)));
+                unsigned trailing = static_cast<unsigned>(__builtin_ctzll(xored));
+                if (has_window && leading >= window_leading && trailing >= window_trailing) {
+                    // '10': the meaningful bits fit the previous window
+                    writer.write(0b10, 2);
+                    writer.write(xored >> window_trailing, 64 - window_leading - window_trailing);
+                    continue;
+                }
+
+                // '11': new window, 5 bits of leading zeros and 6 bits of length (64 stored as 0)
+                unsigned length = 64 - leading - trailing;
+                writer.write(0b11, 2);
+                writer.write(leading, 5);
+                writer.write(length & 63, 6);
+                writer.write(xored >> trailing, length);
+                window_leading = leading;
+                window_trailing = trailing;
+                has_window = true;
+            }
+        }
+
+        void encodeTimeBlock(Bit_Writer &writer, const int64_t *times, size_t count) {
+            writer.write(static_cast<uint64_t>(times[0]), 64);
+
+            // Unsigned arithmetic, so any pair of int64 values wraps instead of overflowing
+            uint64_t previous = static_cast<uint64_t>(times[0]);
+            uint64_t previous_delta = 0;
+            for (size_t i = 1; i < count; ++i) {
+                uint64_t delta = static_cast<uint64_t>(times[i]) - previous;
+                int64_t dod = static_cast<int64_t>(delta - previous_delta);
+                previous = static_cast<uint64_t>(times[i]);
+                previous_delta = delta;
+
+                if (dod == 0) {
+                    writer.write(0b0, 1);
+                } else if (dod >= -64 && dod < 64) {
+                    writer.write(0b10, 2);
+                    writer.write(static_cast<uint64_t>(dod), 7);
+                } else if (dod >= -256 && dod < 256) {
+                    writer.write(0b110, 3);
+                    writer.write(static_cast<uint64_t>(dod), 9);
+                } else if (dod >= -2048 && dod < 2048) {
+                    writer.write(0b1110, 4);
+                    writer.write(static_cast<uint64_t>(dod), 12);
+                } else if (dod >= INT32_MIN && dod <= INT32_MAX) {
+                    writer.write(0b11110, 5);
+                    writer.write(static_cast<uint64_t>(dod), 32);
+                } else {
+                    writer.write(0b11111, 5);
+                    writer.write(static_cast<uint64_t>(dod), 64);
+                }
+            }
+        }
+
+        // A corrupt stream could walk past its block; checked once per value, never per bit
+        bool inside(const Bit_Reader &reader, size_t stream_bytes) { return reader.position() <= stream_bytes * 8; }
+
+        bool decodeValueBlock(const uint8_t *stream, size_t stream_bytes, size_t count, double *out) {
+            Bit_Reader reader(stream);
+            uint64_t previous = reader.read(64);
+            std::memcpy(&out[0], &previous, sizeof(previous));
+
+            unsigned window_leading = 0;
+            unsigned window_length = 0; // 0 until the first new window
+            unsigned window_trailing = 0;
+            for (size_t i = 1; i < count; ++i) {
+                // '0' repeat, '10' reuse the window, '11' new window; control and header come in one peek
+                reader.refill();
+                uint64_t head = reader.peek(13);
+                if ((head >> 12) != 0) {
+                    if ((head >> 11) == 0b11) {
+                        unsigned length = static_cast<unsigned>(head & 63);
+                        window_leading = static_cast<unsigned>(head >> 6) & 31;
+                        window_length = length == 0 ? 64 : length;
+                        if (window_leading + window_length > 64) {
+                            return false;
+                        }
+                        window_trailing = 64 - window_leading - window_length;
+                        reader.skip(13);
+                    } else if (window_length == 0) {
+                        return false;
+                    } else {
+                        reader.skip(2);
+                    }
+                    // The bits left after the header usually cover the window, saving a second refill
+                    uint64_t meaningful =
+                        window_length <= reader.available() ? reader.take(window_length) : reader.read(window_length);
+                    previous ^= meaningful << window_trailing;
+                } else {
+                    reader.skip(1);
+                }
+                if (!inside(reader, stream_bytes)) {
+                    return false;
+                }
+                std::memcpy(&out[i], &previous, sizeof(previous));
+            }
+            return true;
+        }
+
+        bool decodeTimeBlock(const uint8_t *stream, size_t stream_bytes, size_t count, int64_t *out) {
+            Bit_Reader reader(stream);
+            uint64_t previous = reader.read(64);
+            uint64_t previous_delta = 0;
+            out[0] = static_cast<int64_t>(previous);
+
+            for (size_t i = 1; i < count; ++i) {
+                // Up to 5 prefix bits: the number of leading ones picks the bucket
+                reader.refill();
+                uint64_t prefix = reader.peek(5);
+                int64_t dod;
+                if ((prefix & 0b10000) == 0) {
+                    reader.skip(1);
+                    dod = 0;
+                } else if ((prefix & 0b01000) == 0) {
+                    reader.skip(2);
+                    dod = signExtend(reader.read(7), 7);
+                } else if ((prefix & 0b00100) == 0) {
+                    reader.skip(3);
+                    dod = signExtend(reader.read(9), 9);
+                } else if ((prefix & 0b00010) == 0) {
+                    reader.skip(4);
+                    dod = signExtend(reader.read(12), 12);
+                } else if ((prefix & 0b00001) == 0) {
+                    reader.skip(5);
+                    dod = signExtend(reader.read(32), 32);
+                } else {
+                    reader.skip(5);
+                    dod = static_cast<int64_t>(reader.read(64));
+                }
+                if (!inside(reader, stream_bytes)) {
+                    return false;
+                }
+                previous_delta += static_cast<uint64_t>(dod);
+                previous += previous_delta;
+                out[i] = static_cast<int64_t>(previous);
+            }
+            return true;
+        }
+
+        template <typename T>
+        std::vector<T> decodeColumn(const std::vector<uint8_t> &column) {
+            Block_Decoder decoder(column.data(), column.size());
+            std::vector<T> out(decoder.valid() ? decoder.size() : 0);
+            size_t filled = 0;
+            while (filled < out.size()) {
+                // Blocks decode straight into the result, so no staging buffer is needed
+                size_t values = decoder.next(out.data() + filled, out.size() / kBlockValues + 1);
+                if (values == 0) {
+                    return {};
+                }
+                filled += values;
+            }
+            return out;
+        }
+
+        bool writeColumn(std::ofstream &file, const std::vector<uint8_t> &column) {
+            writeValue<uint64_t>(file, column.size());
+            file.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(column.size()));
+            return static_cast<bool>(file);
+        }
+
+        bool readColumn(std::ifstream &file, std::vector<uint8_t> &column) {
+            uint64_t size = 0;
+            if (!readValue(file, size)) {
+                return false;
+            }
+            // A corrupt length must not allocate more than the rest of the file could hold
+            std::streamoff here = file.tellg();
+            file.seekg(0, std::ios::end);
+            std::streamoff left = file.tellg() - here;
+            file.seekg(here);
+            if (here < 0 || left < 0 || size > static_cast<uint64_t>(left)) {
+                return false;
+            }
+            column.resize(size);
+            return size == 0 || file.read(reinterpret_cast<char *>(column.data()), static_cast<std::streamsize>(size));
+        }
+
+    } // namespace
+
+    std::vector<uint8_t> encodeValues(const std::vector<double> &values) {
+        return encodeColumn(values, kValueColumn, encodeValueBlock);
+    }
+
+    std::vector<uint8_t> encodeTimes(const std::vector<int64_t> &times) {
+        return encodeColumn(times, kTimeColumn, encodeTimeBlock);
+    }
+
+    Block_Decoder::Block_Decoder(const uint8_t *data, size_t size) : data_(data), end_(data + size), cursor_(data) {
+        Column_Header header;
+        if (size < sizeof(header)) {
+            return;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        // Every block takes at least its header, 8 bytes of stream and the padding, which bounds a corrupt count.
+        // Every block but the last is full, so the count fixes the number of blocks
+        size_t max_blocks = (size - sizeof(header)) / (sizeof(Block_Header) + 8 + kPadding);
+        if ((header.kind != kValueColumn && header.kind != kTimeColumn) || header.blocks > max_blocks ||
+            header.count > static_cast<uint64_t>(header.blocks) * kBlockValues ||
+            header.count + kBlockValues <= static_cast<uint64_t>(header.blocks) * kBlockValues) {
+            return;
+        }
+        kind_ = header.kind;
+        blocks_left_ = header.blocks;
+        count_ = header.count;
+        remaining_ = header.count;
+        cursor_ = data + sizeof(header);
+        valid_ = true;
+    }
+
+    const uint8_t *Block_Decoder::nextBlock(uint32_t kind, uint32_t &values, size_t &bytes) {
+        if (!valid_ || kind != kind_) {
+            valid_ = false;
+            return nullptr;
+        }
+        Block_Header header;
+        if (blocks_left_ == 0) {
+            return nullptr;
+        }
+        if (static_cast<size_t>(end_ - cursor_) < sizeof(header)) {
+            valid_ = false;
+            return nullptr;
+        }
+        std::memcpy(&header, cursor_, sizeof(header));
+        const uint8_t *stream = cursor_ + sizeof(header);
+        // A block never holds more than the values still to come, and only the last block may be short, so the
+        // blocks add up to exactly the column count and a caller sized by size() is never overrun
+        size_t expected = std::min(remaining_, kBlockValues);
+        if (header.values != expected || header.bytes < kPadding + 8 ||
+            header.bytes > static_cast<size_t>(end_ - stream)) {
+            valid_ = false;
+            return nullptr;
+        }
+        cursor_ = stream + header.bytes;
+        --blocks_left_;
+        remaining_ -= header.values;
+        values = header.values;
+        bytes = header.bytes - kPadding;
+        return stream;
+    }
+
+    size_t Block_Decoder::next(double *out, size_t max_blocks) {
+        size_t decoded = 0;
+        for (size_t block = 0; block < max_blocks; ++block) {
+            uint32_t values = 0;
+            size_t bytes = 0;
+            const uint8_t *stream = nextBlock(kValueColumn, values, bytes);
+            if (stream == nullptr) {
+                break;
+            }
+            if (!decodeValueBlock(stream, bytes, values, out + decoded)) {
+                valid_ = false;
+                return 0;
+            }
+            decoded += values;
+            if (values < kBlockValues) {
+                break;
+            }
+        }
+        return decoded;
+    }
+
+    size_t Block_Decoder::next(int64_t *out, size_t max_blocks) {
+        size_t decoded = 0;
+        for (size_t block = 0; block < max_blocks; ++block) {
+            uint32_t values = 0;
+            size_t bytes = 0;
+            const uint8_t *stream = nextBlock(kTimeColumn, values, bytes);
+            if (stream == nullptr) {
+                break;
+            }
+            if (!decodeTimeBlock(stream, bytes, values, out + decoded)) {
+                valid_ = false;
+                return 0;
+            }
+            decoded += values;
+            if (values < kBlockValues) {
+                break;
+            }
+        }
+        return decoded;
+    }
+
+    std::vector<double> decodeValues(const std::vector<uint8_t> &column) { return decodeColumn<double>(column); }
+
+    std::vector<int64_t> decodeTimes(const std::vector<uint8_t> &column) { return decodeColumn<int64_t>(column); }
+
+    bool saveSeries(const std::string &filename, const std::map<std::string, std::vector<double>> &series,
+                    const std::map<std::string, std::vector<int64_t>> &times) {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        file.write(kMagic, sizeof(kMagic));
+        writeValue<uint32_t>(file, static_cast<uint32_t>(series.size()));
+        for (const auto &[ticker, values] : series) {
+            writeValue<uint16_t>(file, static_cast<uint16_t>(ticker.size()));
+            file.write(ticker.data(), static_cast<std::streamsize>(ticker.size()));
+
+            auto ticker_times = times.find(ticker);
+            bool has_times = ticker_times != times.end() && ticker_times->second.size() == values.size();
+            writeValue<uint8_t>(file, has_times ? 1 : 0);
+            writeColumn(file, encodeValues(values));
+            if (has_times) {
+                writeColumn(file, encodeTimes(ticker_times->second));
+            }
+        }
+
+        if (!file) {
+            std::cerr << "Failed to write series: " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadSeries(const std::string &filename, std::map<std::string, std::vector<double>> &series,
+                    std::map<std::string, std::vector<int64_t>> *times) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return false;
+        }
+
+        char magic[sizeof(kMagic)];
+        uint32_t ticker_count = 0;
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+            !readValue(file, ticker_count)) {
+            std::cerr << "Not a series file (or an unsupported version): " << filename << std::endl;
+            return false;
+        }
+
+        std::vector<uint8_t> column;
+        for (uint32_t i = 0; i < ticker_count; ++i) {
+            uint16_t size = 0;
+            uint8_t has_times = 0;
+            std::string ticker;
+            bool ok = readValue(file, size);
+            if (ok) {
+                ticker.resize(size);
+                ok = size == 0 || file.read(&ticker[0], size);
+            }
+            ok = ok && readValue(file, has_times) && readColumn(file, column);
+
+            std::vector<double> values = ok ? decodeValues(column) : std::vector<double>();
+            ok = ok && Block_Decoder(column.data(), column.size()).size() == values.size();
+            if (ok && has_times) {
+                ok = readColumn(file, column);
+                std::vector<int64_t> ticker_times = ok ? decodeTimes(column) : std::vector<int64_t>();
+                ok = ok && ticker_times.size() == values.size();
+                if (ok && times != nullptr) {
+                    (*times)[ticker] = std::move(ticker_times);
+                }
+            }
+            if (!ok) {
+                std::cerr << "Series file is corrupt: " << filename << std::endl;
+                return false;
+            }
+            series[ticker] = std::move(values);
+        }
+        return true;
+    }
+
+} // namespace codec
@@ -0,0 +1,273 @@
+#include "sharedMarketData.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sharedData {
+
+    namespace {
+
+        constexpr uint64_t kAlignment = 64;
+
+        uint64_t alignUp(uint64_t value) { return (value + kAlignment - 1) / kAlignment * kAlignment; }
+
+        const std::vector<double> &columnOf(const std::map<std::string, std::vector<double>> &columns,
+                                            const std::string &ticker) {
+            static const std::vector<double> empty;
+            auto it = columns.find(ticker);
+            return it == columns.end() ? empty : it->second;
+        }
+
+    } // namespace
+
+    bool publish(const std::string &name, const std::map<std::string, std::vector<double>> &prices,
+                 const std::map<std::string, std::vector<double>> &volatility,
+                 const std::map<std::string, std::vector<double>> &percentage_changes, uint64_t generation) {
+        // Union of tickers across the three columns, in map order
+        std::set<std::string> tickers;
+        for (const auto *columns : { &prices, &volatility, &percentage_changes }) {
+            for (const auto &[ticker, values] : *columns) {
+                if (ticker.size() >= kTickerNameSize) {
+                    std::cerr << "Ticker name too long for shared segment: " << ticker << std::endl;
+                    return false;
+                }
+                tickers.insert(ticker);
+            }
+        }
+
+        // Lay out header, directory and 64-byte aligned columns
+        std::vector<Ticker_Entry> directory(tickers.size());
+        uint64_t offset = alignUp(sizeof(Segment_Header) + directory.size() * sizeof(Ticker_Entry));
+        size_t index = 0;
+        for (const auto &ticker : tickers) {
+            Ticker_Entry &entry = directory[index++];
+            std::memset(&entry, 0, sizeof(entry));
+            std::memcpy(entry.name, ticker.data(), ticker.size());
+
+            entry.price_offset = offset;
+            entry.price_count = columnOf(prices, ticker).size();
+            offset = alignUp(offset + entry.price_count * sizeof(double));
+
+            entry.volatility_offset = offset;
+            entry.volatility_count = columnOf(volatility, ticker).size();
+            offset = alignUp(offset + entry.volatility_count * sizeof(double));
+
+            entry.percentage_offset = offset;
+            entry.percentage_count = columnOf(percentage_changes, ticker).size();
+            offset = alignUp(offset + entry.percentage_count * sizeof(double));
+        }
+        uint64_t total_size = offset;
+
+        // Replace any previous segment so readers never see a half-resized one
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            std::cerr << "shm_open failed for " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+            std::cerr << "ftruncate failed for " << name << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        void *mapped = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "mmap failed for " << name << ": " << std::strerror(errno) << std::endl;
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        unsigned char *base = static_cast<unsigned char *>(mapped);
+        std::memcpy(base + sizeof(Segment_Header), directory.data(), directory.size() * sizeof(Ticker_Entry));
+        for (const auto &entry : directory) {
+            std::string ticker(entry.name);
+            std::memcpy(base + entry.price_offset, columnOf(prices, ticker).data(),
+                        entry.price_count * sizeof(double));
+            std::memcpy(base + entry.volatility_offset, columnOf(volatility, ticker).data(),
+                        entry.volatility_count * sizeof(double));
+            std::memcpy(base + entry.percentage_offset, columnOf(percentage_changes, ticker).data(),
+                        entry.percentage_count * sizeof(double));
+        }
+
+        Segment_Header header{};
+        header.version = kVersion;
+        header.header_size = sizeof(Segment_Header);
+        header.ticker_count = directory.size();
+        header.total_size = total_size;
+        header.generation = generation;
+        std::memcpy(base, &header, sizeof(header));
+
+        // Magic goes in last and is flushed before anyone can trust the rest of the segment
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        std::memcpy(base, kMagic, sizeof(kMagic));
+
+        munmap(mapped, total_size);
+        return true;
+    }
+
+    bool unpublish(const std::string &name) {
+        if (shm_unlink(name.c_str()) != 0) {
+            std::cerr << "shm_unlink failed for " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    MarketView::~MarketView() { detach(); }
+
+    MarketView::MarketView(MarketView &&other) noexcept : base_(other.base_), size_(other.size_) {
+        other.base_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MarketView &MarketView::operator=(MarketView &&other) noexcept {
+        if (this != &other) {
+            detach();
+            base_ = other.base_;
+            size_ = other.size_;
+            other.base_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    bool MarketView::attach(const std::string &name) {
+        detach();
+
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            std::cerr << "shm_open failed for " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Segment_Header)) {
+            std::cerr << "Shared segment " << name << " is truncated" << std::endl;
+            close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "mmap failed for " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        const unsigned char *base = static_cast<const unsigned char *>(mapped);
+        Segment_Header header;
+        std::memcpy(&header, base, sizeof(header));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                     header.header_size == sizeof(Segment_Header) && header.total_size <= size &&
+                     sizeof(Segment_Header) + header.ticker_count * sizeof(Ticker_Entry) <= size;
+        if (!valid) {
+            std::cerr << "Shared segment " << name << " has an unknown layout or is still being written" << std::endl;
+            munmap(mapped, size);
+            return false;
+        }
+
+        base_ = base;
+        size_ = size;
+        return true;
+    }
+
+    void MarketView::detach() {
+        if (base_ != nullptr) {
+            munmap(const_cast<unsigned char *>(base_), size_);
+            base_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    uint64_t MarketView::generation() const {
+        return base_ == nullptr ? 0 : reinterpret_cast<const Segment_Header *>(base_)->generation;
+    }
+
+    size_t MarketView::tickerCount() const {
+        return base_ == nullptr ? 0 : reinterpret_cast<const Segment_Header *>(base_)->ticker_count;
+    }
+
+    const Ticker_Entry &MarketView::entry(size_t index) const {
+        // Out-of-range indices read as a ticker with no name and empty columns
+        static const Ticker_Entry missing{};
+        if (index >= tickerCount()) {
+            return missing;
+        }
+        return reinterpret_cast<const Ticker_Entry *>(base_ + sizeof(Segment_Header))[index];
+    }
+
+    std::string MarketView::ticker(size_t index) const {
+        const Ticker_Entry &e = entry(index);
+        return std::string(e.name, strnlen(e.name, kTickerNameSize));
+    }
+
+    size_t MarketView::find(const std::string &ticker) const {
+        // The directory is written in sorted order, so a binary search is enough
+        size_t low = 0;
+        size_t high = tickerCount();
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            int cmp = std::strncmp(entry(mid).name, ticker.c_str(), kTickerNameSize);
+            if (cmp < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low < tickerCount() && this->ticker(low) == ticker ? low : tickerCount();
+    }
+
+    Series MarketView::column(uint64_t offset, uint64_t count) const {
+        if (base_ == nullptr || offset > size_ || count > (size_ - offset) / sizeof(double)) {
+            return Series{};
+        }
+        return Series{ reinterpret_cast<const double *>(base_ + offset), static_cast<size_t>(count) };
+    }
+
+    Series MarketView::prices(size_t index) const {
+        return column(entry(index).price_offset, entry(index).price_count);
+    }
+
+    Series MarketView::volatility(size_t index) const {
+        return column(entry(index).volatility_offset, entry(index).volatility_count);
+    }
+
+    Series MarketView::percentageChanges(size_t index) const {
+        return column(entry(index).percentage_offset, entry(index).percentage_count);
+    }
+
+    std::map<std::string, std::vector<double>> MarketView::pricesMap() const {
+        std::map<std::string, std::vector<double>> result;
+        for (size_t i = 0; i < tickerCount(); ++i) {
+            Series s = prices(i);
+            result[ticker(i)].assign(s.begin(), s.end());
+        }
+        return result;
+    }
+
+    std::map<std::string, std::vector<double>> MarketView::volatilityMap() const {
+        std::map<std::string, std::vector<double>> result;
+        for (size_t i = 0; i < tickerCount(); ++i) {
+            Series s = volatility(i);
+            result[ticker(i)].assign(s.begin(), s.end());
+        }
+        return result;
+    }
+
+    std::map<std::string, std::vector<double>> MarketView::percentageChangesMap() const {
+        std::map<std::string, std::vector<double>> result;
+        for (size_t i = 0; i < tickerCount(); ++i) {
+            Series s = percentageChanges(i);
+            result[ticker(i)].assign(s.begin(), s.end());
+        }
+        return result;
+    }
+
+} // namespace sharedData
@@ -0,0 +1,340 @@
+#include "tradingCalendar.h"
+#include <algorithm>
+#include <cmath>
+
+namespace calendar {
+
+    namespace {
+
+        constexpr int64_t kSecondsPerDay = 86400;
+
+        int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+        bool isLeap(int year) { return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0; }
+
+        unsigned daysInMonth(int year, unsigned month) {
+            static constexpr unsigned kDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            return month == 2 && isLeap(year) ? 29 : kDays[month - 1];
+        }
+
+        // Reads exactly count decimal digits
+        bool readDigits(const char *&p, const char *end, int count, int &value) {
+            if (end - p < count) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < count; ++i, ++p) {
+                if (*p < '0' || *p > '9') {
+                    return false;
+                }
+                value = value * 10 + (*p - '0');
+            }
+            return true;
+        }
+
+        bool readChar(const char *&p, const char *end, char c) {
+            if (p == end || *p != c) {
+                return false;
+            }
+            ++p;
+            return true;
+        }
+
+        // Day number of the n-th given weekday (0 = Sunday) of a month
+        int64_t nthWeekday(int year, unsigned month, unsigned wd, int n) {
+            int64_t first = daysFromCivil(year, month, 1);
+            return first + (wd + 7 - weekday(first)) % 7 + 7 * (n - 1);
+        }
+
+        int64_t lastWeekday(int year, unsigned month, unsigned wd) {
+            int64_t last = daysFromCivil(year, month, daysInMonth(year, month));
+            return last - (weekday(last) + 7 - wd) % 7;
+        }
+
+        // Saturday holidays move to Friday and Sunday holidays to Monday
+        int64_t observed(int64_t day) {
+            unsigned wd = weekday(day);
+            return wd == 6 ? day - 1 : (wd == 0 ? day + 1 : day);
+        }
+
+        // Anonymous Gregorian algorithm
+        int64_t easterSunday(int year) {
+            int a = year % 19;
+            int b = year / 100;
+            int c = year % 100;
+            int d = b / 4;
+            int e = b % 4;
+            int f = (b + 8) / 25;
+            int g = (b - f + 1) / 3;
+            int h = (19 * a + b - d - g + 15) % 30;
+            int i = c / 4;
+            int k = c % 4;
+            int l = (32 + 2 * e + 2 * i - h - k) % 7;
+            int m = (a + 11 * h + 22 * l) / 451;
+            int month = (h + l - 7 * m + 114) / 31;
+            int day = ((h + l - 7 * m + 114) % 31) + 1;
+            return daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        }
+
+        // Bars of a session of the given length, the last one possibly short
+        uint16_t barsIn(int64_t session_seconds, int64_t bar_seconds) {
+            return session_seconds > 0 ? static_cast<uint16_t>((session_seconds + bar_seconds - 1) / bar_seconds) : 0;
+        }
+
+    } // namespace
+
+    bool isUsDaylightSaving(int64_t day) {
+        int year = 0;
+        unsigned month = 0;
+        unsigned dom = 0;
+        civilFromDays(day, year, month, dom);
+        if (year >= 2007) {
+            return day >= nthWeekday(year, 3, 0, 2) && day < nthWeekday(year, 11, 0, 1);
+        }
+        if (year >= 1987) {
+            return day >= nthWeekday(year, 4, 0, 1) && day < lastWeekday(year, 10, 0);
+        }
+        return day >= lastWeekday(year, 4, 0) && day < lastWeekday(year, 10, 0);
+    }
+
+    int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    void civilFromDays(int64_t days, int &year, unsigned &month, unsigned &day) {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = static_cast<int>(yoe + era * 400 + (month <= 2));
+    }
+
+    unsigned weekday(int64_t days) { return static_cast<unsigned>(((days % 7) + 11) % 7); }
+
+    int64_t parseIso8601(std::string_view text) {
+        const char *p = text.data();
+        const char *end = p + text.size();
+
+        int year = 0;
+        int month = 0;
+        int day = 0;
+        if (!readDigits(p, end, 4, year) || !readChar(p, end, '-') || !readDigits(p, end, 2, month) ||
+            !readChar(p, end, '-') || !readDigits(p, end, 2, day)) {
+            return kInvalidTime;
+        }
+        if (month < 1 || month > 12 || day < 1 || static_cast<unsigned>(day) > daysInMonth(year, month)) {
+            return kInvalidTime;
+        }
+
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+        if (p != end && (*p == 'T' || *p == ' ')) {
+            ++p;
+            if (!readDigits(p, end, 2, hour) || !readChar(p, end, ':') || !readDigits(p, end, 2, minute)) {
+                return kInvalidTime;
+            }
+            if (p != end && *p == ':') {
+                ++p;
+                if (!readDigits(p, end, 2, second)) {
+                    return kInvalidTime;
+                }
+                if (p != end && (*p == '.' || *p == ',')) {
+                    ++p;
+                    const char *fraction = p;
+                    while (p != end && *p >= '0' && *p <= '9') {
+                        ++p;
+                    }
+                    if (p == fraction) {
+                        return kInvalidTime;
+                    }
+                }
+            }
+            if (hour > 23 || minute > 59 || second > 59) {
+                return kInvalidTime;
+            }
+        }
+
+        int offset_seconds = 0;
+        if (p != end) {
+            if (*p == 'Z') {
+                ++p;
+            } else if (*p == '+' || *p == '-') {
+                int sign = *p == '-' ? -1 : 1;
+                ++p;
+                int offset_hours = 0;
+                int offset_minutes = 0;
+                if (!readDigits(p, end, 2, offset_hours)) {
+                    return kInvalidTime;
+                }
+                readChar(p, end, ':');
+                if (!readDigits(p, end, 2, offset_minutes) || offset_hours > 23 || offset_minutes > 59) {
+                    return kInvalidTime;
+                }
+                offset_seconds = sign * (offset_hours * 3600 + offset_minutes * 60);
+            }
+        }
+        if (p != end) {
+            return kInvalidTime;
+        }
+
+        int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        return days * kSecondsPerDay + hour * 3600 + minute * 60 + second - offset_seconds;
+    }
+
+    size_t parseIso8601Batch(const std::vector<std::string_view> &texts, int64_t *out) {
+        size_t parsed = 0;
+        for (size_t i = 0; i < texts.size(); ++i) {
+            out[i] = parseIso8601(texts[i]);
+            parsed += out[i] != kInvalidTime;
+        }
+        return parsed;
+    }
+
+    std::vector<int64_t> usEquityHolidays(int year) {
+        std::vector<int64_t> holidays;
+        int64_t new_year = daysFromCivil(year, 1, 1);
+        if (weekday(new_year) != 6) { // A Saturday New Year's Day is not observed on the Friday before
+            holidays.push_back(observed(new_year));
+        }
+        holidays.push_back(nthWeekday(year, 1, 1, 3));  // Martin Luther King Jr. Day
+        holidays.push_back(nthWeekday(year, 2, 1, 3));  // Washington's Birthday
+        holidays.push_back(easterSunday(year) - 2);     // Good Friday
+        holidays.push_back(lastWeekday(year, 5, 1));    // Memorial Day
+        if (year >= 2022) {
+            holidays.push_back(observed(daysFromCivil(year, 6, 19))); // Juneteenth
+        }
+        holidays.push_back(observed(daysFromCivil(year, 7, 4)));   // Independence Day
+        holidays.push_back(nthWeekday(year, 9, 1, 1));             // Labor Day
+        holidays.push_back(nthWeekday(year, 11, 4, 4));            // Thanksgiving
+        holidays.push_back(observed(daysFromCivil(year, 12, 25))); // Christmas
+        std::sort(holidays.begin(), holidays.end());
+        return holidays;
+    }
+
+    std::vector<int64_t> usEquityEarlyCloses(int year) {
+        std::vector<int64_t> holidays = usEquityHolidays(year);
+        auto trading = [&holidays](int64_t day) {
+            unsigned wd = weekday(day);
+            return wd != 0 && wd != 6 && std::find(holidays.begin(), holidays.end(), day) == holidays.end();
+        };
+
+        std::vector<int64_t> early_closes;
+        int64_t july_third = daysFromCivil(year, 7, 3);
+        if (trading(july_third)) { // A Friday July 3 is the observed Independence Day
+            early_closes.push_back(july_third);
+        }
+        early_closes.push_back(nthWeekday(year, 11, 4, 4) + 1); // Day after Thanksgiving
+        int64_t christmas_eve = daysFromCivil(year, 12, 24);
+        if (trading(christmas_eve)) { // A Friday Christmas Eve is the observed Christmas
+            early_closes.push_back(christmas_eve);
+        }
+        return early_closes;
+    }
+
+    Session_Calendar::Session_Calendar(int64_t first_day, int64_t last_day, const Exchange_Config &config)
+        : first_day_(first_day), local_offset_seconds_(config.utc_offset_minutes * 60),
+          bar_seconds_(static_cast<int64_t>(std::max(config.bar_minutes, 1)) * 60) {
+        std::vector<int64_t> holidays = config.holidays;
+        std::sort(holidays.begin(), holidays.end());
+        std::vector<int64_t> early_closes = config.early_closes;
+        std::sort(early_closes.begin(), early_closes.end());
+        int64_t full_session = std::max(static_cast<int64_t>(config.close_minutes - config.open_minutes) * 60,
+                                        static_cast<int64_t>(0));
+        int64_t short_session =
+            std::clamp(static_cast<int64_t>(config.early_close_minutes - config.open_minutes) * 60,
+                       static_cast<int64_t>(0), full_session);
+
+        for (int64_t d = first_day; d <= last_day; ++d) {
+            Day day;
+            day.first_bar = static_cast<uint32_t>(bar_starts_.size());
+            unsigned wd = weekday(d);
+            if (wd != 0 && wd != 6 && !std::binary_search(holidays.begin(), holidays.end(), d)) {
+                int offset_minutes = config.utc_offset_minutes;
+                if (config.us_daylight_saving && isUsDaylightSaving(d)) {
+                    offset_minutes += 60;
+                }
+                bool early = std::binary_search(early_closes.begin(), early_closes.end(), d);
+                day.open = d * kSecondsPerDay + (static_cast<int64_t>(config.open_minutes) - offset_minutes) * 60;
+                day.session_seconds = static_cast<uint32_t>(early ? short_session : full_session);
+                day.bars = barsIn(day.session_seconds, bar_seconds_);
+                for (uint16_t b = 0; b < day.bars; ++b) {
+                    bar_starts_.push_back(day.open + b * bar_seconds_);
+                }
+            }
+            days_.push_back(day);
+        }
+    }
+
+    Session_Calendar Session_Calendar::usEquities(std::string_view first_date, std::string_view last_date) {
+        int64_t first = parseIso8601(first_date);
+        int64_t last = parseIso8601(last_date);
+        if (first == kInvalidTime || last == kInvalidTime) {
+            return Session_Calendar(0, -1);
+        }
+        int64_t first_day = floorDiv(first, kSecondsPerDay);
+        int64_t last_day = floorDiv(last, kSecondsPerDay);
+
+        Exchange_Config config;
+        int first_year = 0;
+        int last_year = 0;
+        unsigned month = 0;
+        unsigned day = 0;
+        civilFromDays(first_day, first_year, month, day);
+        civilFromDays(last_day, last_year, month, day);
+        for (int year = first_year; year <= last_year; ++year) {
+            std::vector<int64_t> holidays = usEquityHolidays(year);
+            config.holidays.insert(config.holidays.end(), holidays.begin(), holidays.end());
+            std::vector<int64_t> early_closes = usEquityEarlyCloses(year);
+            config.early_closes.insert(config.early_closes.end(), early_closes.begin(), early_closes.end());
+        }
+        return Session_Calendar(first_day, last_day, config);
+    }
+
+    size_t Session_Calendar::hourIndex(int64_t epoch_seconds) const {
+        // Sessions sit well inside the local day, so the standard offset finds the right day even under daylight saving
+        int64_t i = floorDiv(epoch_seconds + local_offset_seconds_, kSecondsPerDay) - first_day_;
+        if (i < 0 || i >= static_cast<int64_t>(days_.size())) {
+            return kNoSession;
+        }
+        const Day &day = days_[static_cast<size_t>(i)];
+        int64_t since_open = epoch_seconds - day.open;
+        if (day.bars == 0 || since_open < 0 || since_open >= day.session_seconds) {
+            return kNoSession;
+        }
+        return day.first_bar + static_cast<size_t>(since_open / bar_seconds_);
+    }
+
+    bool Session_Calendar::isTradingDay(int64_t day) const {
+        int64_t i = day - first_day_;
+        return i >= 0 && i < static_cast<int64_t>(days_.size()) && days_[static_cast<size_t>(i)].bars > 0;
+    }
+
+    std::vector<double> Session_Calendar::align(const std::vector<int64_t> &timestamps,
+                                                const std::vector<double> &prices) const {
+        std::vector<double> aligned(hours(), std::nan(""));
+        size_t count = std::min(timestamps.size(), prices.size());
+        for (size_t i = 0; i < count; ++i) {
+            size_t index = hourIndex(timestamps[i]);
+            if (index != kNoSession) {
+                aligned[index] = prices[i];
+            }
+        }
+        for (size_t h = 1; h < aligned.size(); ++h) {
+            if (std::isnan(aligned[h])) {
+                aligned[h] = aligned[h - 1];
+            }
+        }
+        return aligned;
+    }
+
+} // namespace calendar
@@ -43,7 +43,7 @@ namespace volFormula {
         return volatility;
     };
 
-    double updateVolatility(double oldVol, double newPrice, double oldPrice, double lambda) {
+    double update_volatility(double oldVol, double newPrice, double oldPrice, double lambda) {
         // Calculate the log return
         double r_t = log(newPrice / oldPrice);
 
@@ -55,4 +55,10 @@ namespace volFormula {
         return std::sqrt(new_variance);
     };
 
+    double volatilityAlgorithm(std::vector<double> &stock_prices) {
+        std::vector<double> logReturns = logarithmicReturnFunction(stock_prices);
+        double avgReturn = averageReturn(logReturns);
+        return volatility(logReturns, avgReturn);
+    };
+
 } // namespace volFormula
@@ -1,4 +1,5 @@
 #include "volatilityFormula.h"
+#include "volatilityParse.h"
 #include <cmath>
 #include <iostream>
 #include <map>
@@ -106,4 +107,34 @@ namespace volParsing {
         return true_volatility_output;
     };
 
+    /**
+     * @brief Feeds one new price into a ticker's volatility state.
+     *
+     * Produces exactly the same sequence as tickerToVolHourly followed by true_volatility: the first 6 prices seed
+     * the initial volatility, and every later price applies one EWMA update.
+     *
+     * @param state The ticker's running state.
+     * @param price The new price.
+     * @param lambda The EWMA decay factor.
+     * @return True if a new volatility value was produced (state.volatility is then the latest one).
+     */
+    bool push_price(Volatility_State &state, double price, double lambda) {
+        ++state.count;
+
+        if (state.count <= 6) {
+            state.warmup_prices.push_back(price);
+            if (state.count == 6) {
+                state.volatility = volFormula::volatilityAlgorithm(state.warmup_prices);
+                state.warmup_prices.clear();
+                state.warmup_prices.shrink_to_fit();
+            }
+            state.last_price = price;
+            return false;
+        }
+
+        state.volatility = volFormula::update_volatility(state.volatility, price, state.last_price, lambda);
+        state.last_price = price;
+        return true;
+    }
+
 } // namespace volParsing
@@ -0,0 +1,246 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "backtestService.h"
+#include "pipeline.h"
+
+namespace BacktestServiceFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "NVDA", "AAPL", "MSFT", "TSLA" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 90.0 + 35.0 * t;
+            for (size_t i = 0; i < hours; ++i) {
+                price *= 1.0 + (0.003 + 0.002 * t) * std::sin(0.4 * i + t) + 0.002 * std::cos(1.3 * i * (t + 1));
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    // One bar per hour from 2024-01-01 00:00 UTC
+    constexpr int64_t kFirstBar = 1704067200;
+
+    std::vector<int64_t> sample_bar_starts(size_t hours) {
+        std::vector<int64_t> starts;
+        for (size_t i = 0; i < hours; ++i) {
+            starts.push_back(kFirstBar + static_cast<int64_t>(i) * 3600);
+        }
+        return starts;
+    }
+
+    std::string socket_path(const char *name) { return "/tmp/" + std::string(name) + std::to_string(::getpid()); }
+
+    TEST(BacktestServiceTest, MatchesStageGraphRun) {
+        auto prices = sample_prices(300);
+        auto data = service::buildMarketData(prices);
+
+        pipeline::StageGraph graph;
+        graph.setPrices(prices);
+        std::map<std::string, double> portfolio;
+        for (const auto &[ticker, series] : prices) {
+            portfolio[ticker] = 20000.0 / prices.size();
+        }
+
+        for (const std::string strategy : { "optimistic", "neutral", "conservative" }) {
+            service::Backtest_Request request;
+            request.strategy = strategy;
+            service::Backtest_Response response = service::runBacktest(*data, request);
+            const pipeline::Run_Result &expected = graph.run(strategy, portfolio);
+
+            ASSERT_EQ(response.status, service::Status::Ok);
+            EXPECT_EQ(response.end_hour, graph.hours());
+            EXPECT_EQ(response.final_portfolio, expected.final_portfolio);
+            EXPECT_EQ(response.final_value, expected.final_value);
+        }
+    }
+
+    TEST(BacktestServiceTest, DateWindowAndTickerSubset) {
+        auto prices = sample_prices(300);
+        auto data = service::buildMarketData(prices, sample_bar_starts(300));
+        size_t offset = 300 - data->hours;
+        ASSERT_EQ(data->hour_starts.size(), data->hours);
+
+        service::Backtest_Request request;
+        request.capital = 1000.0;
+        request.tickers = { "MSFT", "AAPL" };
+        request.begin_time = kFirstBar + static_cast<int64_t>(offset + 50) * 3600;
+        request.end_time = kFirstBar + static_cast<int64_t>(offset + 150) * 3600 - 1;
+        service::Backtest_Response response = service::runBacktest(*data, request);
+
+        ASSERT_EQ(response.status, service::Status::Ok);
+        EXPECT_EQ(response.begin_hour, 50u);
+        EXPECT_EQ(response.end_hour, 150u);
+        EXPECT_EQ(response.final_portfolio.size(), 2u);
+        EXPECT_DOUBLE_EQ(response.initial_value, 1000.0);
+
+        request.tickers = { "ZZZ" };
+        EXPECT_EQ(service::runBacktest(*data, request).status, service::Status::UnknownTicker);
+        request.tickers.clear();
+        request.end_time = request.begin_time;
+        EXPECT_EQ(service::runBacktest(*data, request).status, service::Status::EmptyWindow);
+        request.strategy = "reckless";
+        EXPECT_EQ(service::runBacktest(*data, request).status, service::Status::UnknownStrategy);
+
+        request.strategy = "neutral";
+        request.end_time = 0;
+        for (double capital : { 0.0, -1000.0, std::nan(""), HUGE_VAL }) {
+            request.capital = capital;
+            EXPECT_EQ(service::runBacktest(*data, request).status, service::Status::BadRequest) << capital;
+        }
+    }
+
+    TEST(BacktestServiceTest, DaemonServesConcurrentClients) {
+        auto prices = sample_prices(400);
+        auto data = service::buildMarketData(prices, sample_bar_starts(400));
+
+        service::Daemon_Config config;
+        config.socket_path = socket_path("volatility_daemon_test");
+        config.workers = 4;
+        service::Backtest_Daemon daemon(data);
+        ASSERT_TRUE(daemon.start(config));
+
+        const std::vector<std::string> strategies = { "optimistic", "neutral", "conservative" };
+        constexpr size_t kClients = 6;
+        constexpr size_t kRequests = 20;
+        std::vector<int> mismatches(kClients, 0);
+        std::vector<std::thread> clients;
+        for (size_t c = 0; c < kClients; ++c) {
+            clients.emplace_back([&, c]() {
+                service::Backtest_Client client;
+                if (!client.connect(config.socket_path)) {
+                    mismatches[c] = -1;
+                    return;
+                }
+                for (size_t r = 0; r < kRequests; ++r) {
+                    service::Backtest_Request request;
+                    request.strategy = strategies[(c + r) % strategies.size()];
+                    request.capital = 5000.0 + 100.0 * r;
+                    request.begin_time = r % 2 == 0 ? 0 : data->hour_starts[10 * r];
+                    service::Backtest_Response response;
+                    if (!client.run(request, response)) {
+                        mismatches[c] = -1;
+                        return;
+                    }
+                    // The socket round trip must return exactly what a local run computes
+                    service::Backtest_Response local = service::runBacktest(*data, request);
+                    if (response.status != service::Status::Ok || response.final_portfolio != local.final_portfolio ||
+                        response.begin_hour != local.begin_hour || response.metrics.sharpe != local.metrics.sharpe) {
+                        ++mismatches[c];
+                    }
+                }
+            });
+        }
+        for (auto &client : clients) {
+            client.join();
+        }
+        for (size_t c = 0; c < kClients; ++c) {
+            EXPECT_EQ(mismatches[c], 0) << "client " << c;
+        }
+        EXPECT_EQ(daemon.served(), kClients * kRequests);
+
+        // Rejected requests come back with their status and leave the connection usable
+        service::Backtest_Client client;
+        ASSERT_TRUE(client.connect(config.socket_path));
+        service::Backtest_Request request;
+        request.strategy = "reckless";
+        service::Backtest_Response response;
+        ASSERT_TRUE(client.run(request, response));
+        EXPECT_EQ(response.status, service::Status::UnknownStrategy);
+        request.strategy = "neutral";
+        ASSERT_TRUE(client.run(request, response));
+        EXPECT_EQ(response.status, service::Status::Ok);
+
+        daemon.stop();
+        EXPECT_NE(::access(config.socket_path.c_str(), F_OK), 0);
+    }
+
+    // Connects and sends half a request header, then goes silent
+    // Connects and sends the first sent bytes of a header, then nothing more
+    int stalled_client(const std::string &path, size_t sent = 12) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        char partial[12] = {};
+        sent = std::min(sent, sizeof(partial));
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            (sent > 0 && ::send(fd, partial, sent, 0) != static_cast<ssize_t>(sent))) {
+            return -1;
+        }
+        return fd;
+    }
+
+    TEST(BacktestServiceTest, StalledClientIsDropped) {
+        auto data = service::buildMarketData(sample_prices(200));
+        service::Daemon_Config config;
+        config.socket_path = socket_path("volatility_daemon_stall");
+        config.workers = 1;
+        config.io_timeout_ms = 300;
+        service::Backtest_Daemon daemon(data);
+        ASSERT_TRUE(daemon.start(config));
+
+        // The only worker drops the stalled client and serves the next one
+        int stalled = stalled_client(config.socket_path);
+        ASSERT_GE(stalled, 0);
+        service::Backtest_Client client;
+        ASSERT_TRUE(client.connect(config.socket_path));
+        service::Backtest_Request request;
+        service::Backtest_Response response;
+        ASSERT_TRUE(client.run(request, response));
+        EXPECT_EQ(response.status, service::Status::Ok);
+        ::close(stalled);
+        client.close();
+
+        // Stopping waits on a client stalled mid-header no longer than the timeout
+        stalled = stalled_client(config.socket_path);
+        ASSERT_GE(stalled, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto start = std::chrono::steady_clock::now();
+        daemon.stop();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_LT(seconds, 1.0);
+        ::close(stalled);
+    }
+
+    TEST(BacktestServiceTest, SilentClientIsDropped) {
+        auto data = service::buildMarketData(sample_prices(200));
+        service::Daemon_Config config;
+        config.socket_path = socket_path("volatility_daemon_silent");
+        config.workers = 1;
+        config.idle_timeout_ms = 300;
+        service::Backtest_Daemon daemon(data);
+        ASSERT_TRUE(daemon.start(config));
+
+        // The only worker holds a client that never sends a byte, until the idle timeout closes it
+        int silent = stalled_client(config.socket_path, 0);
+        ASSERT_GE(silent, 0);
+        timeval wait{ 5, 0 };
+        ::setsockopt(silent, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+        char byte = 0;
+        ASSERT_EQ(::recv(silent, &byte, 1, 0), 0);
+
+        // The worker is free again for the next client
+        service::Backtest_Client client;
+        ASSERT_TRUE(client.connect(config.socket_path));
+        service::Backtest_Request request;
+        service::Backtest_Response response;
+        ASSERT_TRUE(client.run(request, response));
+        EXPECT_EQ(response.status, service::Status::Ok);
+        ::close(silent);
+        client.close();
+        daemon.stop();
+    }
+
+} // namespace BacktestServiceFunctions
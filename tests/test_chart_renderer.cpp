@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+#include "chartRenderer.h"
+
+namespace ChartRendererFunctions {
+
+    std::vector<double> iota(size_t n) {
+        std::vector<double> values(n);
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = static_cast<double>(i);
+        }
+        return values;
+    }
+
+    std::string read_file(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<chart::Chart_Series> sample_series(size_t count, size_t points) {
+        std::vector<chart::Chart_Series> series(count);
+        for (size_t s = 0; s < count; ++s) {
+            series[s].name = "TICK" + std::to_string(s);
+            series[s].x = iota(points);
+            for (size_t i = 0; i < points; ++i) {
+                series[s].y.push_back(100.0 + 10.0 * s + 5.0 * std::sin(0.01 * i * (s + 1)));
+            }
+        }
+        return series;
+    }
+
+    TEST(ChartRendererTest, LttbPicksTheLargestTriangles) {
+        std::vector<double> x = iota(10);
+        std::vector<double> y = { 0, 1, 0, 5, 0, 1, 0, -4, 0, 1 };
+        EXPECT_EQ(chart::lttb(x, y, 4), (std::vector<size_t>{ 0, 3, 7, 9 }));
+
+        // Thresholds below 3 or at least the length keep everything
+        std::vector<size_t> all = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        EXPECT_EQ(chart::lttb(x, y, 2), all);
+        EXPECT_EQ(chart::lttb(x, y, 10), all);
+        EXPECT_EQ(chart::lttb(x, y, 50), all);
+        EXPECT_TRUE(chart::lttb({}, {}, 5).empty());
+    }
+
+    TEST(ChartRendererTest, LttbKeepsEndpointsAndThresholdPoints) {
+        std::vector<double> x = iota(10000);
+        std::vector<double> y;
+        for (double value : x) {
+            y.push_back(std::sin(0.013 * value) + 0.1 * std::cos(0.7 * value));
+        }
+        for (size_t threshold : { 3, 4, 17, 1000, 9999 }) {
+            std::vector<size_t> kept = chart::lttb(x, y, threshold);
+            ASSERT_EQ(kept.size(), threshold);
+            EXPECT_EQ(kept.front(), 0u);
+            EXPECT_EQ(kept.back(), x.size() - 1);
+            for (size_t k = 1; k < kept.size(); ++k) {
+                EXPECT_LT(kept[k - 1], kept[k]);
+            }
+        }
+    }
+
+    TEST(ChartRendererTest, PngIsCompressed) {
+        std::string path = ::testing::TempDir() + "test_chart_renderer.png";
+        chart::Chart_Options options;
+        options.title = "Volatility";
+        options.x_label = "Hour";
+        options.y_label = "Price ($)";
+        ASSERT_TRUE(chart::renderPng(path, sample_series(10, 5000), options));
+
+        std::string png = read_file(path);
+        std::remove(path.c_str());
+        ASSERT_GT(png.size(), 8u);
+        EXPECT_EQ(png.substr(0, 8), std::string("\x89PNG\r\n\x1A\n", 8));
+        // The raw 1200x700 RGB image is 2.5 MB
+        EXPECT_LT(png.size(), 100u * 1024);
+    }
+
+    TEST(ChartRendererTest, EverySeriesGetsItsOwnColor) {
+        std::string path = ::testing::TempDir() + "test_chart_renderer.svg";
+        ASSERT_TRUE(chart::renderSvg(path, sample_series(14, 100), chart::Chart_Options()));
+        std::string svg = read_file(path);
+        std::remove(path.c_str());
+
+        std::set<std::string> colors;
+        size_t lines = 0;
+        for (size_t at = svg.find("stroke=\"#"); at != std::string::npos; at = svg.find("stroke=\"#", at + 1)) {
+            colors.insert(svg.substr(at + 8, 7));
+            ++lines;
+        }
+        EXPECT_EQ(lines, 14u);
+        EXPECT_EQ(colors.size(), 14u);
+    }
+
+} // namespace ChartRendererFunctions
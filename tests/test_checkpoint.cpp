@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "incrementalEngine.h"
+
+namespace CheckpointFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "AAPL", "MSFT", "NVDA" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 100.0 + 50.0 * t;
+            for (size_t i = 0; i < hours; ++i) {
+                price *= 1.0 + 0.006 * std::sin(0.4 * i + t) + 0.002 * std::cos(1.3 * i);
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    std::map<std::string, std::vector<double>> slice(const std::map<std::string, std::vector<double>> &prices,
+                                                     size_t begin, size_t end) {
+        std::map<std::string, std::vector<double>> sliced;
+        for (const auto &[ticker, values] : prices) {
+            sliced[ticker] = std::vector<double>(values.begin() + begin, values.begin() + end);
+        }
+        return sliced;
+    }
+
+    TEST(CheckpointTest, ResumeMatchesFullReplay) {
+        auto prices = sample_prices(300);
+        std::map<std::string, double> portfolio = { { "AAPL", 5000.0 }, { "MSFT", 5000.0 }, { "NVDA", 5000.0 } };
+
+        incremental::Engine_State full = incremental::start("conservative", portfolio);
+        incremental::advance(full, prices);
+
+        // Day one: first 4 bars (still warming up), checkpoint, then daily batches of new bars
+        incremental::Engine_State resumed = incremental::start("conservative", portfolio);
+        std::string path = ::testing::TempDir() + "test_checkpoint.bin";
+        size_t done = 0;
+        for (size_t end : { 4, 120, 121, 250, 300 }) {
+            if (done > 0) {
+                ASSERT_TRUE(incremental::loadCheckpoint(path, resumed));
+            }
+            incremental::advance(resumed, slice(prices, done, end));
+            ASSERT_TRUE(incremental::saveCheckpoint(path, resumed));
+            done = end;
+        }
+        std::remove(path.c_str());
+
+        EXPECT_EQ(resumed.hours_processed, full.hours_processed);
+        EXPECT_EQ(resumed.last_timestamp, incremental::kNoTimestamp);
+        ASSERT_EQ(resumed.portfolio.size(), full.portfolio.size());
+        for (const auto &[ticker, value] : full.portfolio) {
+            EXPECT_EQ(resumed.portfolio.at(ticker), value) << ticker;
+            EXPECT_EQ(resumed.tickers.at(ticker).volatility.volatility, full.tickers.at(ticker).volatility.volatility);
+        }
+    }
+
+    TEST(CheckpointTest, TimestampsRejectReplayedBatches) {
+        auto prices = sample_prices(60);
+        std::map<std::string, double> portfolio = { { "AAPL", 5000.0 }, { "MSFT", 5000.0 }, { "NVDA", 5000.0 } };
+        std::vector<int64_t> times;
+        for (int64_t hour = 0; hour < 60; ++hour) {
+            times.push_back(1700000000 + 3600 * hour);
+        }
+        std::vector<int64_t> first_times(times.begin(), times.begin() + 30);
+        std::vector<int64_t> second_times(times.begin() + 30, times.end());
+
+        incremental::Engine_State state = incremental::start("neutral", portfolio);
+        EXPECT_EQ(state.last_timestamp, incremental::kNoTimestamp);
+        ASSERT_TRUE(incremental::advance(state, slice(prices, 0, 30), first_times));
+        EXPECT_EQ(state.last_timestamp, times[29]);
+
+        std::string path = ::testing::TempDir() + "test_checkpoint_times.bin";
+        ASSERT_TRUE(incremental::saveCheckpoint(path, state));
+        incremental::Engine_State resumed;
+        ASSERT_TRUE(incremental::loadCheckpoint(path, resumed));
+        std::remove(path.c_str());
+        EXPECT_EQ(resumed.last_timestamp, times[29]);
+
+        // Feeding the first day again, a wrong number of times or unordered times leaves the state alone
+        std::map<std::string, double> before = resumed.portfolio;
+        EXPECT_FALSE(incremental::advance(resumed, slice(prices, 0, 30), first_times));
+        EXPECT_FALSE(incremental::advance(resumed, slice(prices, 30, 60), first_times));
+        std::vector<int64_t> unordered = second_times;
+        std::swap(unordered[3], unordered[4]);
+        EXPECT_FALSE(incremental::advance(resumed, slice(prices, 30, 60), unordered));
+        EXPECT_EQ(resumed.hours_processed, 30u);
+        EXPECT_EQ(resumed.portfolio, before);
+
+        // The next day goes through and matches an untimestamped run
+        ASSERT_TRUE(incremental::advance(resumed, slice(prices, 30, 60), second_times));
+        EXPECT_EQ(resumed.last_timestamp, times.back());
+        incremental::Engine_State plain = incremental::start("neutral", portfolio);
+        incremental::advance(plain, prices);
+        EXPECT_EQ(resumed.portfolio, plain.portfolio);
+        EXPECT_EQ(plain.last_timestamp, incremental::kNoTimestamp);
+    }
+
+    TEST(CheckpointTest, RejectsMissingFile) {
+        incremental::Engine_State state;
+        EXPECT_FALSE(incremental::loadCheckpoint("does_not_exist.bin", state));
+    }
+
+}
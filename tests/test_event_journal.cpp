@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "eventJournal.h"
+
+namespace EventJournalFunctions {
+
+    TEST(EventJournalTest, RoundTripsEveryEventInOrder) {
+        std::string path = ::testing::TempDir() + "test_event_journal.bin";
+        std::vector<std::string> tickers = { "AAPL", "MSFT", "NVDA" };
+
+        // A small ring forces the producer to wait on the writer thread
+        journal::Journal_Writer writer(64);
+        ASSERT_TRUE(writer.open(path, tickers));
+        const uint32_t hours = 20000;
+        for (uint32_t hour = 0; hour < hours; ++hour) {
+            writer.log(hour, journal::Event_Type::PriceChange, hour % 3, hour * 0.5);
+            writer.log(hour, journal::Event_Type::ReallocationFunds, journal::kNoTicker, -1.0 * hour);
+        }
+        ASSERT_TRUE(writer.close());
+        EXPECT_EQ(writer.written(), 2u * hours);
+
+        journal::Journal_Reader reader;
+        ASSERT_TRUE(reader.open(path));
+        EXPECT_EQ(reader.tickers(), tickers);
+
+        journal::Event event;
+        for (uint32_t hour = 0; hour < hours; ++hour) {
+            ASSERT_TRUE(reader.next(event));
+            EXPECT_EQ(event.hour, hour);
+            EXPECT_EQ(event.type, journal::Event_Type::PriceChange);
+            EXPECT_EQ(reader.tickerName(event.ticker), tickers[hour % 3]);
+            EXPECT_EQ(event.value, hour * 0.5);
+
+            ASSERT_TRUE(reader.next(event));
+            EXPECT_EQ(event.type, journal::Event_Type::ReallocationFunds);
+            EXPECT_EQ(event.ticker, journal::kNoTicker);
+            EXPECT_EQ(reader.tickerName(event.ticker), "");
+            EXPECT_EQ(event.value, -1.0 * hour);
+        }
+        EXPECT_FALSE(reader.next(event));
+        std::remove(path.c_str());
+    }
+
+    TEST(EventJournalTest, RejectsOtherFiles) {
+        std::string path = ::testing::TempDir() + "test_event_journal_other.bin";
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        std::fputs("ticker,price\n", file);
+        std::fclose(file);
+
+        journal::Journal_Reader reader;
+        EXPECT_FALSE(reader.open(path));
+        EXPECT_FALSE(reader.open("does_not_exist.bin"));
+        std::remove(path.c_str());
+    }
+
+} // namespace EventJournalFunctions
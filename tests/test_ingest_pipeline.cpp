@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+#include "ingestPipeline.h"
+#include "spscQueue.h"
+#include "stock_manager.h"
+#include "volatilityParse.h"
+
+namespace IngestPipelineFunctions {
+
+    // CPU time of the calling thread, or of the whole process
+    double thread_cpu_seconds() {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+
+    double process_cpu_seconds() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    }
+
+    TEST(SpscQueueTest, KeepsOrderAcrossWraparound) {
+        Spsc_Queue<int> queue(5);
+        EXPECT_EQ(queue.capacity(), 7u);
+        int next_in = 0;
+        int next_out = 0;
+        for (int round = 0; round < 10; ++round) {
+            while (queue.try_push(int(next_in))) {
+                ++next_in;
+            }
+            EXPECT_EQ(next_in - next_out, 7);
+            for (int i = 0; i < 4; ++i) {
+                std::optional<int> value = queue.try_pop();
+                ASSERT_TRUE(value);
+                EXPECT_EQ(*value, next_out++);
+            }
+        }
+        while (std::optional<int> value = queue.try_pop()) {
+            EXPECT_EQ(*value, next_out++);
+        }
+        EXPECT_EQ(next_out, next_in);
+        EXPECT_FALSE(queue.try_pop());
+    }
+
+    TEST(SpscQueueTest, BlockingHandOffBetweenThreads) {
+        Spsc_Queue<std::vector<int>> queue(4);
+        constexpr int kItems = 200000;
+        std::thread producer([&]() {
+            for (int i = 0; i < kItems; ++i) {
+                queue.push(std::vector<int>{ i, -i });
+            }
+        });
+        bool in_order = true;
+        for (int i = 0; i < kItems; ++i) {
+            std::vector<int> value = queue.pop();
+            in_order = in_order && value.size() == 2 && value[0] == i && value[1] == -i;
+        }
+        producer.join();
+        EXPECT_TRUE(in_order);
+        EXPECT_FALSE(queue.try_pop());
+    }
+
+    TEST(SpscQueueTest, WaitingSidesSleep) {
+        Spsc_Queue<int> queue(2);
+
+        // A consumer waiting on a slow producer
+        double consumer_cpu = 0.0;
+        std::thread consumer([&]() {
+            double start = thread_cpu_seconds();
+            EXPECT_EQ(queue.pop(), 42);
+            consumer_cpu = thread_cpu_seconds() - start;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        queue.push(42);
+        consumer.join();
+        EXPECT_LT(consumer_cpu, 0.05);
+
+        // A producer waiting on a slow consumer
+        queue.push(1);
+        queue.push(2);
+        double producer_cpu = 0.0;
+        std::thread producer([&]() {
+            double start = thread_cpu_seconds();
+            queue.push(3);
+            producer_cpu = thread_cpu_seconds() - start;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        EXPECT_EQ(queue.pop(), 1);
+        producer.join();
+        EXPECT_LT(producer_cpu, 0.05);
+        EXPECT_EQ(queue.pop(), 2);
+        EXPECT_EQ(queue.pop(), 3);
+    }
+
+    std::vector<double> sample_prices(size_t index) {
+        std::vector<double> prices;
+        double price = 50.0 + 10.0 * index;
+        for (size_t i = 0; i < 150; ++i) {
+            price *= 1.0 + 0.004 * std::sin(0.3 * i + index);
+            prices.push_back(price);
+        }
+        return prices;
+    }
+
+    TEST(IngestPipelineTest, MatchesStageByStageAndIdlesDuringFetches) {
+        std::vector<std::string> tickers = { "T0", "T1", "FAIL_FETCH", "T3", "FAIL_PARSE", "T5", "SHORT" };
+        std::map<std::string, std::vector<double>> expected_prices;
+        for (size_t i = 0; i < tickers.size(); ++i) {
+            if (tickers[i].rfind("FAIL", 0) != 0) {
+                expected_prices[tickers[i]] = sample_prices(i);
+            }
+        }
+        expected_prices["SHORT"].resize(4);
+
+        // Each download takes 40 ms of waiting, like a network round trip
+        ingest::Fetch_Function fetch = [&](const std::string &ticker, std::string &payload) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(40));
+            payload = ticker;
+            return ticker != "FAIL_FETCH";
+        };
+        ingest::Parse_Function parse = [&](const std::string &ticker, const std::string &payload,
+                                           std::vector<double> &prices) {
+            if (ticker == "FAIL_PARSE" || payload != ticker) {
+                return false;
+            }
+            prices = expected_prices.at(ticker);
+            return true;
+        };
+
+        double cpu_start = process_cpu_seconds();
+        ingest::Ingest_Result result = ingest::run(tickers, fetch, parse, 2);
+        double cpu = process_cpu_seconds() - cpu_start;
+
+        EXPECT_EQ(result.ticker_to_prices, expected_prices);
+        std::map<std::string, double> initial = volParsing::tickerToVolHourly(expected_prices);
+        EXPECT_EQ(result.initial_volatility, initial);
+        EXPECT_EQ(result.true_volatility, volParsing::true_volatility(expected_prices, initial));
+        EXPECT_EQ(result.percentage_changes, calculate_percentage_changes(expected_prices));
+        EXPECT_EQ(result.true_volatility.count("SHORT"), 0u);
+
+        // Parse and compute threads sleep while the fetches wait, instead of spinning a core each
+        EXPECT_GE(result.wall_seconds, 7 * 0.04);
+        EXPECT_LT(cpu, result.wall_seconds / 2);
+    }
+
+    TEST(IngestPipelineTest, StageExceptionsReachTheCaller) {
+        std::vector<std::string> tickers;
+        for (size_t i = 0; i < 40; ++i) {
+            tickers.push_back("T" + std::to_string(i));
+        }
+        ingest::Fetch_Function fetch = [](const std::string &ticker, std::string &payload) {
+            payload = ticker;
+            return true;
+        };
+        ingest::Parse_Function parse = [](const std::string &, const std::string &, std::vector<double> &prices) {
+            prices = sample_prices(1);
+            return true;
+        };
+
+        // A throwing stage stops, the others drain their queues, and the exception comes out of run
+        ingest::Fetch_Function failing_fetch = [&](const std::string &ticker, std::string &payload) {
+            if (ticker == "T5") {
+                throw std::runtime_error("fetch failed");
+            }
+            return fetch(ticker, payload);
+        };
+        EXPECT_THROW(ingest::run(tickers, failing_fetch, parse, 2), std::runtime_error);
+
+        ingest::Parse_Function failing_parse = [&](const std::string &ticker, const std::string &payload,
+                                                   std::vector<double> &prices) {
+            if (ticker == "T3") {
+                throw std::invalid_argument("parse failed");
+            }
+            return parse(ticker, payload, prices);
+        };
+        EXPECT_THROW(ingest::run(tickers, fetch, failing_parse, 2), std::invalid_argument);
+
+        EXPECT_EQ(ingest::run(tickers, fetch, parse, 2).ticker_to_prices.size(), tickers.size());
+    }
+
+} // namespace IngestPipelineFunctions
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "multiAccount.h"
+
+namespace MultiAccountFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "NVDA", "AAPL", "MSFT", "TSLA", "META" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 80.0 + 40.0 * t;
+            for (size_t i = 0; i < hours; ++i) {
+                price *= 1.0 + (0.002 + 0.002 * t) * std::sin(0.5 * i + t) + 0.003 * std::cos(1.7 * i * (t + 1));
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    TEST(MultiAccountTest, EveryAccountMatchesItsOwnIncrementalRun) {
+        auto prices = sample_prices(250);
+        std::vector<std::string> tickers;
+        for (const auto &[ticker, series] : prices) {
+            tickers.push_back(ticker);
+        }
+
+        const std::vector<std::string> strategies = { "optimistic", "neutral", "conservative" };
+        std::vector<std::string> account_strategy;
+        std::vector<std::map<std::string, double>> account_holdings;
+        for (size_t a = 0; a < 300; ++a) {
+            std::map<std::string, double> holdings;
+            double capital = 1000.0 + 37.0 * a;
+            for (size_t i = 0; i < tickers.size(); ++i) {
+                holdings[tickers[i]] = capital * (1.0 + ((a + i) % 3)) / 10.0;
+            }
+            account_strategy.push_back(strategies[a % strategies.size()]);
+            account_holdings.push_back(holdings);
+        }
+
+        accounts::Multi_Account_Engine engine(tickers);
+        accounts::Multi_Account_Engine pooled_engine(tickers);
+        for (size_t a = 0; a < account_holdings.size(); ++a) {
+            EXPECT_EQ(engine.addAccount(account_strategy[a], account_holdings[a]), a);
+            pooled_engine.addAccount(account_strategy[a], account_holdings[a]);
+        }
+
+        // Two batches, the second through a thread pool
+        Thread_Pool pool(4);
+        std::map<std::string, std::vector<double>> first;
+        std::map<std::string, std::vector<double>> second;
+        for (const auto &[ticker, series] : prices) {
+            first[ticker].assign(series.begin(), series.begin() + 100);
+            second[ticker].assign(series.begin() + 100, series.end());
+        }
+        engine.advance(first);
+        engine.advance(second);
+        pooled_engine.advance(first, &pool);
+        pooled_engine.advance(second, &pool);
+        EXPECT_EQ(engine.hoursProcessed(), 250u);
+
+        for (size_t a = 0; a < account_holdings.size(); ++a) {
+            incremental::Engine_State single = incremental::start(account_strategy[a], account_holdings[a]);
+            incremental::advance(single, prices);
+            EXPECT_EQ(engine.portfolio(a), single.portfolio) << "account " << a;
+            EXPECT_EQ(pooled_engine.portfolio(a), single.portfolio) << "account " << a;
+            EXPECT_EQ(engine.strategy(a), account_strategy[a]);
+        }
+    }
+
+    TEST(MultiAccountTest, MissingBarsAndUnknownTickers) {
+        accounts::Multi_Account_Engine engine({ "BBB", "AAA" });
+        ASSERT_EQ(engine.tickers().front(), "AAA");
+        size_t id = engine.addAccount("neutral", { { "AAA", 100.0 }, { "ZZZ", 5.0 } });
+        EXPECT_EQ(engine.accountValue(id), 100.0);
+
+        // AAA moves; BBB has no bar
+        engine.advanceHour({ 10.0, std::nan("") });
+        engine.advanceHour({ 11.0, std::nan("") });
+        EXPECT_DOUBLE_EQ(engine.holding(id, 0), 110.0);
+        EXPECT_EQ(engine.holding(id, 1), 0.0);
+    }
+
+} // namespace MultiAccountFunctions
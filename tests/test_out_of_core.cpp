@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "outOfCore.h"
+
+namespace OutOfCoreFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "AAPL", "MSFT", "NVDA", "TSLA" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 100.0 + 50.0 * t;
+            // The last ticker stops trading early, so the store has NaN padding
+            size_t length = t + 1 == tickers.size() ? hours / 2 : hours;
+            for (size_t i = 0; i < length; ++i) {
+                price *= 1.0 + 0.006 * std::sin(0.4 * i + t) + 0.002 * std::cos(1.3 * i);
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    TEST(OutOfCoreTest, ChunkedRunMatchesInMemoryRun) {
+        auto prices = sample_prices(400);
+        std::map<std::string, double> portfolio = { { "AAPL", 5000.0 }, { "MSFT", 5000.0 }, { "NVDA", 5000.0 },
+                                                    { "TSLA", 5000.0 } };
+
+        incremental::Engine_State full = incremental::start("optimistic", portfolio);
+        incremental::advance(full, prices);
+
+        std::string path = ::testing::TempDir() + "test_out_of_core.bin";
+        ASSERT_TRUE(outOfCore::writeStore(path, prices));
+        for (size_t chunk_hours : { 1, 7, 64, 100000 }) {
+            outOfCore::Chunked_Result chunked =
+                outOfCore::processStore(path, incremental::start("optimistic", portfolio), chunk_hours);
+            EXPECT_EQ(chunked.chunks, (400 + chunk_hours - 1) / chunk_hours);
+            EXPECT_EQ(chunked.state.hours_processed, full.hours_processed);
+            EXPECT_LE(chunked.buffer_bytes, chunk_hours * prices.size() * sizeof(double));
+            for (const auto &[ticker, value] : full.portfolio) {
+                EXPECT_EQ(chunked.state.portfolio.at(ticker), value) << ticker << " chunk " << chunk_hours;
+            }
+            EXPECT_EQ(chunked.metrics.bars, 400u);
+        }
+        std::remove(path.c_str());
+    }
+
+    TEST(OutOfCoreTest, TailMetricsAreOptIn) {
+        std::map<std::string, double> portfolio = { { "AAPL", 5000.0 }, { "MSFT", 5000.0 } };
+        std::string path = ::testing::TempDir() + "test_out_of_core_tail.bin";
+        ASSERT_TRUE(outOfCore::writeStore(path, sample_prices(200)));
+
+        outOfCore::Chunked_Result bounded =
+            outOfCore::processStore(path, incremental::start("neutral", portfolio), 16);
+        EXPECT_EQ(bounded.metrics.value_at_risk, 0.0);
+        EXPECT_EQ(bounded.metrics.expected_shortfall, 0.0);
+
+        metrics::Metrics_Config config;
+        outOfCore::Chunked_Result full =
+            outOfCore::processStore(path, incremental::start("neutral", portfolio), 16, config);
+        EXPECT_GT(full.metrics.value_at_risk, 0.0);
+        EXPECT_EQ(full.metrics.sharpe, bounded.metrics.sharpe);
+        EXPECT_EQ(full.metrics.max_drawdown, bounded.metrics.max_drawdown);
+        std::remove(path.c_str());
+    }
+
+    TEST(OutOfCoreTest, TruncatedStoreIsReported) {
+        std::string path = ::testing::TempDir() + "test_out_of_core_truncated.bin";
+        ASSERT_TRUE(outOfCore::writeStore(path, sample_prices(100)));
+        std::map<std::string, double> portfolio = { { "AAPL", 5000.0 } };
+
+        outOfCore::Chunked_Result complete = outOfCore::processStore(path, incremental::start("neutral", portfolio), 8);
+        EXPECT_FALSE(complete.truncated);
+
+        // Cut the file in the middle of the last rows; the header still promises 100 hours
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fclose(file);
+        ASSERT_EQ(::truncate(path.c_str(), size - 20 * 4 * sizeof(double) - 3), 0);
+
+        outOfCore::Chunked_Result cut = outOfCore::processStore(path, incremental::start("neutral", portfolio), 8);
+        EXPECT_TRUE(cut.truncated);
+        EXPECT_EQ(cut.state.hours_processed, 72u);
+        EXPECT_EQ(cut.metrics.bars, 72u);
+        std::remove(path.c_str());
+    }
+
+    TEST(OutOfCoreTest, ReaderReportsShape) {
+        std::string path = ::testing::TempDir() + "test_out_of_core_shape.bin";
+        ASSERT_TRUE(outOfCore::writeStore(path, sample_prices(10)));
+
+        outOfCore::Bar_Store_Reader reader;
+        ASSERT_TRUE(reader.open(path));
+        EXPECT_EQ(reader.hours(), 10u);
+        ASSERT_EQ(reader.tickers().size(), 4u);
+        EXPECT_EQ(reader.tickers().front(), "AAPL");
+
+        std::vector<double> buffer;
+        EXPECT_EQ(reader.readChunk(6, buffer), 6u);
+        EXPECT_EQ(reader.readChunk(6, buffer), 4u);
+        EXPECT_TRUE(std::isnan(buffer.back())); // TSLA has only 5 bars
+        EXPECT_EQ(reader.readChunk(6, buffer), 0u);
+        std::remove(path.c_str());
+    }
+
+    TEST(OutOfCoreTest, RejectsMissingStore) {
+        outOfCore::Bar_Store_Reader reader;
+        EXPECT_FALSE(reader.open("does_not_exist.bin"));
+    }
+
+} // namespace OutOfCoreFunctions
@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "parallelManagers.h"
+
+namespace ParallelManagerFunctions {
+
+    struct Market {
+        std::map<std::string, std::vector<double>> volatility;
+        std::map<std::string, std::vector<double>> percentage_changes;
+        std::map<std::string, std::vector<double>> threshold_scales;
+        std::map<std::string, double> portfolio;
+    };
+
+    Market sample_market(size_t tickers, size_t hours) {
+        Market market;
+        for (size_t t = 0; t < tickers; ++t) {
+            std::string ticker = "T" + std::to_string(1000 + t);
+            // Uneven lengths exercise the "last value" and "no data" paths
+            size_t length = hours - (t % 5) * 3;
+            for (size_t i = 0; i < length; ++i) {
+                market.volatility[ticker].push_back(0.0035 + 0.0015 * std::sin(0.3 * i + 0.7 * t));
+                market.percentage_changes[ticker].push_back(0.8 * std::sin(0.9 * i + 1.3 * t));
+            }
+            if (t % 3 == 0) {
+                market.threshold_scales[ticker] = std::vector<double>(length / 2, 0.8 + 0.1 * (t % 4));
+            }
+            market.portfolio[ticker] = 1000.0 + t;
+        }
+        return market;
+    }
+
+    void expect_same_metrics(const metrics::Metrics_Summary &a, const metrics::Metrics_Summary &b) {
+        EXPECT_EQ(a.bars, b.bars);
+        EXPECT_EQ(a.last_value, b.last_value);
+        EXPECT_EQ(a.max_drawdown, b.max_drawdown);
+        EXPECT_EQ(a.sharpe, b.sharpe);
+        EXPECT_EQ(a.turnover, b.turnover);
+        EXPECT_EQ(a.value_at_risk, b.value_at_risk);
+    }
+
+    TEST(ParallelManagerTest, MatchesSerialForAnyThreadCount) {
+        for (const std::string strategy : { "optimistic", "neutral", "conservative" }) {
+            Market market = sample_market(37, 120);
+
+            std::map<std::string, double> serial_portfolio = market.portfolio;
+            Stock_Manager_Result serial_stock =
+                stock_manager(market.volatility, serial_portfolio, strategy, market.threshold_scales);
+            Portfolio_Manager_Result serial_result =
+                portfolio_manager(serial_stock.buying_stocks, serial_stock.reallocation_funds, serial_portfolio,
+                                  strategy, market.volatility, market.percentage_changes);
+
+            for (size_t threads : { 1, 2, 3, 8 }) {
+                Thread_Pool pool(threads);
+                std::map<std::string, double> portfolio = market.portfolio;
+                Stock_Manager_Result stock_result =
+                    parallel::stockManager(pool, market.volatility, portfolio, strategy, market.threshold_scales);
+                EXPECT_EQ(stock_result.buying_stocks, serial_stock.buying_stocks);
+                EXPECT_EQ(stock_result.selling_stocks, serial_stock.selling_stocks);
+                EXPECT_EQ(stock_result.reallocation_funds, serial_stock.reallocation_funds);
+
+                Portfolio_Manager_Result result =
+                    parallel::portfolioManager(pool, stock_result.buying_stocks, stock_result.reallocation_funds,
+                                               portfolio, strategy, market.volatility, market.percentage_changes);
+                EXPECT_EQ(result.allocations, serial_result.allocations) << strategy << " " << threads;
+                EXPECT_EQ(result.portfolio_values, serial_result.portfolio_values) << strategy << " " << threads;
+                EXPECT_EQ(portfolio, serial_portfolio) << strategy << " " << threads;
+                expect_same_metrics(result.metrics, serial_result.metrics);
+            }
+        }
+    }
+
+    TEST(ParallelManagerTest, MatchesSerialWithSelection) {
+        Market market = sample_market(37, 120);
+        std::map<std::string, double> stock_portfolio = market.portfolio;
+        Stock_Manager_Result stock_result =
+            stock_manager(market.volatility, stock_portfolio, "optimistic", market.threshold_scales);
+
+        Selection_Config top_only;
+        top_only.top_k = 3;
+        Selection_Config tickets;
+        tickets.min_ticket = 100.0;
+        Selection_Config both;
+        both.top_k = 5;
+        both.min_ticket = 15.0;
+        bool carried = false;
+        for (const Selection_Config &selection : { top_only, tickets, both }) {
+            std::map<std::string, double> serial_portfolio = stock_portfolio;
+            Portfolio_Manager_Result serial_result = portfolio_manager(
+                stock_result.buying_stocks, stock_result.reallocation_funds, serial_portfolio, "optimistic",
+                market.volatility, market.percentage_changes, metrics::Metrics_Config(), selection);
+            for (size_t hour = 0; hour < serial_result.allocations.size(); ++hour) {
+                carried = carried || (serial_result.allocations[hour].empty() &&
+                                      !stock_result.buying_stocks[hour].empty() &&
+                                      stock_result.reallocation_funds[hour] > 0);
+            }
+
+            for (size_t threads : { 1, 3, 8 }) {
+                Thread_Pool pool(threads);
+                std::map<std::string, double> portfolio = stock_portfolio;
+                Portfolio_Manager_Result result = parallel::portfolioManager(
+                    pool, stock_result.buying_stocks, stock_result.reallocation_funds, portfolio, "optimistic",
+                    market.volatility, market.percentage_changes, metrics::Metrics_Config(), selection);
+                EXPECT_EQ(result.allocations, serial_result.allocations) << selection.top_k << " " << threads;
+                EXPECT_EQ(result.portfolio_values, serial_result.portfolio_values) << threads;
+                EXPECT_EQ(result.unallocated_funds, serial_result.unallocated_funds) << threads;
+                EXPECT_EQ(portfolio, serial_portfolio) << threads;
+                expect_same_metrics(result.metrics, serial_result.metrics);
+            }
+        }
+        EXPECT_TRUE(carried); // Some hour carries its funds for lack of a full ticket
+    }
+
+    TEST(ParallelManagerTest, BuyingATickerThatIsNotHeld) {
+        std::map<std::string, std::vector<double>> volatility = { { "AAA", { 0.002, 0.002 } },
+                                                                  { "BBB", { 0.003, 0.003 } } };
+        std::map<std::string, std::vector<double>> changes = { { "AAA", { 1.0, -2.0, 3.0 } },
+                                                               { "BBB", { 5.0, 5.0, 5.0 } } };
+        std::vector<std::vector<std::string>> buying = { {}, { "BBB", "AAA" }, { "BBB" } };
+        std::vector<double> funds = { 0.0, 100.0, 50.0 };
+
+        std::map<std::string, double> serial_portfolio = { { "AAA", 1000.0 } };
+        Portfolio_Manager_Result serial_result =
+            portfolio_manager(buying, funds, serial_portfolio, "optimistic", volatility, changes);
+
+        Thread_Pool pool(4);
+        std::map<std::string, double> portfolio = { { "AAA", 1000.0 } };
+        Portfolio_Manager_Result result =
+            parallel::portfolioManager(pool, buying, funds, portfolio, "optimistic", volatility, changes);
+
+        EXPECT_EQ(result.allocations, serial_result.allocations);
+        EXPECT_EQ(result.portfolio_values, serial_result.portfolio_values);
+        EXPECT_EQ(portfolio, serial_portfolio);
+        expect_same_metrics(result.metrics, serial_result.metrics);
+    }
+
+    TEST(ParallelManagerTest, HourWithoutBuyersCarriesItsFunds) {
+        std::map<std::string, std::vector<double>> volatility = { { "AAA", { 0.002, 0.002, 0.002 } },
+                                                                  { "BBB", { 0.003, 0.003, 0.003 } } };
+        std::map<std::string, std::vector<double>> changes = { { "AAA", { 1.0, -2.0, 3.0 } },
+                                                               { "BBB", { 5.0, 5.0, 5.0 } } };
+        std::vector<std::vector<std::string>> buying = { {}, { "BBB", "AAA" }, {} };
+        std::vector<double> funds = { 80.0, 170.0, 30.0 };
+        Selection_Config selection;
+        selection.min_ticket = 100.0;
+
+        std::map<std::string, double> serial_portfolio = { { "AAA", 1000.0 } };
+        Portfolio_Manager_Result serial_result = portfolio_manager(buying, funds, serial_portfolio, "optimistic",
+                                                                   volatility, changes, metrics::Metrics_Config(),
+                                                                   selection);
+        ASSERT_EQ(serial_result.allocations[1].size(), 2u); // 250 makes two full tickets, 170 alone only one
+
+        Thread_Pool pool(4);
+        std::map<std::string, double> portfolio = { { "AAA", 1000.0 } };
+        Portfolio_Manager_Result result = parallel::portfolioManager(pool, buying, funds, portfolio, "optimistic",
+                                                                     volatility, changes, metrics::Metrics_Config(),
+                                                                     selection);
+        EXPECT_EQ(result.allocations, serial_result.allocations);
+        EXPECT_EQ(result.portfolio_values, serial_result.portfolio_values);
+        EXPECT_EQ(result.unallocated_funds, 30.0);
+        EXPECT_EQ(result.unallocated_funds, serial_result.unallocated_funds);
+        EXPECT_EQ(portfolio, serial_portfolio);
+        expect_same_metrics(result.metrics, serial_result.metrics);
+    }
+
+    TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+        Thread_Pool pool(6);
+        for (size_t round = 0; round < 50; ++round) {
+            std::vector<int> hits(1000, 0);
+            pool.run(hits.size(), [&](size_t i) { ++hits[i]; });
+            for (int hit : hits) {
+                ASSERT_EQ(hit, 1);
+            }
+        }
+    }
+
+} // namespace ParallelManagerFunctions
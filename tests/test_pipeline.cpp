@@ -0,0 +1,214 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "pipeline.h"
+
+namespace PipelineFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours, double drift = 0.0) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "NVDA", "AAPL", "MSFT" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 100.0 + 40.0 * t;
+            for (size_t i = 0; i < hours; ++i) {
+                price *= 1.0 + drift + (0.003 + 0.002 * t) * std::sin(0.4 * i + t) + 0.002 * std::cos(1.1 * i);
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    std::map<std::string, double> equal_portfolio(const std::map<std::string, std::vector<double>> &prices) {
+        std::map<std::string, double> portfolio;
+        for (const auto &[ticker, series] : prices) {
+            portfolio[ticker] = 20000.0 / prices.size();
+        }
+        return portfolio;
+    }
+
+    // Stats in topological order: prices, initial_volatility, true_volatility, percentage_changes, managers
+    pipeline::Stage_Stats stage(const pipeline::StageGraph &graph, size_t index) { return graph.stats()[index]; }
+
+    TEST(PipelineTest, StagesAreComputedOnce) {
+        pipeline::StageGraph graph;
+        auto prices = sample_prices(200);
+        graph.setPrices(prices);
+
+        graph.trueVolatility();
+        graph.trueVolatility();
+        EXPECT_EQ(stage(graph, 2).misses, 1u);
+        EXPECT_EQ(stage(graph, 2).hits, 1u);
+
+        // hours() only looks at the stage and leaves its statistics alone
+        size_t hours = graph.hours();
+        EXPECT_GT(hours, 0u);
+        EXPECT_EQ(stage(graph, 2).hits, 1u);
+
+        auto portfolio = equal_portfolio(prices);
+        const pipeline::Run_Result &first = graph.run("neutral", portfolio);
+        double first_value = first.final_value;
+        const pipeline::Run_Result &second = graph.run("neutral", portfolio);
+        EXPECT_EQ(second.final_value, first_value);
+        EXPECT_EQ(stage(graph, 4).misses, 1u);
+        EXPECT_EQ(stage(graph, 4).hits, 1u);
+
+        graph.run("conservative", portfolio);
+        EXPECT_EQ(stage(graph, 4).misses, 2u);
+        EXPECT_EQ(stage(graph, 1).misses, 1u);
+        EXPECT_EQ(stage(graph, 3).misses, 1u);
+    }
+
+    TEST(PipelineTest, SetPricesInvalidatesOnlyOnChange) {
+        pipeline::StageGraph graph;
+        auto prices = sample_prices(200);
+        graph.setPrices(prices);
+        auto portfolio = equal_portfolio(prices);
+        double before = graph.run("optimistic", portfolio).final_value;
+
+        // The same contents keep every stage
+        graph.setPrices(prices);
+        EXPECT_EQ(graph.run("optimistic", portfolio).final_value, before);
+        EXPECT_EQ(stage(graph, 2).misses, 1u);
+        EXPECT_EQ(stage(graph, 4).misses, 1u);
+
+        // New contents recompute every stage and the managers
+        auto changed = sample_prices(200, 0.001);
+        graph.setPrices(changed);
+        double after = graph.run("optimistic", portfolio).final_value;
+        EXPECT_EQ(stage(graph, 1).misses, 2u);
+        EXPECT_EQ(stage(graph, 2).misses, 2u);
+        EXPECT_EQ(stage(graph, 3).misses, 2u);
+        EXPECT_EQ(stage(graph, 4).misses, 2u);
+        EXPECT_NE(after, before);
+
+        pipeline::StageGraph fresh;
+        fresh.setPrices(changed);
+        EXPECT_EQ(fresh.run("optimistic", portfolio).final_value, after);
+    }
+
+    TEST(PipelineTest, RunCacheDropsLeastRecentlyUsed) {
+        pipeline::StageGraph graph(3);
+        auto prices = sample_prices(200);
+        graph.setPrices(prices);
+        auto portfolio = equal_portfolio(prices);
+
+        graph.run("neutral", portfolio, 0, 50);
+        graph.run("neutral", portfolio, 0, 60);
+        graph.run("neutral", portfolio, 0, 70);
+        graph.run("neutral", portfolio, 0, 50); // Refreshes the first window
+        graph.run("neutral", portfolio, 0, 80); // Drops the 60-hour window
+        EXPECT_EQ(stage(graph, 4).evictions, 1u);
+        EXPECT_EQ(stage(graph, 4).misses, 4u);
+
+        graph.run("neutral", portfolio, 0, 50);
+        EXPECT_EQ(stage(graph, 4).hits, 2u);
+        graph.run("neutral", portfolio, 0, 60);
+        EXPECT_EQ(stage(graph, 4).misses, 5u);
+        EXPECT_EQ(stage(graph, 4).evictions, 2u);
+    }
+
+    // Hours [begin, end) of every series that reaches the window, cut by hand
+    std::map<std::string, std::vector<double>> window_of(const std::map<std::string, std::vector<double>> &series,
+                                                         size_t begin, size_t end) {
+        std::map<std::string, std::vector<double>> window;
+        for (const auto &[ticker, values] : series) {
+            if (begin < values.size()) {
+                size_t last = std::min(end, values.size());
+                window[ticker] = std::vector<double>(values.begin() + begin, values.begin() + last);
+            }
+        }
+        return window;
+    }
+
+    // Runs the managers directly on the given windows and returns the fractional return
+    double window_return(const std::map<std::string, std::vector<double>> &volatility,
+                         const std::map<std::string, std::vector<double>> &changes, const std::string &strategy,
+                         std::map<std::string, double> portfolio) {
+        double initial = portfolio_value(portfolio);
+        Stock_Manager_Result stock_result = stock_manager(volatility, portfolio, strategy);
+        portfolio_manager(stock_result.buying_stocks, stock_result.reallocation_funds, portfolio, strategy, volatility,
+                          changes);
+        return portfolio_value(portfolio) / initial - 1.0;
+    }
+
+    TEST(PipelineTest, WalkForwardMatchesWindowRuns) {
+        pipeline::StageGraph graph;
+        auto prices = sample_prices(300);
+        graph.setPrices(prices);
+        ASSERT_EQ(graph.hours(), 294u); // 300 prices less the volatility warm-up
+
+        pipeline::Walk_Forward_Config config;
+        config.train_hours = 80;
+        config.test_hours = 40;
+        config.step_hours = 60;
+        std::vector<pipeline::Walk_Forward_Window> windows = pipeline::walkForward(graph, config);
+
+        // Windows that fit in 294 hours: train [b, b + 80), test [b + 80, b + 120) for b = 0, 60, 120
+        const size_t expected[][3] = { { 0, 80, 120 }, { 60, 140, 180 }, { 120, 200, 240 } };
+        ASSERT_EQ(windows.size(), std::size(expected));
+
+        std::map<std::string, double> portfolio;
+        for (const auto &[ticker, series] : prices) {
+            portfolio[ticker] = config.initial_investment / prices.size();
+        }
+        const auto &volatility = graph.trueVolatility();
+        const auto &changes = graph.percentageChanges();
+        for (size_t w = 0; w < windows.size(); ++w) {
+            const pipeline::Walk_Forward_Window &window = windows[w];
+            EXPECT_EQ(window.train_begin, expected[w][0]);
+            EXPECT_EQ(window.test_begin, expected[w][1]);
+            EXPECT_EQ(window.test_end, expected[w][2]);
+
+            // The picked strategy has the best train return of all candidates
+            std::map<std::string, double> train_returns;
+            for (const auto &strategy : config.strategies) {
+                train_returns[strategy] = window_return(window_of(volatility, expected[w][0], expected[w][1]),
+                                                        window_of(changes, expected[w][0], expected[w][1]), strategy,
+                                                        portfolio);
+            }
+            ASSERT_EQ(train_returns.count(window.strategy), 1u);
+            EXPECT_EQ(window.train_return, train_returns[window.strategy]);
+            for (const auto &[strategy, train_return] : train_returns) {
+                EXPECT_LE(train_return, window.train_return) << strategy;
+            }
+
+            double test_return = window_return(window_of(volatility, expected[w][1], expected[w][2]),
+                                               window_of(changes, expected[w][1], expected[w][2]), window.strategy,
+                                               portfolio);
+            EXPECT_EQ(window.test_return, test_return);
+        }
+    }
+
+    TEST(PipelineTest, WindowPastAShortSeriesAppliesNoChange) {
+        auto prices = sample_prices(300);
+        prices["MSFT"].resize(150);
+        pipeline::StageGraph graph;
+        graph.setPrices(prices);
+        auto portfolio = equal_portfolio(prices);
+        const auto &volatility = graph.trueVolatility();
+        const auto &changes = graph.percentageChanges();
+        size_t begin = 200;
+        size_t end = 250;
+        ASSERT_LT(volatility.at("MSFT").size(), begin);
+        ASSERT_LT(changes.at("MSFT").size(), begin);
+
+        // MSFT holds its last volatility, as stock_manager does past the end, and its value no longer changes
+        auto volatility_window = window_of(volatility, begin, end);
+        volatility_window["MSFT"] = { volatility.at("MSFT").back() };
+        auto changes_window = window_of(changes, begin, end);
+        EXPECT_EQ(changes_window.count("MSFT"), 0u);
+
+        std::map<std::string, double> expected = portfolio;
+        Stock_Manager_Result stock_result = stock_manager(volatility_window, expected, "neutral");
+        portfolio_manager(stock_result.buying_stocks, stock_result.reallocation_funds, expected, "neutral",
+                          volatility_window, changes_window);
+
+        const pipeline::Run_Result &run = graph.run("neutral", portfolio, begin, end);
+        EXPECT_EQ(run.final_portfolio, expected);
+    }
+
+} // namespace PipelineFunctions
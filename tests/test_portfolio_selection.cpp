@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "portfolio_manager.h"
+
+namespace PortfolioSelectionFunctions {
+
+    // Tickers T000..T(n-1); volatility rises with the index, so the optimistic weight falls with it
+    std::map<std::string, std::vector<double>> sample_volatility(size_t tickers, size_t hours) {
+        std::map<std::string, std::vector<double>> volatility;
+        for (size_t t = 0; t < tickers; ++t) {
+            char name[32]; // Room for any size_t, so the name is never truncated
+            std::snprintf(name, sizeof(name), "T%03zu", t);
+            for (size_t h = 0; h < hours; ++h) {
+                volatility[name].push_back(0.001 + 0.0001 * t + 0.00001 * ((h + t) % 5));
+            }
+        }
+        return volatility;
+    }
+
+    std::vector<std::vector<std::string>> every_ticker_every_hour(
+        const std::map<std::string, std::vector<double>>& volatility, size_t hours) {
+        std::vector<std::string> all;
+        for (const auto& [ticker, series] : volatility) {
+            all.push_back(ticker);
+        }
+        return std::vector<std::vector<std::string>>(hours, all);
+    }
+
+    TEST(PortfolioSelectionTest, DefaultSelectionKeepsEveryCandidate) {
+        auto volatility = sample_volatility(50, 20);
+        auto buying = every_ticker_every_hour(volatility, 20);
+        std::vector<double> funds(20, 1000.0);
+        std::map<std::string, std::vector<double>> changes;
+
+        std::map<std::string, double> portfolio;
+        Portfolio_Manager_Result result =
+            portfolio_manager(buying, funds, portfolio, "optimistic", volatility, changes, metrics::Metrics_Config(),
+                              Selection_Config());
+        for (const auto& allocation : result.allocations) {
+            EXPECT_EQ(allocation.size(), 50u);
+        }
+        EXPECT_EQ(result.unallocated_funds, 0.0);
+    }
+
+    TEST(PortfolioSelectionTest, TopKKeepsTheHeaviestCandidates) {
+        auto volatility = sample_volatility(200, 10);
+        auto buying = every_ticker_every_hour(volatility, 10);
+        // Shuffle the candidate order so the selection cannot rely on it
+        for (auto& hour : buying) {
+            std::reverse(hour.begin(), hour.begin() + 100);
+        }
+        std::vector<double> funds(10, 5000.0);
+        std::map<std::string, std::vector<double>> changes;
+
+        Selection_Config selection;
+        selection.top_k = 7;
+        std::map<std::string, double> portfolio;
+        Portfolio_Manager_Result result = portfolio_manager(buying, funds, portfolio, "conservative", volatility,
+                                                           changes, metrics::Metrics_Config(), selection);
+
+        // Brute force: weights of every candidate, sorted
+        std::vector<std::pair<double, std::string>> weights;
+        for (const auto& [ticker, series] : volatility) {
+            double sum = 0.0;
+            for (double vol : series) {
+                sum += vol;
+            }
+            weights.emplace_back(allocation_weight(sum / series.size(), "conservative"), ticker);
+        }
+        std::sort(weights.begin(), weights.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        for (const auto& allocation : result.allocations) {
+            ASSERT_EQ(allocation.size(), 7u);
+            double total = 0.0;
+            for (size_t k = 0; k < 7; ++k) {
+                ASSERT_TRUE(allocation.count(weights[k].second)) << weights[k].second;
+                total += allocation.at(weights[k].second);
+            }
+            EXPECT_NEAR(total, 5000.0, 1e-9);
+        }
+        EXPECT_EQ(portfolio.size(), 7u);
+    }
+
+    TEST(PortfolioSelectionTest, MinimumTicketDropsDustAndCarriesFunds) {
+        auto volatility = sample_volatility(40, 6);
+        auto buying = every_ticker_every_hour(volatility, 6);
+        std::map<std::string, std::vector<double>> changes;
+
+        Selection_Config selection;
+        selection.min_ticket = 100.0;
+
+        // Neutral splits 1000 equally: 40 tickets of 25 are dust, 10 tickets of 100 are not
+        std::vector<double> funds = { 1000.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        std::map<std::string, double> portfolio;
+        Portfolio_Manager_Result result = portfolio_manager(buying, funds, portfolio, "neutral", volatility, changes,
+                                                           metrics::Metrics_Config(), selection);
+        ASSERT_EQ(result.allocations[0].size(), 10u);
+        for (const auto& [ticker, allocation] : result.allocations[0]) {
+            EXPECT_GE(allocation, 100.0);
+        }
+        EXPECT_NEAR(portfolio_value(portfolio), 1000.0, 1e-9);
+
+        // Funds below one ticket wait until enough has been sold
+        funds = { 30.0, 40.0, 50.0, 0.0, 0.0, 0.0 };
+        portfolio.clear();
+        result = portfolio_manager(buying, funds, portfolio, "neutral", volatility, changes, metrics::Metrics_Config(),
+                                   selection);
+        EXPECT_TRUE(result.allocations[0].empty());
+        EXPECT_TRUE(result.allocations[1].empty());
+        ASSERT_EQ(result.allocations[2].size(), 1u);
+        EXPECT_DOUBLE_EQ(result.allocations[2].begin()->second, 120.0);
+        EXPECT_EQ(result.unallocated_funds, 0.0);
+
+        funds = { 30.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        portfolio.clear();
+        result = portfolio_manager(buying, funds, portfolio, "neutral", volatility, changes, metrics::Metrics_Config(),
+                                   selection);
+        EXPECT_TRUE(portfolio.empty());
+        EXPECT_DOUBLE_EQ(result.unallocated_funds, 30.0);
+    }
+
+    TEST(PortfolioSelectionTest, HourWithoutBuyersCarriesItsFunds) {
+        auto volatility = sample_volatility(3, 3);
+        std::map<std::string, std::vector<double>> changes;
+        std::vector<std::vector<std::string>> buying = { {}, { "T000" }, {} };
+        std::vector<double> funds = { 80.0, 40.0, 30.0 };
+
+        Selection_Config selection;
+        selection.min_ticket = 100.0;
+        std::map<std::string, double> portfolio;
+        Portfolio_Manager_Result result = portfolio_manager(buying, funds, portfolio, "neutral", volatility, changes,
+                                                           metrics::Metrics_Config(), selection);
+
+        // Hour 0's proceeds wait for hour 1, where together they make a full ticket; hour 2 has nobody to buy
+        EXPECT_TRUE(result.allocations[0].empty());
+        ASSERT_EQ(result.allocations[1].size(), 1u);
+        EXPECT_DOUBLE_EQ(result.allocations[1].at("T000"), 120.0);
+        EXPECT_DOUBLE_EQ(result.unallocated_funds, 30.0);
+
+        // No money left the account, so the net asset value never fell
+        EXPECT_EQ(result.metrics.max_drawdown, 0.0);
+        EXPECT_DOUBLE_EQ(result.metrics.last_value, 150.0);
+    }
+
+    TEST(PortfolioSelectionTest, MinimumTicketOverManyCandidates) {
+        // Weights fall with the ticker index, so the kept candidates are the longest full-ticket prefix by index
+        auto volatility = sample_volatility(500, 4);
+        auto buying = every_ticker_every_hour(volatility, 4);
+        for (auto& hour : buying) {
+            std::reverse(hour.begin(), hour.end());
+        }
+        std::map<std::string, std::vector<double>> changes;
+        std::vector<double> funds = { 1000.0, 5000.0, 20.0, 0.0 };
+
+        Selection_Config selection;
+        selection.min_ticket = 60.0;
+        std::map<std::string, double> portfolio;
+        Portfolio_Manager_Result result = portfolio_manager(buying, funds, portfolio, "optimistic", volatility,
+                                                           changes, metrics::Metrics_Config(), selection);
+
+        std::vector<double> weights;
+        for (const auto& [ticker, series] : volatility) {
+            double sum = 0.0;
+            for (double vol : series) {
+                sum += vol;
+            }
+            weights.push_back(allocation_weight(sum / series.size(), "optimistic"));
+        }
+        for (size_t hour = 0; hour < 2; ++hour) {
+            size_t kept = 0;
+            double prefix_weight = 0.0;
+            while (kept < weights.size() &&
+                   weights[kept] / (prefix_weight + weights[kept]) * funds[hour] >= selection.min_ticket) {
+                prefix_weight += weights[kept++];
+            }
+            ASSERT_EQ(result.allocations[hour].size(), kept) << hour;
+            for (const auto& [ticker, allocation] : result.allocations[hour]) {
+                EXPECT_LT(std::stoul(ticker.substr(1)), kept) << ticker;
+                EXPECT_GE(allocation, selection.min_ticket) << ticker;
+            }
+        }
+        EXPECT_TRUE(result.allocations[2].empty());
+        EXPECT_DOUBLE_EQ(result.unallocated_funds, 20.0);
+    }
+
+} // namespace PortfolioSelectionFunctions
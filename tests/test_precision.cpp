@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "portfolio_manager.h"
+#include "precision.h"
+#include "stock_manager.h"
+
+namespace PrecisionFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices() {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "NVDA", "AAPL", "MSFT" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 100.0 + 40.0 * t;
+            for (size_t i = 0; i < 400; ++i) {
+                price *= 1.0 + (0.003 + 0.002 * t) * std::sin(0.4 * i + t) + 0.002 * std::cos(1.3 * i);
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    TEST(PrecisionTest, DoubleKernelsMatchTheMainPath) {
+        auto prices = sample_prices();
+        auto initial = volParsing::tickerToVolHourly(prices);
+        auto expected = volParsing::true_volatility(prices, initial);
+        auto changes = calculate_percentage_changes(prices);
+        for (const auto &[ticker, series] : prices) {
+            EXPECT_EQ(precision::trueVolatility(series), expected.at(ticker)) << ticker;
+            EXPECT_EQ(precision::percentageChanges(series), changes.at(ticker)) << ticker;
+        }
+    }
+
+    TEST(PrecisionTest, CompareToDoubleBoundsTheFloatDrift) {
+        auto prices = sample_prices();
+        precision::Accuracy_Report report = precision::compareToDouble(prices, "neutral");
+
+        // 400 prices give 394 volatilities and 399 percentage changes per ticker
+        EXPECT_EQ(report.decisions, 3u * 394);
+        EXPECT_EQ(report.bytes_double, 3u * (400 + 394 + 399) * sizeof(double));
+        EXPECT_EQ(report.bytes_float * 2, report.bytes_double);
+        EXPECT_LE(report.decision_mismatches, report.decisions);
+
+        // Float keeps about 7 significant digits
+        EXPECT_GT(report.max_rel_error_price, 0.0);
+        EXPECT_LT(report.max_rel_error_price, 1e-7);
+        EXPECT_LT(report.max_rel_error_volatility, 1e-3);
+        EXPECT_LT(report.max_abs_error_percentage, 1e-4);
+    }
+
+    TEST(PrecisionTest, ExactFloatPricesOnlyRoundTheOutputs) {
+        // Quarter-dollar prices are exact in float, so only the stored outputs are rounded
+        std::map<std::string, std::vector<double>> prices;
+        for (int i = 0; i < 100; ++i) {
+            prices["QTR"].push_back(100.0 + 0.25 * ((i * 7) % 13));
+        }
+        precision::Accuracy_Report report = precision::compareToDouble(prices, "conservative");
+        EXPECT_EQ(report.max_rel_error_price, 0.0);
+        EXPECT_LE(report.max_rel_error_volatility, std::ldexp(1.0, -24));
+        EXPECT_EQ(report.decisions, 94u);
+
+        precision::Accuracy_Report empty = precision::compareToDouble({}, "neutral");
+        EXPECT_EQ(empty.decisions, 0u);
+        EXPECT_EQ(empty.bytes_double, 0u);
+    }
+
+    TEST(PrecisionTest, FloatColumnsDriveTheManagers) {
+        auto prices = sample_prices();
+        auto volatility = volParsing::true_volatility(prices, volParsing::tickerToVolHourly(prices));
+        auto changes = calculate_percentage_changes(prices);
+
+        std::map<std::string, double> exact_portfolio = { { "NVDA", 1000.0 }, { "AAPL", 1000.0 }, { "MSFT", 1000.0 } };
+        std::map<std::string, double> float_portfolio = exact_portfolio;
+        Stock_Manager_Result exact = stock_manager(volatility, exact_portfolio, "optimistic");
+        portfolio_manager(exact.buying_stocks, exact.reallocation_funds, exact_portfolio, "optimistic", volatility,
+                          changes);
+
+        // The double columns are handed over, not copied, and released as they are converted
+        const double *first_column = volatility.at("AAPL").data();
+        precision::Column_Map<double> kept = precision::toStorage<double>(std::move(volatility));
+        EXPECT_EQ(kept.at("AAPL").data(), first_column);
+        precision::Column_Map<float> volatility_float = precision::toStorage<float>(std::move(kept));
+        precision::Column_Map<float> changes_float = precision::toStorage<float>(std::move(changes));
+        EXPECT_TRUE(kept.empty());
+        EXPECT_EQ(volatility_float.at("AAPL").size(), 394u);
+
+        Stock_Manager_Result approx = stock_manager(volatility_float, float_portfolio, "optimistic");
+        portfolio_manager(approx.buying_stocks, approx.reallocation_funds, float_portfolio, "optimistic",
+                          volatility_float, changes_float);
+
+        // Thresholds sit far from these volatilities, so rounding changes no decision and only nudges the holdings
+        EXPECT_EQ(approx.buying_stocks, exact.buying_stocks);
+        EXPECT_EQ(approx.selling_stocks, exact.selling_stocks);
+        for (const auto &[ticker, value] : exact_portfolio) {
+            EXPECT_NEAR(float_portfolio.at(ticker), value, 1e-5 * value) << ticker;
+        }
+    }
+
+} // namespace PrecisionFunctions
@@ -0,0 +1,89 @@
+"""Smoke test of the pyvolatility module against results of the C++ library."""
+import math
+import os
+import tempfile
+import unittest
+
+import numpy as np
+import pyvolatility as pv
+
+
+def sample_prices():
+    return np.array([100.0 + 5.0 * math.sin(0.3 * i) + 0.1 * i for i in range(40)])
+
+
+class PyVolatilityTest(unittest.TestCase):
+    # volFormula::volatilityAlgorithm and volParsing::true_volatility on sample_prices(), printed by the C++ library
+    CPP_VOLATILITY = 0.010223531301808666
+    CPP_TRUE_VOLATILITY = {0: 0.0045487116583856303, 1: 0.0045345246399412786, 10: 0.007340932172672468,
+                           33: 0.0090582329546872748}
+
+    def test_volatility_matches_cpp(self):
+        prices = sample_prices()
+        self.assertAlmostEqual(pv.volatility(prices), self.CPP_VOLATILITY, delta=1e-15)
+        self.assertAlmostEqual(pv.volatility(prices), np.std(np.diff(np.log(prices)), ddof=1), delta=1e-15)
+
+        volatility = pv.true_volatility(prices)
+        self.assertIsInstance(volatility, np.ndarray)
+        self.assertEqual(volatility.shape, (34,))
+        for index, expected in self.CPP_TRUE_VOLATILITY.items():
+            self.assertAlmostEqual(volatility[index], expected, delta=1e-15)
+
+        # Lists are converted, float64 arrays are read in place; both give the same result
+        np.testing.assert_array_equal(pv.true_volatility(list(prices)), volatility)
+        np.testing.assert_array_equal(pv.true_volatility_map({"A": prices})["A"], volatility)
+        self.assertEqual(pv.update_volatility(0.01, 101.0, 100.0),
+                         pv.update_volatility(old_volatility=0.01, new_price=101.0, old_price=100.0, lambda_=0.94))
+
+    def test_managers_and_checkpoints(self):
+        prices = {"AAPL": sample_prices(), "MSFT": sample_prices()[::-1].copy()}
+        volatility = pv.true_volatility_map(prices)
+        result, portfolio = pv.stock_manager(volatility, {"AAPL": 1000.0, "MSFT": 1000.0}, "neutral")
+        self.assertEqual(len(result["buying_stocks"]), 34)
+        self.assertEqual(result["reallocation_funds"].shape, (34,))
+        changes = {ticker: pv.percentage_changes(series)[6:] for ticker, series in prices.items()}
+        managed, holdings = pv.portfolio_manager(result["buying_stocks"], result["reallocation_funds"], portfolio,
+                                                 "neutral", volatility, changes)
+        self.assertEqual(len(managed["portfolio_values"]), 34)
+        self.assertEqual(managed["portfolio_values"][-1], holdings)
+        self.assertEqual(managed["metrics"].bars, 35)  # Opening value and one per hour
+        self.assertEqual(managed["unallocated_funds"], 0.0)
+
+        # No ticket can be this large, so nothing is allocated and the proceeds are carried to the end
+        _, kept = pv.stock_manager(volatility, {"AAPL": 1000.0, "MSFT": 1000.0}, "neutral")
+        carried, _ = pv.portfolio_manager(result["buying_stocks"], result["reallocation_funds"], kept, "neutral",
+                                          volatility, changes, selection=pv.SelectionConfig(min_ticket=1e12))
+        self.assertTrue(all(not allocation for allocation in carried["allocations"]))
+        self.assertGreater(carried["unallocated_funds"], 0.0)
+        self.assertLessEqual(carried["unallocated_funds"], result["reallocation_funds"].sum() + 1e-9)
+
+        engine = pv.IncrementalEngine("neutral", {"AAPL": 1000.0, "MSFT": 1000.0})
+        engine.advance({ticker: series[:20] for ticker, series in prices.items()})
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "engine.bin")
+            self.assertTrue(engine.save(path))
+            resumed = pv.IncrementalEngine.load(path)
+        resumed.advance({ticker: series[20:] for ticker, series in prices.items()})
+        whole = pv.IncrementalEngine("neutral", {"AAPL": 1000.0, "MSFT": 1000.0})
+        whole.advance(prices)
+        self.assertEqual(resumed.hours_processed, 40)
+        self.assertEqual(resumed.portfolio, whole.portfolio)
+
+        index = pv.RangeIndex(prices["AAPL"])
+        self.assertEqual(len(index), 40)
+        self.assertAlmostEqual(index.mean(0, 40), prices["AAPL"].mean(), delta=1e-9)
+        self.assertEqual(index.max(5, 15), prices["AAPL"][5:15].max())
+
+    def test_errors_become_python_exceptions(self):
+        with self.assertRaises(ValueError):
+            pv.volatility(np.array([1.0, 2.0]))
+        with self.assertRaises(ValueError):
+            pv.true_volatility(np.ones((2, 2)))
+        with self.assertRaises(TypeError):
+            pv.true_volatility_map([1.0, 2.0])
+        with self.assertRaises(ValueError):
+            pv.IncrementalEngine.load("does_not_exist.bin")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "rangeIndex.h"
+
+namespace RangeIndexFunctions {
+
+    std::vector<double> sample_series() {
+        std::vector<double> values;
+        double price = 150.0;
+        for (int i = 0; i < 200; ++i) {
+            price *= 1.0 + 0.01 * std::sin(i * 0.7);
+            values.push_back(price);
+        }
+        return values;
+    }
+
+    TEST(RangeIndexTest, MatchesLinearScan) {
+        std::vector<double> values = sample_series();
+        rangeIndex::Range_Index index(values);
+
+        for (size_t begin = 0; begin < values.size(); begin += 7) {
+            for (size_t end = begin + 2; end <= values.size(); end += 11) {
+                double sum = std::accumulate(values.begin() + begin, values.begin() + end, 0.0);
+                double mean = sum / (end - begin);
+                double variance = 0.0;
+                for (size_t i = begin; i < end; ++i) {
+                    variance += (values[i] - mean) * (values[i] - mean);
+                }
+                variance /= (end - begin - 1);
+
+                EXPECT_NEAR(index.mean(begin, end), mean, 1e-9);
+                EXPECT_NEAR(index.variance(begin, end), variance, 1e-7);
+                EXPECT_EQ(index.min(begin, end), *std::min_element(values.begin() + begin, values.begin() + end));
+                EXPECT_EQ(index.max(begin, end), *std::max_element(values.begin() + begin, values.begin() + end));
+            }
+        }
+    }
+
+    TEST(RangeIndexTest, AppendMatchesBulkBuild) {
+        std::vector<double> values = sample_series();
+        rangeIndex::Range_Index bulk(values);
+        rangeIndex::Range_Index streamed;
+        for (double value : values) {
+            streamed.append(value);
+        }
+
+        ASSERT_EQ(streamed.size(), bulk.size());
+        EXPECT_EQ(streamed.min(13, 170), bulk.min(13, 170));
+        EXPECT_EQ(streamed.max(0, values.size()), bulk.max(0, values.size()));
+        EXPECT_DOUBLE_EQ(streamed.mean(50, 60), bulk.mean(50, 60));
+    }
+
+    TEST(RangeIndexTest, EmptyRangeIsNaN) {
+        rangeIndex::Range_Index index(std::vector<double>{ 1.0, 2.0, 3.0 });
+        EXPECT_TRUE(std::isnan(index.mean(2, 2)));
+        EXPECT_TRUE(std::isnan(index.min(5, 9)));
+        EXPECT_TRUE(std::isnan(index.variance(0, 1)));
+        EXPECT_EQ(index.max(1, 100), 3.0);
+    }
+
+    TEST(RangeIndexTest, VarianceOfALongDriftingSeries) {
+        // 1e5 values that climb from 1e6 by about 10 per step, with a small wobble on top
+        std::vector<double> values;
+        for (size_t i = 0; i < 100000; ++i) {
+            values.push_back(1e6 + 10.0 * i + 3.0 * std::sin(0.7 * i));
+        }
+        rangeIndex::Range_Index index(values);
+
+        for (size_t begin : { 0, 1, 4097, 65535, 99000, 99990 }) {
+            for (size_t length : { 2, 10, 333, 1024 }) {
+                size_t end = std::min(begin + length, values.size());
+                // Two-pass reference
+                double mean = std::accumulate(values.begin() + begin, values.begin() + end, 0.0) / (end - begin);
+                double variance = 0.0;
+                for (size_t i = begin; i < end; ++i) {
+                    variance += (values[i] - mean) * (values[i] - mean);
+                }
+                variance /= (end - begin - 1);
+                EXPECT_NEAR(index.variance(begin, end), variance, variance * 1e-10) << begin << " " << length;
+            }
+        }
+    }
+
+} // namespace RangeIndexFunctions
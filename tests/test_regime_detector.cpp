@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "regimeDetector.h"
+
+namespace RegimeDetectorFunctions {
+
+    // Calm volatility around 0.002 with some wobble, then a step to 0.02 at step_hour
+    std::vector<double> step_series(size_t hours, size_t step_hour) {
+        std::vector<double> volatility;
+        for (size_t i = 0; i < hours; ++i) {
+            double level = i < step_hour ? 0.002 : 0.02;
+            volatility.push_back(level * std::exp(0.15 * std::sin(0.7 * i) + 0.1 * std::cos(2.3 * i)));
+        }
+        return volatility;
+    }
+
+    double log_gaussian(double x, double mean, double variance) {
+        return -0.5 * (x - mean) * (x - mean) / variance - 0.5 * std::log(2.0 * M_PI * variance);
+    }
+
+    TEST(RegimeDetectorTest, PosteriorIsANormalizedForwardStep) {
+        regime::Regime_Config config;
+        regime::Regime_Detector detector(1, config);
+        std::vector<double> volatility = step_series(400, 250);
+
+        for (size_t i = 0; i < volatility.size(); ++i) {
+            regime::Regime_State before = detector.state(0);
+            detector.update(0, volatility[i]);
+            const regime::Regime_State &after = detector.state(0);
+            EXPECT_GE(after.p_turbulent, 0.0);
+            EXPECT_LE(after.p_turbulent, 1.0);
+            if (i < config.warmup || after.mean[0] != std::min(after.mean[0], after.mean[1])) {
+                continue;
+            }
+
+            // Forward step from the previous state: predict with the transition matrix, weight by the likelihood
+            double x = std::log(volatility[i]);
+            double stay = config.stay_probability;
+            double prior[2] = { before.p_turbulent * (1.0 - stay) + (1.0 - before.p_turbulent) * stay,
+                                before.p_turbulent * stay + (1.0 - before.p_turbulent) * (1.0 - stay) };
+            double joint[2];
+            for (int k = 0; k < 2; ++k) {
+                joint[k] = prior[k] * std::exp(log_gaussian(x, before.mean[k], before.variance[k]));
+            }
+            double calm = joint[0] / (joint[0] + joint[1]);
+            double turbulent = joint[1] / (joint[0] + joint[1]);
+            EXPECT_NEAR(calm + turbulent, 1.0, 1e-12);
+            EXPECT_NEAR(after.p_turbulent, turbulent, 1e-9) << i;
+        }
+    }
+
+    TEST(RegimeDetectorTest, FlipsToTurbulentOnAVolatilityStep) {
+        regime::Regime_Config config;
+        regime::Regime_Detector detector(1, config);
+        std::vector<double> volatility = step_series(300, 200);
+
+        for (size_t i = 0; i < 200; ++i) {
+            detector.update(0, volatility[i]);
+            if (i >= config.warmup) {
+                EXPECT_FALSE(detector.turbulent(0)) << i;
+            }
+        }
+        double calm_scale = detector.thresholdScale(0);
+
+        // The step is several calm deviations away, so the filter must switch within a few bars and stay there
+        size_t flipped_at = 0;
+        for (size_t i = 200; i < 300; ++i) {
+            detector.update(0, volatility[i]);
+            if (flipped_at == 0 && detector.turbulent(0)) {
+                flipped_at = i;
+            }
+        }
+        EXPECT_GT(flipped_at, 0u);
+        EXPECT_LE(flipped_at, 203u);
+        EXPECT_TRUE(detector.turbulent(0));
+        EXPECT_GT(detector.turbulentProbability(0), 0.99);
+        EXPECT_LT(detector.thresholdScale(0), calm_scale);
+    }
+
+    TEST(RegimeDetectorTest, WarmupLeavesThresholdsAlone) {
+        regime::Regime_Config config;
+        auto scales = regime::thresholdScales({ { "AAA", step_series(100, 100) } }, config);
+        ASSERT_EQ(scales.at("AAA").size(), 100u);
+        for (size_t i = 0; i + 1 < config.warmup; ++i) {
+            EXPECT_EQ(scales.at("AAA")[i], 1.0);
+        }
+        // A calm level of about 0.002 loosens nothing: the thresholds were tuned for 0.003
+        EXPECT_NEAR(scales.at("AAA").back(), 0.002 / config.reference_volatility, 0.1);
+    }
+
+} // namespace RegimeDetectorFunctions
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "replay.h"
+
+namespace ReplayFunctions {
+
+    TEST(ReplayTest, SmallLatenciesAreExact) {
+        replay::Latency_Histogram histogram;
+        EXPECT_EQ(histogram.percentile(50.0), 0u);
+        EXPECT_EQ(histogram.min(), 0u);
+        EXPECT_EQ(histogram.mean(), 0.0);
+
+        // Values below 32 each get their own bucket
+        for (uint64_t value = 0; value < 32; ++value) {
+            histogram.record(value);
+        }
+        EXPECT_EQ(histogram.count(), 32u);
+        EXPECT_EQ(histogram.min(), 0u);
+        EXPECT_EQ(histogram.max(), 31u);
+        EXPECT_DOUBLE_EQ(histogram.mean(), 15.5);
+        EXPECT_EQ(histogram.percentile(0.0), 0u); // Rank is clamped to the first value
+        EXPECT_EQ(histogram.percentile(50.0), 15u);
+        EXPECT_EQ(histogram.percentile(100.0), 31u);
+    }
+
+    TEST(ReplayTest, BucketsBoundTheRelativeError) {
+        // Each value shares the histogram with a larger one, so its percentile is its bucket's upper bound
+        std::vector<uint64_t> values = { 32, 33, 63, 64, 100, 1000, 123457, 1000000007, (1ull << 40) + 12345,
+                                         UINT64_MAX / 3 };
+        for (uint64_t value : values) {
+            replay::Latency_Histogram histogram;
+            histogram.record(value);
+            histogram.record(UINT64_MAX);
+            uint64_t reported = histogram.percentile(50.0);
+            EXPECT_GE(reported, value) << value;
+            EXPECT_LE(static_cast<double>(reported - value), value / 32.0) << value;
+        }
+
+        // A power of two starts a bucket, which spans 1/32 of it
+        for (int shift = 5; shift < 63; ++shift) {
+            replay::Latency_Histogram histogram;
+            histogram.record(1ull << shift);
+            histogram.record(UINT64_MAX);
+            EXPECT_EQ(histogram.percentile(50.0), ((1ull << shift) | ((1ull << (shift - 5)) - 1))) << shift;
+        }
+    }
+
+    TEST(ReplayTest, PercentilesOfAUniformSpread) {
+        replay::Latency_Histogram low;
+        replay::Latency_Histogram high;
+        for (uint64_t value = 1; value <= 10000; ++value) {
+            (value <= 5000 ? low : high).record(value * 100);
+        }
+        replay::Latency_Histogram all = low;
+        all.merge(high);
+        EXPECT_EQ(all.count(), 10000u);
+        EXPECT_EQ(all.min(), 100u);
+        EXPECT_EQ(all.max(), 1000000u);
+        EXPECT_DOUBLE_EQ(all.mean(), 500050.0);
+
+        for (double p : { 1.0, 25.0, 50.0, 90.0, 99.0, 99.9 }) {
+            double exact = p / 100.0 * 10000 * 100;
+            double reported = static_cast<double>(all.percentile(p));
+            EXPECT_GE(reported, exact) << p;
+            EXPECT_LE(reported, exact * (1.0 + 1.0 / 32)) << p;
+        }
+        EXPECT_EQ(all.percentile(100.0), 1000000u);
+    }
+
+    TEST(ReplayTest, ClientTimesEveryBar) {
+        std::map<std::string, std::vector<double>> prices;
+        for (size_t i = 0; i < 120; ++i) {
+            prices["AAPL"].push_back(100.0 + std::sin(0.3 * i));
+            prices["MSFT"].push_back(200.0 + 2.0 * std::cos(0.2 * i));
+        }
+        prices["MSFT"].resize(100);
+
+        replay::Replay_Config config;
+        config.socket_path = "/tmp/volatility_replay_test" + std::to_string(::getpid());
+        bool served = false;
+        std::thread server([&]() { served = replay::serveReplay(config, prices); });
+
+        replay::Replay_Report report;
+        std::map<std::string, double> portfolio = { { "AAPL", 1000.0 }, { "MSFT", 1000.0 } };
+        bool consumed = replay::runReplayClient(config.socket_path, "neutral", portfolio, report);
+        server.join();
+
+        ASSERT_TRUE(served);
+        ASSERT_TRUE(consumed);
+        EXPECT_EQ(report.bars, 220u);
+        EXPECT_EQ(report.hours, 120u);
+        EXPECT_EQ(report.latency.count(), report.bars);
+        EXPECT_EQ(report.delivery.count(), report.bars);
+        EXPECT_EQ(report.final_portfolio.size(), 2u);
+    }
+
+} // namespace ReplayFunctions
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "portfolio_manager.h"
+#include "riskMetrics.h"
+#include "stock_manager.h"
+#include "volatilityParse.h"
+
+namespace RiskMetricsFunctions {
+
+    std::vector<double> sample_values(size_t bars) {
+        std::vector<double> values;
+        double value = 20000.0;
+        for (size_t i = 0; i < bars; ++i) {
+            value *= 1.0 + 0.004 * std::sin(0.7 * i) + 0.003 * std::cos(2.1 * i) - 0.0004;
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    TEST(RiskMetricsTest, MatchesOfflineComputation) {
+        std::vector<double> values = sample_values(500);
+        metrics::Metrics_Config config;
+        metrics::Metrics_Engine engine(config);
+        for (double value : values) {
+            engine.update(value, 100.0);
+        }
+        metrics::Metrics_Summary s = engine.summary();
+
+        std::vector<double> returns;
+        double peak = values[0];
+        double max_drawdown = 0.0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            returns.push_back(values[i] / values[i - 1] - 1.0);
+            peak = std::max(peak, values[i]);
+            max_drawdown = std::max(max_drawdown, 1.0 - values[i] / peak);
+        }
+        double mean = 0.0;
+        for (double r : returns) {
+            mean += r;
+        }
+        mean /= returns.size();
+        double square = 0.0;
+        double downside = 0.0;
+        for (double r : returns) {
+            square += (r - mean) * (r - mean);
+            downside += r < 0 ? r * r : 0.0;
+        }
+        double deviation = std::sqrt(square / (returns.size() - 1));
+        double annualize = std::sqrt(config.periods_per_year);
+
+        std::vector<double> sorted = returns;
+        std::sort(sorted.begin(), sorted.end());
+        size_t k = static_cast<size_t>(std::ceil((1.0 - config.var_confidence) * sorted.size()));
+        double tail_sum = 0.0;
+        for (size_t i = 0; i < k; ++i) {
+            tail_sum += sorted[i];
+        }
+
+        EXPECT_EQ(s.bars, values.size());
+        EXPECT_NEAR(s.max_drawdown, max_drawdown, 1e-12);
+        EXPECT_NEAR(s.mean_return, mean, 1e-12);
+        EXPECT_NEAR(s.realized_volatility, deviation * annualize, 1e-9);
+        EXPECT_NEAR(s.sharpe, mean / deviation * annualize, 1e-6);
+        EXPECT_NEAR(s.sortino, mean / std::sqrt(downside / returns.size()) * annualize, 1e-6);
+        EXPECT_DOUBLE_EQ(s.value_at_risk, -sorted[k - 1]);
+        EXPECT_NEAR(s.expected_shortfall, -tail_sum / k, 1e-12);
+    }
+
+    TEST(RiskMetricsTest, TurnoverAndDrawdownOnSimpleSeries) {
+        metrics::Metrics_Engine engine;
+        engine.update(100.0, 0.0);
+        engine.update(120.0, 20.0);
+        engine.update(90.0, 0.0);
+        engine.update(110.0, 40.0);
+        metrics::Metrics_Summary s = engine.summary();
+
+        EXPECT_DOUBLE_EQ(s.peak_value, 120.0);
+        EXPECT_DOUBLE_EQ(s.max_drawdown, 0.25);
+        EXPECT_NEAR(s.current_drawdown, 1.0 - 110.0 / 120.0, 1e-12);
+        EXPECT_NEAR(s.total_return, 0.1, 1e-12);
+        EXPECT_DOUBLE_EQ(s.traded, 60.0);
+        EXPECT_NEAR(s.turnover, 60.0 / (2.0 * 105.0), 1e-12);
+    }
+
+    TEST(RiskMetricsTest, EmptyAndSingleBar) {
+        metrics::Metrics_Engine engine;
+        EXPECT_EQ(engine.summary().bars, 0u);
+        engine.update(50.0);
+        metrics::Metrics_Summary s = engine.summary();
+        EXPECT_EQ(s.bars, 1u);
+        EXPECT_EQ(s.sharpe, 0.0);
+        EXPECT_EQ(s.value_at_risk, 0.0);
+    }
+
+    TEST(RiskMetricsTest, PortfolioManagerReportsTheAccountsReturn) {
+        // A calm ticker drifting down and a volatile one losing most of its value, so neutral keeps selling the
+        // volatile one and buying the calm one
+        std::map<std::string, std::vector<double>> prices;
+        double calm = 100.0;
+        double wild = 100.0;
+        for (size_t i = 0; i < 400; ++i) {
+            calm *= 1.0 - 0.001 + 0.0005 * std::sin(0.9 * i);
+            wild *= 1.0 - 0.003 + 0.02 * std::sin(1.7 * i);
+            prices["CALM"].push_back(calm);
+            prices["WILD"].push_back(wild);
+        }
+        auto true_vol = volParsing::true_volatility(prices, volParsing::tickerToVolHourly(prices));
+        auto changes = calculate_percentage_changes(prices);
+
+        double capital = 10000.0;
+        std::map<std::string, double> portfolio = { { "CALM", capital / 2 }, { "WILD", capital / 2 } };
+        Stock_Manager_Result stock_result = stock_manager(true_vol, portfolio, "neutral");
+        Portfolio_Manager_Result result = portfolio_manager(stock_result.buying_stocks, stock_result.reallocation_funds,
+                                                            portfolio, "neutral", true_vol, changes);
+        double final_value = portfolio_value(portfolio) + result.unallocated_funds;
+        const metrics::Metrics_Summary &s = result.metrics;
+
+        // Sales were re-injected every hour; they must not show up as gains
+        double sold = 0.0;
+        for (double funds : stock_result.reallocation_funds) {
+            sold += funds;
+        }
+        ASSERT_GT(sold, 0.1 * capital);
+        EXPECT_EQ(s.bars, stock_result.buying_stocks.size() + 1);
+        EXPECT_NEAR(s.last_value, final_value, 1e-6);
+        EXPECT_NEAR(s.total_return, final_value / capital - 1.0, 1e-9);
+        EXPECT_LT(s.total_return, -0.1);
+        EXPECT_GE(s.max_drawdown, -s.total_return - 1e-9);
+        EXPECT_LT(s.sharpe, 0.0);
+    }
+
+} // namespace RiskMetricsFunctions
@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "seriesCodec.h"
+#include "tradingCalendar.h"
+
+namespace SeriesCodecFunctions {
+
+    std::vector<double> random_walk(size_t count, unsigned seed) {
+        std::mt19937_64 generator(seed);
+        std::normal_distribution<double> step(0.0, 0.004);
+        std::vector<double> prices;
+        double price = 150.0;
+        for (size_t i = 0; i < count; ++i) {
+            price *= 1.0 + step(generator);
+            // Yahoo Finance closes are single-precision values widened to double
+            prices.push_back(static_cast<double>(static_cast<float>(price)));
+        }
+        return prices;
+    }
+
+    bool same_bits(const std::vector<double> &a, const std::vector<double> &b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+    }
+
+    TEST(SeriesCodecTest, ValuesRoundTripExactly) {
+        std::vector<double> special = { 0.0,
+                                        -0.0,
+                                        1.0,
+                                        1.0,
+                                        std::numeric_limits<double>::quiet_NaN(),
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::denorm_min(),
+                                        std::numeric_limits<double>::max(),
+                                        -123.456 };
+        for (size_t count : { size_t(0), size_t(1), size_t(2), size_t(1023), size_t(1024), size_t(5000) }) {
+            std::vector<double> values = random_walk(count, 7);
+            for (size_t i = 0; i < values.size(); i += 97) {
+                values[i] = special[i % special.size()];
+            }
+            EXPECT_TRUE(same_bits(codec::decodeValues(codec::encodeValues(values)), values)) << count;
+        }
+        EXPECT_TRUE(same_bits(codec::decodeValues(codec::encodeValues(special)), special));
+    }
+
+    TEST(SeriesCodecTest, PricesCompressWell) {
+        std::vector<double> prices = random_walk(20000, 11);
+        std::vector<uint8_t> column = codec::encodeValues(prices);
+        EXPECT_LT(column.size(), prices.size() * sizeof(double) / 2);
+
+        // A flat series costs about one bit per value
+        std::vector<double> flat(20000, 42.5);
+        EXPECT_LT(codec::encodeValues(flat).size(), flat.size() / 8 + 1024);
+    }
+
+    TEST(SeriesCodecTest, SessionTimestampsRoundTripInAFewBits) {
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities("2020-01-01", "2024-12-31");
+        std::vector<int64_t> times;
+        for (size_t hour = 0; hour < sessions.hours(); ++hour) {
+            times.push_back(sessions.barStart(hour));
+        }
+        std::vector<uint8_t> column = codec::encodeTimes(times);
+        EXPECT_EQ(codec::decodeTimes(column), times);
+        // Six of every seven steps repeat the hour and cost one bit; the rest are overnight, weekend and holiday gaps
+        EXPECT_LT(column.size(), times.size() * 2);
+
+        std::vector<int64_t> extremes = { 0, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+                                          -1, 1, 1, 3600, 7200, 1000000007 };
+        EXPECT_EQ(codec::decodeTimes(codec::encodeTimes(extremes)), extremes);
+    }
+
+    TEST(SeriesCodecTest, BlockDecoderFeedsAKernel) {
+        std::vector<double> values = random_walk(10000, 3);
+        std::vector<uint8_t> column = codec::encodeValues(values);
+
+        codec::Block_Decoder decoder(column.data(), column.size());
+        ASSERT_TRUE(decoder.valid());
+        EXPECT_EQ(decoder.size(), values.size());
+        alignas(64) double block[codec::kBlockValues];
+        double sum = 0.0;
+        size_t decoded = 0;
+        while (size_t count = decoder.next(block)) {
+            for (size_t i = 0; i < count; ++i) {
+                sum += block[i];
+            }
+            decoded += count;
+        }
+        double expected = 0.0;
+        for (double value : values) {
+            expected += value;
+        }
+        EXPECT_EQ(decoded, values.size());
+        EXPECT_EQ(sum, expected);
+
+        // A value column cannot be read as times, and a truncated column is rejected
+        codec::Block_Decoder wrong_kind(column.data(), column.size());
+        int64_t times[codec::kBlockValues];
+        EXPECT_EQ(wrong_kind.next(times), 0u);
+        EXPECT_FALSE(wrong_kind.valid());
+        column.resize(column.size() / 2);
+        EXPECT_TRUE(codec::decodeValues(column).empty());
+    }
+
+    TEST(SeriesCodecTest, CorruptColumnsAreRejectedSafely) {
+        std::vector<double> values = random_walk(3000, 5);
+        std::vector<uint8_t> column = codec::encodeValues(values);
+        std::mt19937 generator(9);
+        for (int trial = 0; trial < 200; ++trial) {
+            std::vector<uint8_t> corrupt = column;
+            for (int flip = 0; flip < 4; ++flip) {
+                corrupt[generator() % corrupt.size()] ^= static_cast<uint8_t>(1u << (generator() % 8));
+            }
+            // Either fails or returns some values; never reads outside the column
+            std::vector<double> decoded = codec::decodeValues(corrupt);
+            EXPECT_TRUE(decoded.empty() || decoded.size() <= 3 * codec::kBlockValues);
+        }
+
+        // Block sizes that disagree with the column count: the header is kind, block count, value count, and each
+        // block starts with its value count
+        auto with_count = [](std::vector<uint8_t> patched, uint64_t count) {
+            std::memcpy(patched.data() + 8, &count, sizeof(count));
+            return patched;
+        };
+        auto with_first_block = [](std::vector<uint8_t> patched, uint32_t values) {
+            std::memcpy(patched.data() + 16, &values, sizeof(values));
+            return patched;
+        };
+        std::vector<uint8_t> one_block = codec::encodeValues(random_walk(codec::kBlockValues, 6));
+        EXPECT_TRUE(codec::decodeValues(with_count(one_block, 1)).empty()); // One full block into a 1-value column
+        EXPECT_TRUE(codec::decodeValues(with_count(column, 2999)).empty());
+        EXPECT_TRUE(codec::decodeValues(with_count(column, 3001)).empty());
+        EXPECT_TRUE(codec::decodeValues(with_count(column, 5000)).empty()); // More values than 3 blocks hold
+        std::vector<uint8_t> short_first = with_first_block(column, 1000);
+        codec::Block_Decoder decoder(short_first.data(), short_first.size());
+        double out[codec::kBlockValues];
+        EXPECT_EQ(decoder.next(out), 0u);
+        EXPECT_FALSE(decoder.valid());
+    }
+
+    TEST(SeriesCodecTest, SeriesFileRoundTrip) {
+        std::map<std::string, std::vector<double>> series = { { "AAPL", random_walk(3000, 1) },
+                                                              { "MSFT", random_walk(2500, 2) },
+                                                              { "EMPTY", {} } };
+        std::map<std::string, std::vector<int64_t>> times;
+        for (size_t i = 0; i < 3000; ++i) {
+            times["AAPL"].push_back(1704067200 + static_cast<int64_t>(i) * 3600);
+        }
+
+        std::string filename = ::testing::TempDir() + "test_series_codec.volc";
+        ASSERT_TRUE(codec::saveSeries(filename, series, times));
+        std::map<std::string, std::vector<double>> loaded;
+        std::map<std::string, std::vector<int64_t>> loaded_times;
+        ASSERT_TRUE(codec::loadSeries(filename, loaded, &loaded_times));
+        ASSERT_EQ(loaded.size(), series.size());
+        for (const auto &[ticker, values] : series) {
+            EXPECT_TRUE(same_bits(loaded[ticker], values)) << ticker;
+        }
+        EXPECT_EQ(loaded_times, times);
+        std::remove(filename.c_str());
+    }
+
+    TEST(SeriesCodecTest, ColumnLongerThanTheFileIsRejected) {
+        // A valid header for one ticker "A" whose column claims 2^39 bytes
+        std::string filename = ::testing::TempDir() + "test_series_codec_length.volc";
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        uint32_t tickers = 1;
+        uint16_t name_size = 1;
+        uint8_t has_times = 0;
+        uint64_t column_size = 1ULL << 39;
+        file.write("VOLCODC1", 8);
+        file.write(reinterpret_cast<const char *>(&tickers), sizeof(tickers));
+        file.write(reinterpret_cast<const char *>(&name_size), sizeof(name_size));
+        file.write("A", 1);
+        file.write(reinterpret_cast<const char *>(&has_times), sizeof(has_times));
+        file.write(reinterpret_cast<const char *>(&column_size), sizeof(column_size));
+        file.write("\0\0\0\0\0\0\0\0", 8);
+        file.close();
+
+        std::map<std::string, std::vector<double>> loaded;
+        EXPECT_FALSE(codec::loadSeries(filename, loaded));
+        EXPECT_TRUE(loaded.empty());
+        std::remove(filename.c_str());
+    }
+
+} // namespace SeriesCodecFunctions
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <malloc.h>
+#include <map>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "backtestService.h"
+#include "sharedMarketData.h"
+
+namespace SharedMarketDataFunctions {
+
+    std::map<std::string, std::vector<double>> sample_prices(size_t hours) {
+        std::map<std::string, std::vector<double>> prices;
+        std::vector<std::string> tickers = { "NVDA", "AAPL", "MSFT" };
+        for (size_t t = 0; t < tickers.size(); ++t) {
+            double price = 100.0 + 40.0 * t;
+            for (size_t i = 0; i < hours; ++i) {
+                price *= 1.0 + (0.003 + 0.002 * t) * std::sin(0.4 * i + t) + 0.002 * std::cos(1.3 * i);
+                prices[tickers[t]].push_back(price);
+            }
+        }
+        return prices;
+    }
+
+    std::string segment_name(const char *name) { return "/" + std::string(name) + std::to_string(::getpid()); }
+
+    TEST(SharedMarketDataTest, PublishedColumnsRoundTrip) {
+        auto data = service::buildMarketData(sample_prices(200));
+        std::string segment = segment_name("volatility_shm_test");
+        ASSERT_TRUE(sharedData::publish(segment, data->prices, data->true_volatility, data->percentage_changes, 7));
+
+        sharedData::MarketView view;
+        ASSERT_TRUE(view.attach(segment));
+        EXPECT_EQ(view.generation(), 7u);
+        ASSERT_EQ(view.tickerCount(), 3u);
+        EXPECT_EQ(view.pricesMap(), data->prices);
+        EXPECT_EQ(view.volatilityMap(), data->true_volatility);
+        EXPECT_EQ(view.percentageChangesMap(), data->percentage_changes);
+
+        size_t msft = view.find("MSFT");
+        ASSERT_LT(msft, view.tickerCount());
+        EXPECT_EQ(view.ticker(msft), "MSFT");
+        EXPECT_EQ(view.find("ZZZ"), view.tickerCount());
+        // Columns are 64-byte aligned views into the segment
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(view.volatility(msft).data) % 64, 0u);
+
+        // Out-of-range indices and a detached view read as empty
+        EXPECT_TRUE(view.ticker(view.tickerCount()).empty());
+        EXPECT_TRUE(view.prices(view.tickerCount() + 5).empty());
+        sharedData::MarketView detached;
+        EXPECT_EQ(detached.generation(), 0u);
+        EXPECT_EQ(detached.tickerCount(), 0u);
+        EXPECT_TRUE(detached.volatility(0).empty());
+
+        ASSERT_TRUE(sharedData::unpublish(segment));
+        // The mapping outlives the name
+        EXPECT_EQ(view.pricesMap(), data->prices);
+        sharedData::MarketView late;
+        EXPECT_FALSE(late.attach(segment));
+    }
+
+    TEST(SharedMarketDataTest, WorkerReadsColumnsInPlace) {
+        auto data = service::buildMarketData(sample_prices(2000));
+        std::string segment = segment_name("volatility_shm_views");
+        ASSERT_TRUE(sharedData::publish(segment, data->prices, data->true_volatility, data->percentage_changes));
+        sharedData::MarketView view;
+        ASSERT_TRUE(view.attach(segment));
+
+        // A copy would take 9 columns of about 2000 doubles on the heap; the views take less than one
+        size_t before = ::mallinfo2().uordblks;
+        auto shared = service::buildMarketData(view);
+        size_t allocated = ::mallinfo2().uordblks - before;
+        EXPECT_LT(allocated, 2000 * sizeof(double));
+
+        EXPECT_TRUE(shared->prices.empty());
+        EXPECT_TRUE(shared->true_volatility.empty());
+        EXPECT_EQ(shared->hours, data->hours);
+        ASSERT_EQ(shared->columns.size(), view.tickerCount());
+        for (size_t i = 0; i < view.tickerCount(); ++i) {
+            const service::Ticker_Columns &columns = shared->columns.at(view.ticker(i));
+            EXPECT_EQ(columns.prices.data, view.prices(i).data);
+            EXPECT_EQ(columns.volatility.data, view.volatility(i).data);
+            EXPECT_EQ(columns.percentage_changes.data, view.percentageChanges(i).data);
+        }
+
+        service::Backtest_Request request;
+        service::Backtest_Response expected = service::runBacktest(*data, request);
+        service::Backtest_Response response = service::runBacktest(*shared, request);
+        EXPECT_EQ(response.final_portfolio, expected.final_portfolio);
+        sharedData::unpublish(segment);
+    }
+
+    TEST(SharedMarketDataTest, WorkerProcessRunsTheSameBacktest) {
+        auto data = service::buildMarketData(sample_prices(300));
+        std::string segment = segment_name("volatility_shm_worker");
+        ASSERT_TRUE(sharedData::publish(segment, data->prices, data->true_volatility, data->percentage_changes));
+
+        service::Backtest_Request request;
+        request.strategy = "conservative";
+        request.capital = 12345.0;
+        service::Backtest_Response expected = service::runBacktest(*data, request);
+        ASSERT_EQ(expected.status, service::Status::Ok);
+
+        // The worker maps the segment in another process and must get the loader's result bit for bit
+        pid_t worker = ::fork();
+        ASSERT_GE(worker, 0);
+        if (worker == 0) {
+            sharedData::MarketView view;
+            if (!view.attach(segment)) {
+                ::_exit(2);
+            }
+            auto shared = service::buildMarketData(view);
+            service::Backtest_Response response = service::runBacktest(*shared, request);
+            bool same = response.status == service::Status::Ok && shared->hours == data->hours &&
+                        response.final_portfolio == expected.final_portfolio &&
+                        response.final_value == expected.final_value;
+            ::_exit(same ? 0 : 1);
+        }
+        int status = 0;
+        ASSERT_EQ(::waitpid(worker, &status, 0), worker);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+        sharedData::unpublish(segment);
+    }
+
+} // namespace SharedMarketDataFunctions
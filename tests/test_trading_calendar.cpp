@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+#include <vector>
+#include "tradingCalendar.h"
+
+namespace TradingCalendarFunctions {
+
+    int64_t day(int year, unsigned month, unsigned dom) { return calendar::daysFromCivil(year, month, dom); }
+
+    TEST(TradingCalendarTest, ParsesIso8601AsUtc) {
+        EXPECT_EQ(calendar::parseIso8601("2024-01-01"), 1704067200);
+        EXPECT_EQ(calendar::parseIso8601("2023-12-30"), 1703894400);
+        EXPECT_EQ(calendar::parseIso8601("2024-03-10T19:30"), 1710099000);
+        EXPECT_EQ(calendar::parseIso8601("2024-03-10T15:30:00-04:00"), 1710099000);
+        EXPECT_EQ(calendar::parseIso8601("2024-03-10 19:30:00.250Z"), 1710099000);
+        EXPECT_EQ(calendar::parseIso8601("2024-11-18T09:30:00-0500"), 1731940200);
+        EXPECT_EQ(calendar::parseIso8601("1969-12-31T23:59:59"), -1);
+    }
+
+    TEST(TradingCalendarTest, RejectsMalformedTimestamps) {
+        for (std::string_view text : { "", "2024-02-30", "2023-02-29", "2024-1-01", "2024-01-01T25:00",
+                                       "2024-01-01T10:60", "2024-01-01X", "2024-01-01T10:00:00.", "20240101" }) {
+            EXPECT_EQ(calendar::parseIso8601(text), calendar::kInvalidTime) << text;
+        }
+        EXPECT_NE(calendar::parseIso8601("2024-02-29"), calendar::kInvalidTime);
+    }
+
+    TEST(TradingCalendarTest, BatchParsing) {
+        std::vector<std::string_view> texts = { "2024-01-01", "bad", "2024-03-10T19:30Z" };
+        std::vector<int64_t> out(texts.size());
+        EXPECT_EQ(calendar::parseIso8601Batch(texts, out.data()), 2u);
+        EXPECT_EQ(out[0], 1704067200);
+        EXPECT_EQ(out[1], calendar::kInvalidTime);
+        EXPECT_EQ(out[2], 1710099000);
+    }
+
+    TEST(TradingCalendarTest, CivilDaysRoundTrip) {
+        for (int64_t d = -800000; d <= 800000; d += 37) {
+            int year = 0;
+            unsigned month = 0;
+            unsigned dom = 0;
+            calendar::civilFromDays(d, year, month, dom);
+            ASSERT_EQ(calendar::daysFromCivil(year, month, dom), d);
+        }
+        EXPECT_EQ(calendar::weekday(day(2024, 11, 18)), 1u); // Monday
+        EXPECT_EQ(calendar::weekday(day(1970, 1, 1)), 4u);   // Thursday
+    }
+
+    TEST(TradingCalendarTest, UsEquityHolidays) {
+        std::vector<int64_t> expected = { day(2024, 1, 1),  day(2024, 1, 15), day(2024, 2, 19), day(2024, 3, 29),
+                                          day(2024, 5, 27), day(2024, 6, 19), day(2024, 7, 4),  day(2024, 9, 2),
+                                          day(2024, 11, 28), day(2024, 12, 25) };
+        EXPECT_EQ(calendar::usEquityHolidays(2024), expected);
+
+        // 2022: New Year's Day on a Saturday is not observed; Juneteenth and Christmas fall on Sundays
+        std::vector<int64_t> holidays = calendar::usEquityHolidays(2022);
+        EXPECT_EQ(holidays.front(), day(2022, 1, 17));
+        EXPECT_NE(std::find(holidays.begin(), holidays.end(), day(2022, 6, 20)), holidays.end());
+        EXPECT_EQ(holidays.back(), day(2022, 12, 26));
+    }
+
+    TEST(TradingCalendarTest, SessionHoursAcrossDaylightSaving) {
+        // Friday 2024-03-08 (EST) to Monday 2024-03-11 (EDT)
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities("2024-03-08", "2024-03-11");
+        ASSERT_EQ(sessions.hours(), 14u);
+        EXPECT_TRUE(sessions.isTradingDay(day(2024, 3, 8)));
+        EXPECT_FALSE(sessions.isTradingDay(day(2024, 3, 9)));
+
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-08T14:30Z")), 0u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-08T20:59:59Z")), 6u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-08T21:00Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-08T14:29Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-09T15:00Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-11T13:30Z")), 7u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-11T19:45Z")), 13u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-03-11T20:00Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.barStart(7), calendar::parseIso8601("2024-03-11T09:30-04:00"));
+    }
+
+    TEST(TradingCalendarTest, DaylightSavingFollowsTheRuleOfTheYear) {
+        // 2007 on: second Sunday of March to first Sunday of November
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(2024, 3, 9)));
+        EXPECT_TRUE(calendar::isUsDaylightSaving(day(2024, 3, 10)));
+        EXPECT_TRUE(calendar::isUsDaylightSaving(day(2024, 11, 2)));
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(2024, 11, 3)));
+
+        // 1987 to 2006: first Sunday of April to last Sunday of October
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(2006, 3, 13)));
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(2006, 4, 1)));
+        EXPECT_TRUE(calendar::isUsDaylightSaving(day(2006, 4, 2)));
+        EXPECT_TRUE(calendar::isUsDaylightSaving(day(2006, 10, 28)));
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(2006, 10, 29)));
+
+        // Before 1987: last Sunday of April
+        EXPECT_FALSE(calendar::isUsDaylightSaving(day(1986, 4, 26)));
+        EXPECT_TRUE(calendar::isUsDaylightSaving(day(1986, 4, 27)));
+
+        // Monday 2006-03-13 opens at 09:30 EST, Monday 2006-04-03 at 09:30 EDT
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities("2006-03-13", "2006-04-03");
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2006-03-13T14:30Z")), 0u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2006-03-13T13:30Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.barStart(sessions.hours() - 7), calendar::parseIso8601("2006-04-03T13:30Z"));
+    }
+
+    TEST(TradingCalendarTest, EarlyClosesEndAt1300) {
+        std::vector<int64_t> expected = { day(2024, 7, 3), day(2024, 11, 29), day(2024, 12, 24) };
+        EXPECT_EQ(calendar::usEquityEarlyCloses(2024), expected);
+
+        // 2021: July 3 is a Saturday and the Friday Christmas Eve is the observed Christmas
+        EXPECT_EQ(calendar::usEquityEarlyCloses(2021), std::vector<int64_t>{ day(2021, 11, 26) });
+
+        // Wednesday 2024-11-27 is a full day, Friday 2024-11-29 closes at 13:00 EST (18:00 UTC) after 4 bars
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities("2024-11-27", "2024-12-02");
+        ASSERT_EQ(sessions.hours(), 7u + 4u + 7u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-11-29T17:59Z")), 10u);
+        EXPECT_EQ(sessions.hourIndex(calendar::parseIso8601("2024-11-29T18:00Z")), calendar::kNoSession);
+        EXPECT_EQ(sessions.barStart(11), calendar::parseIso8601("2024-12-02T14:30Z"));
+
+        // No phantom afternoon bars to forward-fill
+        std::vector<int64_t> timestamps = { calendar::parseIso8601("2024-11-29T17:30Z"),
+                                            calendar::parseIso8601("2024-12-02T14:30Z") };
+        std::vector<double> aligned = sessions.align(timestamps, { 10.0, 11.0 });
+        EXPECT_EQ(aligned[10], 10.0);
+        EXPECT_EQ(aligned[11], 11.0);
+    }
+
+    TEST(TradingCalendarTest, AlignsPricesOnSessionHours) {
+        calendar::Session_Calendar sessions = calendar::Session_Calendar::usEquities("2024-11-18", "2024-11-18");
+        ASSERT_EQ(sessions.hours(), 7u);
+        std::vector<int64_t> timestamps = { calendar::parseIso8601("2024-11-18T15:30Z"),
+                                            calendar::parseIso8601("2024-11-18T18:30Z"),
+                                            calendar::parseIso8601("2024-11-18T23:00Z") };
+        std::vector<double> aligned = sessions.align(timestamps, { 10.0, 12.0, 99.0 });
+        EXPECT_TRUE(std::isnan(aligned[0]));
+        EXPECT_EQ(aligned[1], 10.0);
+        EXPECT_EQ(aligned[3], 10.0);
+        EXPECT_EQ(aligned[4], 12.0);
+        EXPECT_EQ(aligned[6], 12.0);
+    }
+
+} // namespace TradingCalendarFunctions